@@ -978,6 +978,41 @@ myDomainEventMemoryFailureCallback(virConnectPtr conn G_GNUC_UNUSED,
 }
 
 
+static int
+myDomainEventPressureCallback(virConnectPtr conn G_GNUC_UNUSED,
+                              virDomainPtr dom,
+                              int resource,
+                              unsigned long long stall,
+                              unsigned long long window,
+                              void *opaque G_GNUC_UNUSED)
+{
+    /* Casts to uint64_t to work around mingw not knowing %lld */
+    printf("%s EVENT: Domain %s(%d) pressure: resource '%d', "
+           "stall '%" PRIu64 "', window '%" PRIu64 "'\n",
+           __func__, virDomainGetName(dom), virDomainGetID(dom),
+           resource, (uint64_t)stall, (uint64_t)window);
+    return 0;
+}
+
+
+static int
+myDomainEventResctrlTuneCallback(virConnectPtr conn G_GNUC_UNUSED,
+                                 virDomainPtr dom,
+                                 int resource,
+                                 const char *vcpus,
+                                 unsigned int id,
+                                 unsigned long long value,
+                                 void *opaque G_GNUC_UNUSED)
+{
+    /* Casts to uint64_t to work around mingw not knowing %lld */
+    printf("%s EVENT: Domain %s(%d) resctrl tune: resource '%d', "
+           "vcpus '%s', id '%u', value '%" PRIu64 "'\n",
+           __func__, virDomainGetName(dom), virDomainGetID(dom),
+           resource, vcpus, id, (uint64_t)value);
+    return 0;
+}
+
+
 static int
 myDomainEventMigrationIterationCallback(virConnectPtr conn G_GNUC_UNUSED,
                                         virDomainPtr dom,
@@ -1109,6 +1144,8 @@ struct domainEventData domainEvents[] = {
     DOMAIN_EVENT(VIR_DOMAIN_EVENT_ID_METADATA_CHANGE, myDomainEventMetadataChangeCallback),
     DOMAIN_EVENT(VIR_DOMAIN_EVENT_ID_BLOCK_THRESHOLD, myDomainEventBlockThresholdCallback),
     DOMAIN_EVENT(VIR_DOMAIN_EVENT_ID_MEMORY_FAILURE, myDomainEventMemoryFailureCallback),
+    DOMAIN_EVENT(VIR_DOMAIN_EVENT_ID_PRESSURE, myDomainEventPressureCallback),
+    DOMAIN_EVENT(VIR_DOMAIN_EVENT_ID_RESCTRL_TUNE, myDomainEventResctrlTuneCallback),
 };
 
 struct storagePoolEventData {
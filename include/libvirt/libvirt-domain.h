@@ -1078,6 +1078,55 @@ typedef enum {
  */
 # define VIR_MIGRATE_PARAM_TLS_DESTINATION          "tls.destination"
 
+/**
+ * VIR_MIGRATE_PARAM_DISKS_PARALLEL:
+ *
+ * virDomainMigrate* params field: the maximum number of disks performing
+ * their initial copy at the same time during migration of non-shared
+ * storage. Disks are copied starting with the smallest one. A disk which
+ * has finished its initial copy only keeps mirroring guest writes and no
+ * longer counts towards the limit. Zero or not set means all disks are
+ * copied at once. As VIR_TYPED_PARAM_INT.
+ */
+# define VIR_MIGRATE_PARAM_DISKS_PARALLEL           "disks.parallel"
+
+/**
+ * VIR_MIGRATE_PARAM_BANDWIDTH_DISKS:
+ *
+ * virDomainMigrate* params field: the maximum bandwidth (in MiB/s) shared by
+ * all disks during migration of non-shared storage. It is split evenly among
+ * the disks which have not finished their initial copy yet. If set, it is
+ * used for disks instead of VIR_MIGRATE_PARAM_BANDWIDTH.
+ * As VIR_TYPED_PARAM_ULLONG.
+ */
+# define VIR_MIGRATE_PARAM_BANDWIDTH_DISKS          "bandwidth.disks"
+
+/**
+ * VIR_MIGRATE_PARAM_CONVERGE_DEADLINE:
+ *
+ * virDomainMigrate* params field: the number of seconds since the start of
+ * the migration by which it is expected to converge. Once the hypervisor
+ * has sent all memory once and the migration would not converge within the
+ * deadline at the current transfer and dirtying rates, the downtime limit is
+ * raised within VIR_MIGRATE_PARAM_CONVERGE_DOWNTIME. When the deadline
+ * passes and the migration was started with VIR_MIGRATE_POSTCOPY, it is
+ * switched to post-copy unless the downtime needed to finish fits within
+ * VIR_MIGRATE_PARAM_CONVERGE_DOWNTIME. As VIR_TYPED_PARAM_ULLONG.
+ */
+# define VIR_MIGRATE_PARAM_CONVERGE_DEADLINE        "converge.deadline"
+
+/**
+ * VIR_MIGRATE_PARAM_CONVERGE_DOWNTIME:
+ *
+ * virDomainMigrate* params field: the maximum downtime (in milliseconds) the
+ * hypervisor may be allowed when migration does not converge on its own or
+ * would miss VIR_MIGRATE_PARAM_CONVERGE_DEADLINE. The downtime limit is only
+ * raised as far as needed to transfer the remaining memory at the current
+ * rate. If not set, the downtime limit is never changed.
+ * As VIR_TYPED_PARAM_ULLONG.
+ */
+# define VIR_MIGRATE_PARAM_CONVERGE_DOWNTIME        "converge.downtime"
+
 /* Domain migration. */
 virDomainPtr virDomainMigrate (virDomainPtr domain, virConnectPtr dconn,
                                unsigned long flags, const char *dname,
@@ -2185,6 +2234,9 @@ typedef enum {
     VIR_DOMAIN_STATS_PERF = (1 << 6), /* return domain perf event info */
     VIR_DOMAIN_STATS_IOTHREAD = (1 << 7), /* return iothread poll info */
     VIR_DOMAIN_STATS_MEMORY = (1 << 8), /* return domain memory info */
+    VIR_DOMAIN_STATS_CGROUP = (1 << 9), /* return domain cgroup resource usage */
+    VIR_DOMAIN_STATS_PERF_VCPU = (1 << 10), /* return per vcpu perf event info */
+    VIR_DOMAIN_STATS_KVM = (1 << 11), /* return per vcpu KVM statistics */
 } virDomainStatsTypes;
 
 typedef enum {
@@ -3258,6 +3310,42 @@ typedef enum {
 } virDomainMemoryFailureFlags;
 
 
+/**
+ * virDomainPressureResource:
+ *
+ * Resource a pressure stall event was reported for.
+ */
+typedef enum {
+    /* tasks of the domain were stalled waiting for memory */
+    VIR_DOMAIN_PRESSURE_RESOURCE_MEMORY = 0,
+
+    /* tasks of the domain were stalled waiting for block I/O */
+    VIR_DOMAIN_PRESSURE_RESOURCE_IO = 1,
+
+# ifdef VIR_ENUM_SENTINELS
+    VIR_DOMAIN_PRESSURE_RESOURCE_LAST
+# endif
+} virDomainPressureResource;
+
+
+/**
+ * virDomainResctrlResource:
+ *
+ * Resource an allocation was resized for by resource control auto-tuning.
+ */
+typedef enum {
+    /* last level cache, the value is the size in bytes */
+    VIR_DOMAIN_RESCTRL_RESOURCE_CACHE = 0,
+
+    /* memory bandwidth, the value is the limit in percent */
+    VIR_DOMAIN_RESCTRL_RESOURCE_MEMORY_BANDWIDTH = 1,
+
+# ifdef VIR_ENUM_SENTINELS
+    VIR_DOMAIN_RESCTRL_RESOURCE_LAST
+# endif
+} virDomainResctrlResource;
+
+
 /**
  * virConnectDomainEventCallback:
  * @conn: virConnect connection
@@ -3711,6 +3799,122 @@ typedef enum {
  */
 # define VIR_DOMAIN_JOB_DISK_TEMP_TOTAL "disk_temp_total"
 
+/**
+ * VIR_DOMAIN_JOB_START_TIME_INIT:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * initializing the domain object, including looking up QEMU capabilities,
+ * as VIR_TYPED_PARAM_ULLONG. Present only in statistics of a completed
+ * job which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_INIT "start_time_init"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_PREPARE_DOMAIN:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * preparing the domain definition, as VIR_TYPED_PARAM_ULLONG. Present
+ * only in statistics of a completed job which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_PREPARE_DOMAIN "start_time_prepare_domain"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_PREPARE_HOST:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * preparing host resources, e.g. network interfaces, as
+ * VIR_TYPED_PARAM_ULLONG. Present only in statistics of a completed job
+ * which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_PREPARE_HOST "start_time_prepare_host"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_COMMAND_LINE:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * starting external helpers and building the QEMU command line, as
+ * VIR_TYPED_PARAM_ULLONG. Present only in statistics of a completed job
+ * which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_COMMAND_LINE "start_time_command_line"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_EXEC:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * spawning the QEMU process, as VIR_TYPED_PARAM_ULLONG. Present only in
+ * statistics of a completed job which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_EXEC "start_time_exec"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_NAMESPACE:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * building the mount namespace of the domain, as VIR_TYPED_PARAM_ULLONG.
+ * Present only in statistics of a completed job which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_NAMESPACE "start_time_namespace"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_CGROUP:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * setting up cgroups and other resource controls, as
+ * VIR_TYPED_PARAM_ULLONG. Present only in statistics of a completed job
+ * which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_CGROUP "start_time_cgroup"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_LABEL:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * setting security labels on resources used by the domain, as
+ * VIR_TYPED_PARAM_ULLONG. Present only in statistics of a completed job
+ * which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_LABEL "start_time_label"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_MONITOR:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * connecting to the QEMU monitor and guest agent, as
+ * VIR_TYPED_PARAM_ULLONG. Present only in statistics of a completed job
+ * which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_MONITOR "start_time_monitor"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_SETUP:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * configuring the running QEMU process, e.g. vCPUs, as
+ * VIR_TYPED_PARAM_ULLONG. Present only in statistics of a completed job
+ * which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_SETUP "start_time_setup"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_REFRESH:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * refreshing the domain state from QEMU or, when restoring a domain, loading
+ * its saved state, as VIR_TYPED_PARAM_ULLONG. Present only in statistics of
+ * a completed job which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_REFRESH "start_time_refresh"
+
+/**
+ * VIR_DOMAIN_JOB_START_TIME_FINISH:
+ *
+ * virDomainGetJobStats field: time (in milliseconds) a domain start spent
+ * resuming vCPUs and finishing the start, as VIR_TYPED_PARAM_ULLONG.
+ * Present only in statistics of a completed job which started a domain.
+ */
+# define VIR_DOMAIN_JOB_START_TIME_FINISH "start_time_finish"
+
 /**
  * virConnectDomainEventGenericCallback:
  * @conn: the connection pointer
@@ -4651,6 +4855,56 @@ typedef void (*virConnectDomainEventMemoryFailureCallback)(virConnectPtr conn,
                                                            unsigned int flags,
                                                            void *opaque);
 
+/**
+ * virConnectDomainEventPressureCallback:
+ * @conn: connection object
+ * @dom: domain on which the event occurred
+ * @resource: the resource the domain was stalled on
+ *            (virDomainPressureResource)
+ * @stall: configured stall threshold in microseconds
+ * @window: configured time window in microseconds
+ * @opaque: application specified data
+ *
+ * The callback occurs when some tasks of the domain were stalled waiting
+ * for @resource for at least @stall microseconds within a @window long
+ * period of time. The host kernel reports this at most once per @window.
+ *
+ * The callback signature to use when registering for an event of type
+ * VIR_DOMAIN_EVENT_ID_PRESSURE with virConnectDomainEventRegisterAny()
+ */
+typedef void (*virConnectDomainEventPressureCallback)(virConnectPtr conn,
+                                                      virDomainPtr dom,
+                                                      int resource,
+                                                      unsigned long long stall,
+                                                      unsigned long long window,
+                                                      void *opaque);
+
+/**
+ * virConnectDomainEventResctrlTuneCallback:
+ * @conn: connection object
+ * @dom: domain on which the event occurred
+ * @resource: the resource that was resized (virDomainResctrlResource)
+ * @vcpus: the vCPUs of the cachetune or memorytune element, e.g. "0-3"
+ * @id: id of the cache or the memory bandwidth controller (node)
+ * @value: the new size of the allocation, bytes for caches and percent
+ *         for memory bandwidth
+ * @opaque: application specified data
+ *
+ * The callback occurs when resource control auto-tuning resizes a cache
+ * or memory bandwidth allocation of the domain. The live XML of the
+ * domain reflects the new size.
+ *
+ * The callback signature to use when registering for an event of type
+ * VIR_DOMAIN_EVENT_ID_RESCTRL_TUNE with virConnectDomainEventRegisterAny()
+ */
+typedef void (*virConnectDomainEventResctrlTuneCallback)(virConnectPtr conn,
+                                                         virDomainPtr dom,
+                                                         int resource,
+                                                         const char *vcpus,
+                                                         unsigned int id,
+                                                         unsigned long long value,
+                                                         void *opaque);
+
 
 /**
  * VIR_DOMAIN_EVENT_CALLBACK:
@@ -4695,6 +4949,8 @@ typedef enum {
     VIR_DOMAIN_EVENT_ID_METADATA_CHANGE = 23, /* virConnectDomainEventMetadataChangeCallback */
     VIR_DOMAIN_EVENT_ID_BLOCK_THRESHOLD = 24, /* virConnectDomainEventBlockThresholdCallback */
     VIR_DOMAIN_EVENT_ID_MEMORY_FAILURE = 25,  /* virConnectDomainEventMemoryFailureCallback */
+    VIR_DOMAIN_EVENT_ID_PRESSURE = 26,       /* virConnectDomainEventPressureCallback */
+    VIR_DOMAIN_EVENT_ID_RESCTRL_TUNE = 27,   /* virConnectDomainEventResctrlTuneCallback */
 
 # ifdef VIR_ENUM_SENTINELS
     VIR_DOMAIN_EVENT_ID_LAST
@@ -5119,4 +5375,35 @@ int virDomainAuthorizedSSHKeysSet(virDomainPtr domain,
                                   unsigned int nkeys,
                                   unsigned int flags);
 
+/**
+ * VIR_DOMAIN_NUMA_MOVE_BYTES:
+ *
+ * Macro for typed parameter name that holds the amount of domain memory
+ * in bytes moved onto the new nodeset, as VIR_TYPED_PARAM_ULLONG.
+ */
+# define VIR_DOMAIN_NUMA_MOVE_BYTES "bytes"
+
+/**
+ * VIR_DOMAIN_NUMA_MOVE_REMAINING:
+ *
+ * Macro for typed parameter name that holds the amount of domain memory
+ * in bytes still residing outside of the new nodeset once the move is
+ * done, as VIR_TYPED_PARAM_ULLONG.
+ */
+# define VIR_DOMAIN_NUMA_MOVE_REMAINING "remaining"
+
+/**
+ * VIR_DOMAIN_NUMA_MOVE_TIME:
+ *
+ * Macro for typed parameter name that holds how long the move took in
+ * milliseconds, as VIR_TYPED_PARAM_ULLONG.
+ */
+# define VIR_DOMAIN_NUMA_MOVE_TIME "time"
+
+int virDomainMoveNumaNodes(virDomainPtr domain,
+                           const char *nodeset,
+                           virTypedParameterPtr *params,
+                           int *nparams,
+                           unsigned int flags);
+
 #endif /* LIBVIRT_DOMAIN_H */
@@ -822,5 +822,10 @@ int virNodeAllocPages(virConnectPtr conn,
                       unsigned int cellCount,
                       unsigned int flags);
 
+int virNodeGetAllStats(virConnectPtr conn,
+                       virTypedParameterPtr *params,
+                       int *nparams,
+                       unsigned int flags);
+
 
 #endif /* LIBVIRT_HOST_H */
@@ -1416,6 +1416,203 @@ virCapabilitiesHostNUMAGetCpus(virCapsHostNUMAPtr caps,
 }
 
 
+/* Distances as defined by ACPI SLIT, used when sysfs reports none */
+#define VIR_CAPS_NUMA_LOCAL_DISTANCE 10
+#define VIR_CAPS_NUMA_REMOTE_DISTANCE 20
+
+static unsigned int
+virCapabilitiesHostNUMACellDistance(virCapsHostNUMACellPtr from,
+                                    virCapsHostNUMACellPtr to)
+{
+    size_t i;
+
+    for (i = 0; i < from->nsiblings; i++) {
+        if (from->siblings[i].node == to->num)
+            return from->siblings[i].distance;
+    }
+
+    if (from == to)
+        return VIR_CAPS_NUMA_LOCAL_DISTANCE;
+    return VIR_CAPS_NUMA_REMOTE_DISTANCE;
+}
+
+
+/* Fill @order with indexes of all cells sorted by their distance from
+ * cell @seed, ties broken by the index. @seed itself comes first. */
+static void
+virCapabilitiesHostNUMAPlacementOrder(virCapsHostNUMAPtr caps,
+                                      size_t seed,
+                                      size_t *order)
+{
+    virCapsHostNUMACellPtr seedCell = g_ptr_array_index(caps->cells, seed);
+    size_t ncells = caps->cells->len;
+    size_t n = 1;
+    size_t i, j;
+
+    order[0] = seed;
+
+    for (i = 0; i < ncells; i++) {
+        virCapsHostNUMACellPtr cell = g_ptr_array_index(caps->cells, i);
+        unsigned int dist;
+
+        if (i == seed)
+            continue;
+
+        dist = virCapabilitiesHostNUMACellDistance(seedCell, cell);
+
+        for (j = n; j > 1; j--) {
+            virCapsHostNUMACellPtr prev = g_ptr_array_index(caps->cells,
+                                                            order[j - 1]);
+
+            if (virCapabilitiesHostNUMACellDistance(seedCell, prev) <= dist)
+                break;
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+        n++;
+    }
+}
+
+
+typedef struct _virCapsHostNUMAPlacement virCapsHostNUMAPlacement;
+struct _virCapsHostNUMAPlacement {
+    bool overcommit;                /* more vCPUs than pCPUs */
+    size_t nsockets;
+    size_t nnodes;
+    unsigned long long distance;    /* sum over all pairs of nodes */
+    unsigned long long load;        /* vCPUs per pCPU, in thousandths */
+};
+
+
+static bool
+virCapabilitiesHostNUMAPlacementBetter(const virCapsHostNUMAPlacement *a,
+                                       const virCapsHostNUMAPlacement *b)
+{
+    if (a->overcommit != b->overcommit)
+        return !a->overcommit;
+    if (a->nsockets != b->nsockets)
+        return a->nsockets < b->nsockets;
+    if (a->nnodes != b->nnodes)
+        return a->nnodes < b->nnodes;
+    if (a->distance != b->distance)
+        return a->distance < b->distance;
+    return a->load < b->load;
+}
+
+
+/**
+ * virCapabilitiesHostNUMAPlace:
+ * @caps: host NUMA topology
+ * @load: free memory and vCPU load of each cell, indexed as @caps->cells
+ * @vcpus: number of vCPUs of the domain
+ * @memory: memory of the domain in kibibytes
+ *
+ * Choose the host NUMA nodes a domain should be confined to. Each node
+ * in turn is grown by its nearest neighbours until the set has enough
+ * free memory and pCPUs for the domain. Out of all such sets the one
+ * which doesn't overcommit pCPUs, spans the fewest sockets and nodes,
+ * has the shortest distances and carries the least load wins; ties go
+ * to the set found first. If the domain doesn't fit anywhere, all
+ * nodes are returned and it's up to the kernel.
+ *
+ * Returns the nodeset on success, NULL on error.
+ */
+virBitmapPtr
+virCapabilitiesHostNUMAPlace(virCapsHostNUMAPtr caps,
+                             const virCapsHostNUMAPlacementLoad *load,
+                             unsigned int vcpus,
+                             unsigned long long memory)
+{
+    size_t ncells = caps->cells->len;
+    g_autofree size_t *order = NULL;
+    virBitmapPtr best = NULL;
+    virCapsHostNUMAPlacement bestScore = { 0 };
+    unsigned int totalcpus = 0;
+    unsigned int needcpus;
+    int maxnode = 0;
+    size_t seed;
+    size_t i, j;
+
+    if (ncells == 0) {
+        virReportError(VIR_ERR_OPERATION_FAILED, "%s",
+                       _("no host NUMA nodes to place the domain on"));
+        return NULL;
+    }
+
+    for (i = 0; i < ncells; i++) {
+        virCapsHostNUMACellPtr cell = g_ptr_array_index(caps->cells, i);
+
+        maxnode = MAX(maxnode, cell->num);
+        totalcpus += cell->ncpus;
+    }
+
+    /* A domain with more vCPUs than the host has pCPUs can't be helped */
+    needcpus = MIN(vcpus, totalcpus);
+    order = g_new0(size_t, ncells);
+
+    for (seed = 0; seed < ncells; seed++) {
+        g_autoptr(virBitmap) nodes = virBitmapNew(maxnode + 1);
+        g_autoptr(virBitmap) sockets = virBitmapNew(0);
+        virCapsHostNUMAPlacement score = { 0 };
+        unsigned long long memFree = 0;
+        unsigned int ncpus = 0;
+        unsigned int placed = 0;
+
+        virCapabilitiesHostNUMAPlacementOrder(caps, seed, order);
+
+        for (i = 0; i < ncells; i++) {
+            virCapsHostNUMACellPtr cell = g_ptr_array_index(caps->cells,
+                                                            order[i]);
+
+            for (j = 0; j < i; j++) {
+                virCapsHostNUMACellPtr other = g_ptr_array_index(caps->cells,
+                                                                 order[j]);
+
+                score.distance += virCapabilitiesHostNUMACellDistance(other,
+                                                                      cell);
+            }
+
+            for (j = 0; j < cell->ncpus; j++)
+                ignore_value(virBitmapSetBitExpand(sockets,
+                                                   cell->cpus[j].socket_id));
+            ignore_value(virBitmapSetBit(nodes, cell->num));
+
+            memFree += load[order[i]].memFree;
+            ncpus += cell->ncpus;
+            placed += load[order[i]].vcpus;
+
+            if (memFree < memory || ncpus < needcpus)
+                continue;
+
+            score.overcommit = placed + vcpus > ncpus;
+            score.nsockets = virBitmapCountBits(sockets);
+            score.nnodes = i + 1;
+            score.load = ncpus ? (placed + vcpus) * 1000ULL / ncpus : 0;
+
+            if (!best || virCapabilitiesHostNUMAPlacementBetter(&score,
+                                                                &bestScore)) {
+                virBitmapFree(best);
+                best = virBitmapNewCopy(nodes);
+                bestScore = score;
+            }
+        }
+    }
+
+    if (!best) {
+        VIR_DEBUG("%llu KiB don't fit on any set of nodes, using all of them",
+                  memory);
+        best = virBitmapNew(maxnode + 1);
+        for (i = 0; i < ncells; i++) {
+            virCapsHostNUMACellPtr cell = g_ptr_array_index(caps->cells, i);
+
+            ignore_value(virBitmapSetBit(best, cell->num));
+        }
+    }
+
+    return best;
+}
+
+
 int
 virCapabilitiesGetNodeInfo(virNodeInfoPtr nodeinfo)
 {
@@ -119,6 +119,13 @@ struct _virCapsHostNUMA {
     GPtrArray *cells;
 };
 
+typedef struct _virCapsHostNUMAPlacementLoad virCapsHostNUMAPlacementLoad;
+typedef virCapsHostNUMAPlacementLoad *virCapsHostNUMAPlacementLoadPtr;
+struct _virCapsHostNUMAPlacementLoad {
+    unsigned long long memFree; /* in kibibytes, usable by the domain */
+    unsigned int vcpus;         /* vCPUs of running domains bound here */
+};
+
 struct _virCapsHostSecModelLabel {
     char *type;
     char *label;
@@ -329,6 +336,12 @@ virCapabilitiesFormatXML(virCapsPtr caps);
 virBitmapPtr virCapabilitiesHostNUMAGetCpus(virCapsHostNUMAPtr caps,
                                             virBitmapPtr nodemask);
 
+virBitmapPtr
+virCapabilitiesHostNUMAPlace(virCapsHostNUMAPtr caps,
+                             const virCapsHostNUMAPlacementLoad *load,
+                             unsigned int vcpus,
+                             unsigned long long memory);
+
 int virCapabilitiesGetNodeInfo(virNodeInfoPtr nodeinfo);
 
 int virCapabilitiesInitPages(virCapsPtr caps);
@@ -58,6 +58,8 @@ static virClassPtr virDomainEventDeviceRemovalFailedClass;
 static virClassPtr virDomainEventMetadataChangeClass;
 static virClassPtr virDomainEventBlockThresholdClass;
 static virClassPtr virDomainEventMemoryFailureClass;
+static virClassPtr virDomainEventPressureClass;
+static virClassPtr virDomainEventResctrlTuneClass;
 
 static void virDomainEventDispose(void *obj);
 static void virDomainEventLifecycleDispose(void *obj);
@@ -81,6 +83,8 @@ static void virDomainEventDeviceRemovalFailedDispose(void *obj);
 static void virDomainEventMetadataChangeDispose(void *obj);
 static void virDomainEventBlockThresholdDispose(void *obj);
 static void virDomainEventMemoryFailureDispose(void *obj);
+static void virDomainEventPressureDispose(void *obj);
+static void virDomainEventResctrlTuneDispose(void *obj);
 
 static void
 virDomainEventDispatchDefaultFunc(virConnectPtr conn,
@@ -299,6 +303,27 @@ struct _virDomainEventMemoryFailure {
 typedef struct _virDomainEventMemoryFailure virDomainEventMemoryFailure;
 typedef virDomainEventMemoryFailure *virDomainEventMemoryFailurePtr;
 
+struct _virDomainEventPressure {
+    virDomainEvent parent;
+
+    int resource;
+    unsigned long long stall;
+    unsigned long long window;
+};
+typedef struct _virDomainEventPressure virDomainEventPressure;
+typedef virDomainEventPressure *virDomainEventPressurePtr;
+
+struct _virDomainEventResctrlTune {
+    virDomainEvent parent;
+
+    int resource;
+    char *vcpus;
+    unsigned int id;
+    unsigned long long value;
+};
+typedef struct _virDomainEventResctrlTune virDomainEventResctrlTune;
+typedef virDomainEventResctrlTune *virDomainEventResctrlTunePtr;
+
 static int
 virDomainEventsOnceInit(void)
 {
@@ -346,6 +371,10 @@ virDomainEventsOnceInit(void)
         return -1;
     if (!VIR_CLASS_NEW(virDomainEventMemoryFailure, virDomainEventClass))
         return -1;
+    if (!VIR_CLASS_NEW(virDomainEventPressure, virDomainEventClass))
+        return -1;
+    if (!VIR_CLASS_NEW(virDomainEventResctrlTune, virDomainEventClass))
+        return -1;
     return 0;
 }
 
@@ -562,6 +591,22 @@ virDomainEventMemoryFailureDispose(void *obj)
     VIR_DEBUG("obj=%p", event);
 }
 
+static void
+virDomainEventPressureDispose(void *obj)
+{
+    virDomainEventPressurePtr event = obj;
+    VIR_DEBUG("obj=%p", event);
+}
+
+static void
+virDomainEventResctrlTuneDispose(void *obj)
+{
+    virDomainEventResctrlTunePtr event = obj;
+    VIR_DEBUG("obj=%p", event);
+
+    g_free(event->vcpus);
+}
+
 
 static void *
 virDomainEventNew(virClassPtr klass,
@@ -1686,6 +1731,103 @@ virDomainEventMemoryFailureNewFromDom(virDomainPtr dom,
                                           recipient, action, flags);
 }
 
+
+static virObjectEventPtr
+virDomainEventPressureNew(int id,
+                          const char *name,
+                          unsigned char *uuid,
+                          int resource,
+                          unsigned long long stall,
+                          unsigned long long window)
+{
+    virDomainEventPressurePtr ev;
+
+    if (virDomainEventsInitialize() < 0)
+        return NULL;
+
+    if (!(ev = virDomainEventNew(virDomainEventPressureClass,
+                                 VIR_DOMAIN_EVENT_ID_PRESSURE,
+                                 id, name, uuid)))
+        return NULL;
+
+    ev->resource = resource;
+    ev->stall = stall;
+    ev->window = window;
+
+    return (virObjectEventPtr)ev;
+}
+
+virObjectEventPtr
+virDomainEventPressureNewFromObj(virDomainObjPtr obj,
+                                 int resource,
+                                 unsigned long long stall,
+                                 unsigned long long window)
+{
+    return virDomainEventPressureNew(obj->def->id, obj->def->name,
+                                     obj->def->uuid, resource, stall, window);
+}
+
+virObjectEventPtr
+virDomainEventPressureNewFromDom(virDomainPtr dom,
+                                 int resource,
+                                 unsigned long long stall,
+                                 unsigned long long window)
+{
+    return virDomainEventPressureNew(dom->id, dom->name, dom->uuid,
+                                     resource, stall, window);
+}
+
+
+static virObjectEventPtr
+virDomainEventResctrlTuneNew(int id,
+                             const char *name,
+                             unsigned char *uuid,
+                             int resource,
+                             const char *vcpus,
+                             unsigned int resid,
+                             unsigned long long value)
+{
+    virDomainEventResctrlTunePtr ev;
+
+    if (virDomainEventsInitialize() < 0)
+        return NULL;
+
+    if (!(ev = virDomainEventNew(virDomainEventResctrlTuneClass,
+                                 VIR_DOMAIN_EVENT_ID_RESCTRL_TUNE,
+                                 id, name, uuid)))
+        return NULL;
+
+    ev->resource = resource;
+    ev->vcpus = g_strdup(vcpus);
+    ev->id = resid;
+    ev->value = value;
+
+    return (virObjectEventPtr)ev;
+}
+
+virObjectEventPtr
+virDomainEventResctrlTuneNewFromObj(virDomainObjPtr obj,
+                                    int resource,
+                                    const char *vcpus,
+                                    unsigned int id,
+                                    unsigned long long value)
+{
+    return virDomainEventResctrlTuneNew(obj->def->id, obj->def->name,
+                                        obj->def->uuid, resource, vcpus,
+                                        id, value);
+}
+
+virObjectEventPtr
+virDomainEventResctrlTuneNewFromDom(virDomainPtr dom,
+                                    int resource,
+                                    const char *vcpus,
+                                    unsigned int id,
+                                    unsigned long long value)
+{
+    return virDomainEventResctrlTuneNew(dom->id, dom->name, dom->uuid,
+                                        resource, vcpus, id, value);
+}
+
 static void
 virDomainEventDispatchDefaultFunc(virConnectPtr conn,
                                   virObjectEventPtr event,
@@ -1981,6 +2123,31 @@ virDomainEventDispatchDefaultFunc(virConnectPtr conn,
                                                              cbopaque);
             goto cleanup;
         }
+    case VIR_DOMAIN_EVENT_ID_PRESSURE:
+        {
+            virDomainEventPressurePtr pressureEvent;
+
+            pressureEvent = (virDomainEventPressurePtr)event;
+            ((virConnectDomainEventPressureCallback)cb)(conn, dom,
+                                                        pressureEvent->resource,
+                                                        pressureEvent->stall,
+                                                        pressureEvent->window,
+                                                        cbopaque);
+            goto cleanup;
+        }
+    case VIR_DOMAIN_EVENT_ID_RESCTRL_TUNE:
+        {
+            virDomainEventResctrlTunePtr tuneEvent;
+
+            tuneEvent = (virDomainEventResctrlTunePtr)event;
+            ((virConnectDomainEventResctrlTuneCallback)cb)(conn, dom,
+                                                           tuneEvent->resource,
+                                                           tuneEvent->vcpus,
+                                                           tuneEvent->id,
+                                                           tuneEvent->value,
+                                                           cbopaque);
+            goto cleanup;
+        }
 
     case VIR_DOMAIN_EVENT_ID_LAST:
         break;
@@ -267,6 +267,32 @@ virDomainEventMemoryFailureNewFromDom(virDomainPtr dom,
                                       int action,
                                       unsigned int flags);
 
+virObjectEventPtr
+virDomainEventPressureNewFromObj(virDomainObjPtr obj,
+                                 int resource,
+                                 unsigned long long stall,
+                                 unsigned long long window);
+
+virObjectEventPtr
+virDomainEventPressureNewFromDom(virDomainPtr dom,
+                                 int resource,
+                                 unsigned long long stall,
+                                 unsigned long long window);
+
+virObjectEventPtr
+virDomainEventResctrlTuneNewFromObj(virDomainObjPtr obj,
+                                    int resource,
+                                    const char *vcpus,
+                                    unsigned int id,
+                                    unsigned long long value);
+
+virObjectEventPtr
+virDomainEventResctrlTuneNewFromDom(virDomainPtr dom,
+                                    int resource,
+                                    const char *vcpus,
+                                    unsigned int id,
+                                    unsigned long long value);
+
 int
 virDomainEventStateRegister(virConnectPtr conn,
                             virObjectEventStatePtr state,
@@ -469,6 +469,53 @@ virStoragePoolObjListForEach(virStoragePoolObjListPtr pools,
 }
 
 
+struct _virStoragePoolObjListCollectData {
+    virStoragePoolObjPtr *objs;
+    size_t nobjs;
+};
+
+
+static int
+virStoragePoolObjListCollectCb(void *payload,
+                               const char *name G_GNUC_UNUSED,
+                               void *opaque)
+{
+    struct _virStoragePoolObjListCollectData *data = opaque;
+
+    data->objs[data->nobjs++] = virObjectRef(payload);
+    return 0;
+}
+
+
+/**
+ * virStoragePoolObjListCollect
+ * @pools: Pointer to pools object
+ * @objs: filled with an array of pool objects
+ * @nobjs: filled with the number of elements in @objs
+ *
+ * Takes a snapshot of all the objects in @pools. Unlike
+ * virStoragePoolObjListForEach the objects can be processed without
+ * holding the storageDriverLock, as each of them is returned with an
+ * extra reference. The caller is responsible for unreferencing the
+ * objects and freeing @objs.
+ */
+void
+virStoragePoolObjListCollect(virStoragePoolObjListPtr pools,
+                             virStoragePoolObjPtr **objs,
+                             size_t *nobjs)
+{
+    struct _virStoragePoolObjListCollectData data = { NULL, 0 };
+
+    virObjectRWLockRead(pools);
+    data.objs = g_new0(virStoragePoolObjPtr, virHashSize(pools->objs));
+    virHashForEach(pools->objs, virStoragePoolObjListCollectCb, &data);
+    virObjectRWUnlock(pools);
+
+    *objs = data.objs;
+    *nobjs = data.nobjs;
+}
+
+
 struct _virStoragePoolObjListSearchData {
     virStoragePoolObjListSearcher searcher;
     const void *opaque;
@@ -24,6 +24,7 @@
 #include "storage_conf.h"
 
 #include "capabilities.h"
+#include "virthreadpool.h"
 
 typedef struct _virStoragePoolObj virStoragePoolObj;
 typedef virStoragePoolObj *virStoragePoolObjPtr;
@@ -52,6 +53,22 @@ struct _virStorageDriverState {
 
     /* Immutable pointer, read only after initialized */
     virCapsPtr caps;
+
+    /* Immutable pointer, self-locking APIs. Used to check state of and
+     * autostart pools concurrently */
+    virThreadPoolPtr workerPool;
+
+    /* Protects the fields below. Kept separate from @lock so that
+     * waiting for pools to start doesn't block the rest of the driver */
+    virMutex poolStartLock;
+    virCond poolStartCond;
+    /* Number of pools queued or being processed by @workerPool */
+    size_t poolStartJobs;
+    /* Time (in ms) until which it's worth waiting for @poolStartJobs,
+     * extended every time a worker picks up another pool */
+    unsigned long long poolStartDeadline;
+    /* Set on shutdown, queued pools are then dropped instead of started */
+    bool poolStartQuit;
 };
 
 typedef bool
@@ -247,6 +264,11 @@ virStoragePoolObjListForEach(virStoragePoolObjListPtr pools,
                              virStoragePoolObjListIterator iter,
                              const void *opaque);
 
+void
+virStoragePoolObjListCollect(virStoragePoolObjListPtr pools,
+                             virStoragePoolObjPtr **objs,
+                             size_t *nobjs);
+
 typedef bool
 (*virStoragePoolObjListSearcher)(virStoragePoolObjPtr obj,
                                  const void *opaque);
@@ -1400,6 +1400,19 @@ typedef int
                                     unsigned int nkeys,
                                     unsigned int flags);
 
+typedef int
+(*virDrvDomainMoveNumaNodes)(virDomainPtr domain,
+                             const char *nodeset,
+                             virTypedParameterPtr *params,
+                             int *nparams,
+                             unsigned int flags);
+
+typedef int
+(*virDrvNodeGetAllStats)(virConnectPtr conn,
+                         virTypedParameterPtr *params,
+                         int *nparams,
+                         unsigned int flags);
+
 typedef struct _virHypervisorDriver virHypervisorDriver;
 typedef virHypervisorDriver *virHypervisorDriverPtr;
 
@@ -1665,4 +1678,6 @@ struct _virHypervisorDriver {
     virDrvDomainBackupGetXMLDesc domainBackupGetXMLDesc;
     virDrvDomainAuthorizedSSHKeysGet domainAuthorizedSSHKeysGet;
     virDrvDomainAuthorizedSSHKeysSet domainAuthorizedSSHKeysSet;
+    virDrvDomainMoveNumaNodes domainMoveNumaNodes;
+    virDrvNodeGetAllStats nodeGetAllStats;
 };
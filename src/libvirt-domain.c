@@ -11885,6 +11885,94 @@ virConnectGetDomainCapabilities(virConnectPtr conn,
  *                       bytes consumed by @vcpus that passing through all
  *                       memory controllers, either local or remote controller.
  *
+ * VIR_DOMAIN_STATS_CGROUP:
+ *     Return resource usage accounted to the domain's control group. These
+ *     are read from the host kernel only and never need to talk to the
+ *     hypervisor, so they can be collected cheaply for many domains at once.
+ *     The typed parameter keys are in this format:
+ *
+ *     "cgroup.memory.usage" - memory charged to the domain in KiB
+ *                             as unsigned long long.
+ *     "cgroup.memory.cache" - page cache charged to the domain in KiB
+ *                             as unsigned long long.
+ *     "cgroup.memory.active_anon" - active anonymous memory in KiB
+ *                                   as unsigned long long.
+ *     "cgroup.memory.inactive_anon" - inactive anonymous memory in KiB
+ *                                     as unsigned long long.
+ *     "cgroup.memory.active_file" - active file backed memory in KiB
+ *                                   as unsigned long long.
+ *     "cgroup.memory.inactive_file" - inactive file backed memory in KiB
+ *                                     as unsigned long long.
+ *     "cgroup.memory.unevictable" - unevictable memory in KiB
+ *                                   as unsigned long long.
+ *     "cgroup.io.read.bytes" - bytes read from all block devices
+ *                              as long long.
+ *     "cgroup.io.write.bytes" - bytes written to all block devices
+ *                               as long long.
+ *     "cgroup.io.read.reqs" - read requests issued to all block devices
+ *                             as long long.
+ *     "cgroup.io.write.reqs" - write requests issued to all block devices
+ *                              as long long.
+ *     "cgroup.pressure.<resource>.<kind>.avg10" - share of time in percent
+ *                              some ("some") or all ("full") tasks of the
+ *                              domain were stalled on <resource> ("cpu",
+ *                              "memory" or "io") over the last 10 seconds
+ *                              as double. Only reported by hosts with
+ *                              pressure stall information.
+ *     "cgroup.pressure.<resource>.<kind>.avg60" - the same over the last
+ *                              60 seconds as double.
+ *     "cgroup.pressure.<resource>.<kind>.avg300" - the same over the last
+ *                              300 seconds as double.
+ *     "cgroup.pressure.<resource>.<kind>.total" - total stall time in
+ *                              microseconds as unsigned long long.
+ *
+ * VIR_DOMAIN_STATS_PERF_VCPU:
+ *     Return the enabled perf events counted separately for each vCPU
+ *     thread. The hardware events of one vCPU are counted in groups small
+ *     enough to fit on the CPU's counters, the software events in a group
+ *     of their own. The rates are computed against the values returned by
+ *     the previous call and are missing on the first one. The "cmt",
+ *     "mbmt" and "mbml" events are not counted per vCPU. As every vCPU
+ *     needs counters of its own, this group is only returned if it is
+ *     requested in @stats explicitly. The typed parameter keys are in this
+ *     format:
+ *
+ *     "perf.vcpu.<num>.time_enabled" - time in nanoseconds the counters of
+ *                                      vCPU <num> were enabled as
+ *                                      unsigned long long.
+ *     "perf.vcpu.<num>.time_running" - time in nanoseconds the least
+ *                                      counted group of vCPU <num> was
+ *                                      actually counting as unsigned long
+ *                                      long. If lower than time_enabled,
+ *                                      the host had to share the hardware
+ *                                      counters and the values are scaled
+ *                                      estimates.
+ *     "perf.vcpu.<num>.<event>" - the count of <event> of vCPU <num> as
+ *                                 unsigned long long. <event> is one of the
+ *                                 names used by VIR_DOMAIN_STATS_PERF.
+ *     "perf.vcpu.<num>.ipc" - instructions per cpu cycle since the previous
+ *                             call as double. Requires the "cpu_cycles" and
+ *                             "instructions" events.
+ *     "perf.vcpu.<num>.cache_misses_rate" - cache misses per second since
+ *                                           the previous call as double.
+ *     "perf.vcpu.<num>.cache_miss_ratio" - share of cache references that
+ *                                          missed since the previous call as
+ *                                          double. Requires the
+ *                                          "cache_references" event too.
+ *
+ * VIR_DOMAIN_STATS_KVM:
+ *     Return the statistics the KVM module of the host keeps for each vCPU,
+ *     like exits, halt polling successes and failures or time spent halted.
+ *     Their set and names depend on the host kernel and architecture. They
+ *     are queried from QEMU if it supports the 'query-stats' command.
+ *     Otherwise, the statistics summed up over all vCPUs are read from
+ *     debugfs instead. The typed parameter keys are in this format:
+ *
+ *     "kvm.vcpu.<num>.<name>" - statistic <name> of vCPU <num> as
+ *                               unsigned long long.
+ *     "kvm.<name>" - statistic <name> of the whole VM as unsigned long
+ *                    long. Only reported without per vCPU statistics.
+ *
  * Note that entire stats groups or individual stat fields may be missing from
  * the output in case they are not supported by the given hypervisor, are not
  * applicable for the current state of the guest domain, or their retrieval
@@ -13102,3 +13190,76 @@ virDomainAuthorizedSSHKeysSet(virDomainPtr domain,
     virDispatchError(conn);
     return -1;
 }
+
+
+/**
+ * virDomainMoveNumaNodes:
+ * @domain: a domain object
+ * @nodeset: host NUMA nodes to move the domain to, e.g. "0-1,3"
+ * @params: pointer to a list of typed parameters describing the move
+ * @nparams: number of items in @params
+ * @flags: currently unused, callers should pass 0
+ *
+ * Move a running @domain onto the host NUMA nodes listed in @nodeset
+ * in one step: memory of the domain is restricted to @nodeset and the
+ * pages already allocated elsewhere are migrated there, and the
+ * emulator, vCPU and I/O threads are pinned to the host CPUs of
+ * @nodeset. The change affects the running domain only.
+ *
+ * Domains which pin individual vCPU, emulator or I/O threads, bind
+ * guest NUMA nodes to host nodes, or use a numatune mode other than
+ * "strict" can't be moved this way. With static placement the host CPUs
+ * of @nodeset replace the CPU set of the <vcpu cpuset=...> element in
+ * the live definition of the domain.
+ *
+ * If the move fails, the domain is put back onto the host nodes and
+ * CPUs it was using before.
+ *
+ * On success @params is filled with:
+ *
+ *     VIR_DOMAIN_NUMA_MOVE_BYTES - bytes of memory moved onto @nodeset
+ *     VIR_DOMAIN_NUMA_MOVE_REMAINING - bytes of memory left outside of
+ *                                      @nodeset
+ *     VIR_DOMAIN_NUMA_MOVE_TIME - duration of the move in milliseconds
+ *
+ * The caller is responsible for calling virTypedParamsFree to free
+ * memory returned in @params.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virDomainMoveNumaNodes(virDomainPtr domain,
+                       const char *nodeset,
+                       virTypedParameterPtr *params,
+                       int *nparams,
+                       unsigned int flags)
+{
+    virConnectPtr conn;
+
+    VIR_DOMAIN_DEBUG(domain, "nodeset=%s, params=%p, nparams=%p, flags=0x%x",
+                     NULLSTR(nodeset), params, nparams, flags);
+
+    virResetLastError();
+
+    virCheckDomainReturn(domain, -1);
+    conn = domain->conn;
+
+    virCheckReadOnlyGoto(conn->flags, error);
+    virCheckNonNullArgGoto(nodeset, error);
+    virCheckNonNullArgGoto(params, error);
+    virCheckNonNullArgGoto(nparams, error);
+
+    if (conn->driver->domainMoveNumaNodes) {
+        int ret;
+        ret = conn->driver->domainMoveNumaNodes(domain, nodeset,
+                                                params, nparams, flags);
+        if (ret < 0)
+            goto error;
+        return ret;
+    }
+
+    virReportUnsupportedError();
+ error:
+    virDispatchError(conn);
+    return -1;
+}
@@ -1762,3 +1762,88 @@ virNodeGetSEVInfo(virConnectPtr conn,
     virDispatchError(conn);
     return -1;
 }
+
+
+/**
+ * virNodeGetAllStats:
+ * @conn: pointer to the hypervisor connection
+ * @params: pointer to an array of typed parameters, which will be
+ *          allocated on success
+ * @nparams: will be filled with the number of elements in @params
+ * @flags: extra flags; not used yet, so callers should always pass 0
+ *
+ * Returns the CPU and memory statistics of all host CPUs and NUMA
+ * cells at once. Unlike calling virNodeGetCPUStats() and
+ * virNodeGetMemoryStats() for every CPU and cell, all the values come
+ * from the same sample and the hypervisor reads each of its sources
+ * only once.
+ *
+ * The following typed parameters are returned. CPU times are in
+ * nanoseconds, memory sizes in kibibytes:
+ *
+ *  "cpu.kernel" - kernel time of all CPUs as unsigned long long
+ *  "cpu.user" - user time of all CPUs as unsigned long long
+ *  "cpu.idle" - idle time of all CPUs as unsigned long long
+ *  "cpu.iowait" - iowait time of all CPUs as unsigned long long
+ *  "cpu.count" - number of host CPUs reported as unsigned int
+ *  "cpu.<num>.id" - id of the host CPU <num> as unsigned int
+ *  "cpu.<num>.kernel" - kernel time of CPU <num> as unsigned long long
+ *  "cpu.<num>.user" - user time of CPU <num> as unsigned long long
+ *  "cpu.<num>.idle" - idle time of CPU <num> as unsigned long long
+ *  "cpu.<num>.iowait" - iowait time of CPU <num> as unsigned long long
+ *  "memory.total" - total host memory as unsigned long long
+ *  "memory.free" - free host memory as unsigned long long
+ *  "memory.buffers" - buffer memory as unsigned long long
+ *  "memory.cached" - cached memory as unsigned long long
+ *  "cell.count" - number of NUMA cells reported as unsigned int
+ *  "cell.<num>.id" - id of the NUMA cell <num> as unsigned int
+ *  "cell.<num>.memory.total" - total memory of the cell as
+ *                              unsigned long long
+ *  "cell.<num>.memory.free" - free memory of the cell as
+ *                             unsigned long long
+ *  "cell.<num>.hugepage.count" - number of huge page sizes reported
+ *                                for the cell as unsigned int
+ *  "cell.<num>.hugepage.<page>.size" - size of the huge page in
+ *                                      kibibytes as unsigned int
+ *  "cell.<num>.hugepage.<page>.total" - number of huge pages in the
+ *                                       pool as unsigned long long
+ *  "cell.<num>.hugepage.<page>.free" - number of free huge pages in
+ *                                      the pool as unsigned long long
+ *
+ * <num> and <page> are indexes starting at 0; offline host CPUs are
+ * not reported, so use the "id" fields to map entries to host CPUs
+ * and cells.
+ *
+ * The caller must free @params with virTypedParamsFree().
+ *
+ * Returns 0 on success, -1 otherwise.
+ */
+int
+virNodeGetAllStats(virConnectPtr conn,
+                   virTypedParameterPtr *params,
+                   int *nparams,
+                   unsigned int flags)
+{
+    VIR_DEBUG("conn=%p, params=%p, nparams=%p, flags=0x%x",
+              conn, params, nparams, flags);
+
+    virResetLastError();
+
+    virCheckConnectReturn(conn, -1);
+    virCheckNonNullArgGoto(params, error);
+    virCheckNonNullArgGoto(nparams, error);
+
+    if (conn->driver->nodeGetAllStats) {
+        int ret;
+        ret = conn->driver->nodeGetAllStats(conn, params, nparams, flags);
+        if (ret < 0)
+            goto error;
+        return ret;
+    }
+
+    virReportUnsupportedError();
+
+ error:
+    virDispatchError(conn);
+    return -1;
+}
@@ -763,6 +763,26 @@ qemuBlockJobEventProcessLegacyCompleted(virQEMUDriverPtr driver,
 }
 
 
+/**
+ * qemuBlockJobInvalidateHeaderCache:
+ * @chain: backing chain touched by a block job
+ *
+ * Block jobs rewrite image headers (e.g. the backing file name after a
+ * commit or pull) behind libvirt's back. Make sure the next traversal of
+ * @chain re-reads them.
+ */
+static void
+qemuBlockJobInvalidateHeaderCache(virStorageSourcePtr chain)
+{
+    virStorageSourcePtr n;
+
+    for (n = chain; virStorageSourceIsBacking(n); n = n->backingStore) {
+        if (virStorageSourceIsLocalStorage(n))
+            virStorageFileMetadataCacheInvalidate(n->path);
+    }
+}
+
+
 /**
  * qemuBlockJobEventProcessLegacy:
  * @driver: qemu driver
@@ -796,6 +816,9 @@ qemuBlockJobEventProcessLegacy(virQEMUDriverPtr driver,
     job->state = job->newstate;
     job->newstate = -1;
 
+    qemuBlockJobInvalidateHeaderCache(disk->src);
+    qemuBlockJobInvalidateHeaderCache(disk->mirror);
+
     /* If we completed a block pull or commit, then update the XML
      * to match.  */
     switch ((virConnectDomainEventBlockJobStatus) job->state) {
@@ -1656,6 +1679,13 @@ qemuBlockJobEventProcessConcluded(qemuBlockJobDataPtr job,
 
     VIR_DEBUG("handling job '%s' state '%d' newstate '%d'", job->name, job->state, job->newstate);
 
+    if (job->disk) {
+        qemuBlockJobInvalidateHeaderCache(job->disk->src);
+        qemuBlockJobInvalidateHeaderCache(job->disk->mirror);
+    }
+    qemuBlockJobInvalidateHeaderCache(job->chain);
+    qemuBlockJobInvalidateHeaderCache(job->mirrorChain);
+
     qemuBlockJobEventProcessConcludedTransition(job, driver, vm, asyncJob,
                                                 progressCurrent, progressTotal);
 
@@ -3091,7 +3091,14 @@ qemuBuildMemoryBackendProps(virJSONValuePtr *backendProps,
             if (!mem->nvdimmPmem)
                 prealloc = true;
         } else if (useHugepage) {
-            if (qemuGetDomainHupageMemPath(priv->driver, def, pagesize, &memPath) < 0)
+            const char *prefaulted = qemuHugepagesGetPath(priv->hugepages,
+                                                          priv->nhugepages,
+                                                          alias);
+
+            /* Point QEMU at the file whose pages libvirt allocated */
+            if (prefaulted)
+                memPath = g_strdup(prefaulted);
+            else if (qemuGetDomainHupageMemPath(priv->driver, def, pagesize, &memPath) < 0)
                 return -1;
             prealloc = true;
         } else {
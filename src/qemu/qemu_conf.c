@@ -279,6 +279,13 @@ virQEMUDriverConfigPtr virQEMUDriverConfigNew(bool privileged,
     cfg->keepAliveCount = 5;
     cfg->seccompSandbox = -1;
 
+    cfg->autoStartParallel = 1;
+
+    cfg->pressureWindow = 1000;
+
+    cfg->resctrlTuneMin = 50;
+    cfg->resctrlTuneMax = 200;
+
     cfg->logTimestamp = true;
     cfg->glusterDebugLevel = 4;
     cfg->stdioLogD = true;
@@ -623,6 +630,13 @@ virQEMUDriverConfigLoadSaveEntry(virQEMUDriverConfigPtr cfg,
         return -1;
     if (virConfGetValueBool(conf, "auto_start_bypass_cache", &cfg->autoStartBypassCache) < 0)
         return -1;
+    if (virConfGetValueUInt(conf, "auto_start_parallel", &cfg->autoStartParallel) < 0)
+        return -1;
+    if (cfg->autoStartParallel == 0) {
+        virReportError(VIR_ERR_CONF_SYNTAX, "%s",
+                       _("auto_start_parallel must be greater than 0"));
+        return -1;
+    }
 
     return 0;
 }
@@ -1007,6 +1021,89 @@ virQEMUDriverConfigLoadMemoryEntry(virQEMUDriverConfigPtr cfg,
 }
 
 
+static int
+virQEMUDriverConfigLoadHugepagesEntry(virQEMUDriverConfigPtr cfg,
+                                      virConfPtr conf)
+{
+    if (virConfGetValueBool(conf, "hugepages_reserve", &cfg->hugepagesReserve) < 0)
+        return -1;
+    if (virConfGetValueUInt(conf, "hugepages_prefault_threads", &cfg->hugepagesPrefaultThreads) < 0)
+        return -1;
+
+    if (cfg->hugepagesPrefaultThreads > 256) {
+        virReportError(VIR_ERR_CONF_SYNTAX, "%s",
+                       _("hugepages_prefault_threads must not exceed 256"));
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+virQEMUDriverConfigLoadNumaEntry(virQEMUDriverConfigPtr cfg,
+                                 virConfPtr conf)
+{
+    if (virConfGetValueBool(conf, "numad_placement", &cfg->numadPlacement) < 0)
+        return -1;
+
+    return 0;
+}
+
+
+static int
+virQEMUDriverConfigLoadPressureEntry(virQEMUDriverConfigPtr cfg,
+                                     virConfPtr conf)
+{
+    if (virConfGetValueUInt(conf, "pressure_memory_stall_ms", &cfg->pressureMemoryStall) < 0)
+        return -1;
+    if (virConfGetValueUInt(conf, "pressure_io_stall_ms", &cfg->pressureIOStall) < 0)
+        return -1;
+    if (virConfGetValueUInt(conf, "pressure_window_ms", &cfg->pressureWindow) < 0)
+        return -1;
+
+    /* The kernel accepts windows between 500ms and 10s */
+    if (cfg->pressureWindow < 500 || cfg->pressureWindow > 10000) {
+        virReportError(VIR_ERR_CONF_SYNTAX, "%s",
+                       _("pressure_window_ms must be between 500 and 10000"));
+        return -1;
+    }
+
+    if (cfg->pressureMemoryStall > cfg->pressureWindow ||
+        cfg->pressureIOStall > cfg->pressureWindow) {
+        virReportError(VIR_ERR_CONF_SYNTAX, "%s",
+                       _("pressure stall thresholds must not exceed pressure_window_ms"));
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+virQEMUDriverConfigLoadResctrlEntry(virQEMUDriverConfigPtr cfg,
+                                    virConfPtr conf)
+{
+    if (virConfGetValueUInt(conf, "resctrl_tune_interval", &cfg->resctrlTuneInterval) < 0)
+        return -1;
+    if (virConfGetValueUInt(conf, "resctrl_tune_min", &cfg->resctrlTuneMin) < 0)
+        return -1;
+    if (virConfGetValueUInt(conf, "resctrl_tune_max", &cfg->resctrlTuneMax) < 0)
+        return -1;
+
+    if (cfg->resctrlTuneMin == 0 ||
+        cfg->resctrlTuneMin > 100 ||
+        cfg->resctrlTuneMax < 100) {
+        virReportError(VIR_ERR_CONF_SYNTAX, "%s",
+                       _("resctrl_tune_min must be between 1 and 100 and "
+                         "resctrl_tune_max must be at least 100"));
+        return -1;
+    }
+
+    return 0;
+}
+
+
 static int
 virQEMUDriverConfigLoadSWTPMEntry(virQEMUDriverConfigPtr cfg,
                                   virConfPtr conf)
@@ -1105,6 +1202,18 @@ int virQEMUDriverConfigLoadFile(virQEMUDriverConfigPtr cfg,
     if (virQEMUDriverConfigLoadMemoryEntry(cfg, conf) < 0)
         return -1;
 
+    if (virQEMUDriverConfigLoadHugepagesEntry(cfg, conf) < 0)
+        return -1;
+
+    if (virQEMUDriverConfigLoadNumaEntry(cfg, conf) < 0)
+        return -1;
+
+    if (virQEMUDriverConfigLoadPressureEntry(cfg, conf) < 0)
+        return -1;
+
+    if (virQEMUDriverConfigLoadResctrlEntry(cfg, conf) < 0)
+        return -1;
+
     if (virQEMUDriverConfigLoadSWTPMEntry(cfg, conf) < 0)
         return -1;
 
@@ -1309,6 +1418,67 @@ virQEMUDriverGetHostCPU(virQEMUDriverPtr driver)
 }
 
 
+/**
+ * virQEMUDriverUpdateNUMAVcpus:
+ * @driver: the QEMU driver
+ * @vcpus: count of vCPUs bound to each host NUMA node
+ * @nvcpus: number of items in @vcpus
+ * @add: whether to add @vcpus to the totals or subtract them
+ *
+ * Account vCPUs of a domain to the host NUMA nodes they may run on.
+ * The totals are the load the automatic NUMA placement works with.
+ */
+void
+virQEMUDriverUpdateNUMAVcpus(virQEMUDriverPtr driver,
+                             const unsigned int *vcpus,
+                             size_t nvcpus,
+                             bool add)
+{
+    size_t i;
+
+    qemuDriverLock(driver);
+
+    if (nvcpus > driver->nnumaVcpus)
+        ignore_value(VIR_EXPAND_N(driver->numaVcpus, driver->nnumaVcpus,
+                                  nvcpus - driver->nnumaVcpus));
+
+    for (i = 0; i < nvcpus; i++) {
+        if (add)
+            driver->numaVcpus[i] += vcpus[i];
+        else if (driver->numaVcpus[i] >= vcpus[i])
+            driver->numaVcpus[i] -= vcpus[i];
+        else
+            driver->numaVcpus[i] = 0;
+    }
+
+    qemuDriverUnlock(driver);
+}
+
+
+/**
+ * virQEMUDriverGetNUMAVcpus:
+ * @driver: the QEMU driver
+ * @nvcpus: filled with the number of items returned
+ *
+ * Returns a copy of the count of vCPUs of running domains bound to
+ * each host NUMA node, indexed by node. The caller must free it.
+ */
+unsigned int *
+virQEMUDriverGetNUMAVcpus(virQEMUDriverPtr driver,
+                          size_t *nvcpus)
+{
+    unsigned int *ret;
+
+    qemuDriverLock(driver);
+    ret = g_new0(unsigned int, driver->nnumaVcpus + 1);
+    memcpy(ret, driver->numaVcpus, sizeof(*ret) * driver->nnumaVcpus);
+    *nvcpus = driver->nnumaVcpus;
+    qemuDriverUnlock(driver);
+
+    return ret;
+}
+
+
 virCapsPtr virQEMUDriverCreateCapabilities(virQEMUDriverPtr driver)
 {
     size_t i, j;
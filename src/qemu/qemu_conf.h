@@ -57,6 +57,12 @@ typedef virQEMUDriver *virQEMUDriverPtr;
 typedef struct _virQEMUDriverConfig virQEMUDriverConfig;
 typedef virQEMUDriverConfig *virQEMUDriverConfigPtr;
 
+typedef struct _qemuResctrlTune qemuResctrlTune;
+typedef qemuResctrlTune *qemuResctrlTunePtr;
+
+typedef struct _qemuHugepageLedger qemuHugepageLedger;
+typedef qemuHugepageLedger *qemuHugepageLedgerPtr;
+
 /* Main driver config. The data in these object
  * instances is immutable, so can be accessed
  * without locking. Threads must, however, hold
@@ -195,6 +201,7 @@ struct _virQEMUDriverConfig {
     char *autoDumpPath;
     bool autoDumpBypassCache;
     bool autoStartBypassCache;
+    unsigned int autoStartParallel;
 
     char *lockManagerName;
 
@@ -219,6 +226,19 @@ struct _virQEMUDriverConfig {
 
     char *memoryBackingDir;
 
+    unsigned int pressureMemoryStall;
+    unsigned int pressureIOStall;
+    unsigned int pressureWindow;
+
+    bool numadPlacement;
+
+    unsigned int resctrlTuneInterval;
+    unsigned int resctrlTuneMin;
+    unsigned int resctrlTuneMax;
+
+    bool hugepagesReserve;
+    unsigned int hugepagesPrefaultThreads;
+
     uid_t swtpm_user;
     gid_t swtpm_group;
 
@@ -315,6 +335,17 @@ struct _virQEMUDriver {
 
     /* Immutable pointer, self-locking APIs */
     virHashAtomicPtr migrationErrors;
+
+    /* Require lock to access. vCPUs of running domains bound to
+     * each host NUMA node, indexed by node */
+    unsigned int *numaVcpus;
+    size_t nnumaVcpus;
+
+    /* Immutable pointer, NULL unless resctrl auto-tuning is enabled */
+    qemuResctrlTunePtr resctrlTune;
+
+    /* Immutable pointer, self-locking APIs */
+    qemuHugepageLedgerPtr hugepageLedger;
 };
 
 virQEMUDriverConfigPtr virQEMUDriverConfigNew(bool privileged,
@@ -333,6 +364,12 @@ virQEMUDriverConfigSetDefaults(virQEMUDriverConfigPtr cfg);
 virQEMUDriverConfigPtr virQEMUDriverGetConfig(virQEMUDriverPtr driver);
 
 virCPUDefPtr virQEMUDriverGetHostCPU(virQEMUDriverPtr driver);
+void virQEMUDriverUpdateNUMAVcpus(virQEMUDriverPtr driver,
+                                  const unsigned int *vcpus,
+                                  size_t nvcpus,
+                                  bool add);
+unsigned int *virQEMUDriverGetNUMAVcpus(virQEMUDriverPtr driver,
+                                        size_t *nvcpus);
 virCapsPtr virQEMUDriverCreateCapabilities(virQEMUDriverPtr driver);
 virCapsPtr virQEMUDriverGetCapabilities(virQEMUDriverPtr driver,
                                         bool refresh);
@@ -1726,6 +1726,9 @@ qemuDomainObjPrivateDataClear(qemuDomainObjPrivatePtr priv)
     virPerfFree(priv->perf);
     priv->perf = NULL;
 
+    g_clear_pointer(&priv->kvmStats, virKVMStatsFree);
+    priv->kvmStatsUnavailable = false;
+
     VIR_FREE(priv->machineName);
 
     virObjectUnref(priv->qemuCaps);
@@ -1743,6 +1746,12 @@ qemuDomainObjPrivateDataClear(qemuDomainObjPrivatePtr priv)
     priv->autoNodeset = NULL;
     virBitmapFree(priv->autoCpuset);
     priv->autoCpuset = NULL;
+    VIR_FREE(priv->numaVcpus);
+    priv->nnumaVcpus = 0;
+    qemuHugepagesItemsFree(priv->hugepages, priv->nhugepages);
+    priv->hugepages = NULL;
+    priv->nhugepages = 0;
+    priv->hugepagesPending = false;
 
     /* remove address data */
     virDomainPCIAddressSetFree(priv->pciaddrs);
@@ -6656,6 +6665,8 @@ qemuDomainSnapshotForEachQcow2Raw(virQEMUDriverPtr driver,
 
         virCommandAddArg(cmd, virDomainDiskGetSource(def->disks[i]));
 
+        virStorageFileMetadataCacheInvalidate(virDomainDiskGetSource(def->disks[i]));
+
         if (virCommandRun(cmd, NULL) < 0) {
             if (try_all) {
                 VIR_WARN("skipping snapshot action on %s",
@@ -25,6 +25,7 @@
 #include "virthread.h"
 #include "vircgroup.h"
 #include "virperf.h"
+#include "virkvmstats.h"
 #include "domain_addr.h"
 #include "domain_conf.h"
 #include "snapshot_conf.h"
@@ -33,6 +34,7 @@
 #include "qemu_blockjob.h"
 #include "qemu_domainjob.h"
 #include "qemu_conf.h"
+#include "qemu_hugepages.h"
 #include "qemu_capabilities.h"
 #include "qemu_migration_params.h"
 #include "qemu_slirp.h"
@@ -135,10 +137,16 @@ struct _qemuDomainObjPrivate {
 
     qemuDomainJobObj job;
 
+    /* Time spent in the phases of the last start */
+    qemuDomainStartStats startStats;
+
     virBitmapPtr namespaces;
 
     virEventThread *eventThread;
 
+    /* Pressure stall triggers, indexed by virDomainPressureResource */
+    GSource *pressureWatch[VIR_DOMAIN_PRESSURE_RESOURCE_LAST];
+
     qemuMonitorPtr mon;
     virDomainChrSourceDefPtr monConfig;
     bool monError;
@@ -179,6 +187,9 @@ struct _qemuDomainObjPrivate {
 
     virPerfPtr perf;
 
+    virKVMStatsPtr kvmStats;
+    bool kvmStatsUnavailable; /* virKVMStatsNew failed, don't retry */
+
     qemuDomainUnpluggingDevice unplug;
 
     char **qemuDevices; /* NULL-terminated list of devices aliases known to QEMU */
@@ -189,6 +200,16 @@ struct _qemuDomainObjPrivate {
     virBitmapPtr autoNodeset;
     virBitmapPtr autoCpuset;
 
+    /* vCPUs accounted to each host NUMA node, indexed by node */
+    unsigned int *numaVcpus;
+    size_t nnumaVcpus;
+
+    /* Huge pages backing the memory of the domain, accounted to
+     * driver->hugepageLedger while the domain runs */
+    qemuHugepagesItemPtr hugepages;
+    size_t nhugepages;
+    bool hugepagesPending;
+
     bool signalIOError; /* true if the domain condition should be signalled on
                            I/O error */
     bool signalStop; /* true if the domain condition should be signalled on
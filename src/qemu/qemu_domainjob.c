@@ -63,6 +63,22 @@ VIR_ENUM_IMPL(qemuDomainAsyncJob,
               "backup",
 );
 
+VIR_ENUM_IMPL(qemuDomainStartPhase,
+              QEMU_DOMAIN_START_PHASE_LAST,
+              "init",
+              "prepare_domain",
+              "prepare_host",
+              "command_line",
+              "exec",
+              "namespace",
+              "cgroup",
+              "label",
+              "monitor",
+              "setup",
+              "refresh",
+              "finish",
+);
+
 const char *
 qemuDomainAsyncJobPhaseToString(qemuDomainAsyncJob job,
                                 int phase G_GNUC_UNUSED)
@@ -376,6 +392,7 @@ qemuDomainJobInfoToInfo(qemuDomainJobInfoPtr jobInfo,
         info->fileRemaining = info->fileTotal - info->fileProcessed;
         break;
 
+    case QEMU_DOMAIN_JOB_STATS_TYPE_START:
     case QEMU_DOMAIN_JOB_STATS_TYPE_NONE:
         break;
     }
@@ -665,6 +682,42 @@ qemuDomainBackupJobInfoToParams(qemuDomainJobInfoPtr jobInfo,
 }
 
 
+static int
+qemuDomainStartJobInfoToParams(qemuDomainJobInfoPtr jobInfo,
+                               int *type,
+                               virTypedParameterPtr *params,
+                               int *nparams)
+{
+    qemuDomainStartStats *stats = &jobInfo->stats.start;
+    g_autoptr(virTypedParamList) par = g_new0(virTypedParamList, 1);
+    size_t i;
+
+    if (virTypedParamListAddInt(par, jobInfo->operation,
+                                VIR_DOMAIN_JOB_OPERATION) < 0)
+        return -1;
+
+    if (virTypedParamListAddULLong(par, jobInfo->timeElapsed,
+                                   VIR_DOMAIN_JOB_TIME_ELAPSED) < 0)
+        return -1;
+
+    for (i = 0; i < QEMU_DOMAIN_START_PHASE_LAST; i++) {
+        if (virTypedParamListAddULLong(par, stats->phases[i], "start_time_%s",
+                                       qemuDomainStartPhaseTypeToString(i)) < 0)
+            return -1;
+    }
+
+    if (jobInfo->status != QEMU_DOMAIN_JOB_STATUS_ACTIVE &&
+        virTypedParamListAddBoolean(par,
+                                    jobInfo->status == QEMU_DOMAIN_JOB_STATUS_COMPLETED,
+                                    VIR_DOMAIN_JOB_SUCCESS) < 0)
+        return -1;
+
+    *nparams = virTypedParamListStealParams(par, params);
+    *type = qemuDomainJobStatusToType(jobInfo->status);
+    return 0;
+}
+
+
 int
 qemuDomainJobInfoToParams(qemuDomainJobInfoPtr jobInfo,
                           int *type,
@@ -682,6 +735,9 @@ qemuDomainJobInfoToParams(qemuDomainJobInfoPtr jobInfo,
     case QEMU_DOMAIN_JOB_STATS_TYPE_BACKUP:
         return qemuDomainBackupJobInfoToParams(jobInfo, type, params, nparams);
 
+    case QEMU_DOMAIN_JOB_STATS_TYPE_START:
+        return qemuDomainStartJobInfoToParams(jobInfo, type, params, nparams);
+
     case QEMU_DOMAIN_JOB_STATS_TYPE_NONE:
         virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
                        _("invalid job statistics type"));
@@ -97,6 +97,7 @@ typedef enum {
     QEMU_DOMAIN_JOB_STATS_TYPE_SAVEDUMP,
     QEMU_DOMAIN_JOB_STATS_TYPE_MEMDUMP,
     QEMU_DOMAIN_JOB_STATS_TYPE_BACKUP,
+    QEMU_DOMAIN_JOB_STATS_TYPE_START,
 } qemuDomainJobStatsType;
 
 
@@ -107,6 +108,31 @@ struct _qemuDomainMirrorStats {
     unsigned long long total;
 };
 
+/* Phases of starting a domain, see qemuProcessStart */
+typedef enum {
+    QEMU_DOMAIN_START_PHASE_INIT = 0,
+    QEMU_DOMAIN_START_PHASE_PREPARE_DOMAIN,
+    QEMU_DOMAIN_START_PHASE_PREPARE_HOST,
+    QEMU_DOMAIN_START_PHASE_COMMAND_LINE,
+    QEMU_DOMAIN_START_PHASE_EXEC,
+    QEMU_DOMAIN_START_PHASE_NAMESPACE,
+    QEMU_DOMAIN_START_PHASE_CGROUP,
+    QEMU_DOMAIN_START_PHASE_LABEL,
+    QEMU_DOMAIN_START_PHASE_MONITOR,
+    QEMU_DOMAIN_START_PHASE_SETUP,
+    QEMU_DOMAIN_START_PHASE_REFRESH,
+    QEMU_DOMAIN_START_PHASE_FINISH,
+
+    QEMU_DOMAIN_START_PHASE_LAST
+} qemuDomainStartPhase;
+VIR_ENUM_DECL(qemuDomainStartPhase);
+
+typedef struct _qemuDomainStartStats qemuDomainStartStats;
+struct _qemuDomainStartStats {
+    unsigned long long phases[QEMU_DOMAIN_START_PHASE_LAST]; /* in ms */
+    unsigned long long mark; /* when the last phase ended */
+};
+
 typedef struct _qemuDomainBackupStats qemuDomainBackupStats;
 struct _qemuDomainBackupStats {
     unsigned long long transferred;
@@ -140,6 +166,7 @@ struct _qemuDomainJobInfo {
         qemuMonitorMigrationStats mig;
         qemuMonitorDumpStats dump;
         qemuDomainBackupStats backup;
+        qemuDomainStartStats start;
     } stats;
     qemuDomainMirrorStats mirrorStats;
 
@@ -51,6 +51,7 @@
 #include "qemu_checkpoint.h"
 #include "qemu_backup.h"
 #include "qemu_namespace.h"
+#include "qemu_resctrl.h"
 #include "qemu_saveimage.h"
 #include "qemu_snapshot.h"
 
@@ -60,6 +61,7 @@
 #include "virbuffer.h"
 #include "virhostcpu.h"
 #include "virhostmem.h"
+#include "virhoststats.h"
 #include "virnetdevtap.h"
 #include "virnetdevopenvswitch.h"
 #include "capabilities.h"
@@ -177,6 +179,8 @@ qemuAutostartDomain(virDomainObjPtr vm,
     virQEMUDriverPtr driver = opaque;
     int flags = 0;
     g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    unsigned long long then = 0;
+    unsigned long long now = 0;
     int ret = -1;
 
     if (cfg->autoStartBypassCache)
@@ -187,6 +191,8 @@ qemuAutostartDomain(virDomainObjPtr vm,
     virResetLastError();
     if (vm->autostart &&
         !virDomainObjIsActive(vm)) {
+        ignore_value(virTimeMillisNow(&then));
+
         if (qemuProcessBeginJob(driver, vm,
                                 VIR_DOMAIN_JOB_OPERATION_START, flags) < 0) {
             virReportError(VIR_ERR_INTERNAL_ERROR,
@@ -203,6 +209,9 @@ qemuAutostartDomain(virDomainObjPtr vm,
         }
 
         qemuProcessEndJob(driver, vm);
+
+        ignore_value(virTimeMillisNow(&now));
+        VIR_DEBUG("Autostart of VM '%s' took %llu ms", vm->def->name, now - then);
     }
 
     ret = 0;
@@ -212,10 +221,299 @@ qemuAutostartDomain(virDomainObjPtr vm,
 }
 
 
+typedef enum {
+    QEMU_AUTOSTART_CONNECT_NETWORK = 1 << 0,
+    QEMU_AUTOSTART_CONNECT_NWFILTER = 1 << 1,
+    QEMU_AUTOSTART_CONNECT_STORAGE = 1 << 2,
+} qemuAutostartConnect;
+
+
+typedef struct _qemuAutostartData qemuAutostartData;
+typedef qemuAutostartData *qemuAutostartDataPtr;
+struct _qemuAutostartData {
+    virQEMUDriverPtr driver;
+
+    virDomainObjPtr *vms;
+    size_t nvms;
+
+    /* Connections to secondary drivers worth opening just once per
+     * worker, a mask of qemuAutostartConnect */
+    unsigned int connect;
+
+    virMutex lock;
+    virCond cond; /* signalled whenever a domain finished starting */
+
+    /* The following is protected by @lock */
+    size_t next; /* the next domain to start */
+    size_t nstarting; /* the number of domains being started */
+    /* Memory (in KiB) claimed by domains being started, 0 for the others,
+     * and the size of pages (in KiB) the memory is claimed in */
+    unsigned long long *claimMem;
+    unsigned int *claimPageSize;
+};
+
+
+static void
+qemuAutostartGetMemoryDemand(virQEMUDriverPtr driver,
+                             virDomainObjPtr vm,
+                             char **name,
+                             unsigned int *pagesize,
+                             unsigned long long *mem)
+{
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    virDomainDefPtr def;
+
+    virObjectLock(vm);
+    def = vm->def;
+
+    *name = g_strdup(def->name);
+    *pagesize = virGetSystemPageSizeKB();
+    *mem = virDomainDefGetMemoryTotal(def);
+
+    /* Domains with different page sizes per guest NUMA node are accounted
+     * in the page size of the first node. */
+    if (def->mem.nhugepages > 0) {
+        virHugeTLBFSPtr fs;
+
+        if (def->mem.hugepages[0].size)
+            *pagesize = def->mem.hugepages[0].size;
+        else if ((fs = virFileGetDefaultHugepage(cfg->hugetlbfs, cfg->nhugetlbfs)))
+            *pagesize = fs->size;
+    }
+
+    virObjectUnlock(vm);
+}
+
+
+/**
+ * qemuAutostartAdmit:
+ * @data: autostart data
+ * @idx: index of domain to be started
+ *
+ * Waits until there's enough free memory on the host for the domain to
+ * start, considering memory claimed by the domains which are being
+ * started at the same time, and then claims memory for the domain. If
+ * no other domain is being started, the domain is admitted regardless
+ * of how much memory is free. Must be called with @data->lock held.
+ */
+static void
+qemuAutostartAdmit(qemuAutostartDataPtr data,
+                   size_t idx)
+{
+    g_autofree char *name = NULL;
+    unsigned int pagesize;
+    unsigned long long mem;
+
+    qemuAutostartGetMemoryDemand(data->driver, data->vms[idx],
+                                 &name, &pagesize, &mem);
+
+    while (data->nstarting > 0) {
+        unsigned long long pagesFree;
+        unsigned long long claimed = 0;
+        size_t i;
+
+        if (virNumaGetPageInfo(-1, pagesize, 0, NULL, &pagesFree) < 0) {
+            /* Can't tell, don't hold the domain back */
+            virResetLastError();
+            break;
+        }
+
+        for (i = 0; i < data->nvms; i++) {
+            if (data->claimPageSize[i] == pagesize)
+                claimed += data->claimMem[i];
+        }
+
+        if (pagesFree * pagesize >= claimed + mem)
+            break;
+
+        VIR_DEBUG("Delaying autostart of VM '%s': needs %llu KiB in %u KiB "
+                  "pages, %llu KiB free, %llu KiB claimed",
+                  name, mem, pagesize, pagesFree * pagesize, claimed);
+
+        if (virCondWait(&data->cond, &data->lock) < 0)
+            break;
+    }
+
+    data->claimMem[idx] = mem;
+    data->claimPageSize[idx] = pagesize;
+    data->nstarting++;
+}
+
+
+static virConnectPtr
+qemuAutostartCacheConnect(virConnectPtr (*getConnect)(void),
+                          int (*setConnect)(virConnectPtr))
+{
+    virConnectPtr conn;
+
+    /* Domains which need the connection will report the error */
+    if (!(conn = getConnect())) {
+        virResetLastError();
+        return NULL;
+    }
+
+    if (setConnect(conn) < 0) {
+        virResetLastError();
+        virObjectUnref(conn);
+        return NULL;
+    }
+
+    return conn;
+}
+
+
+static void
+qemuAutostartUncacheConnect(virConnectPtr conn,
+                            int (*setConnect)(virConnectPtr))
+{
+    if (!conn)
+        return;
+
+    ignore_value(setConnect(NULL));
+    virObjectUnref(conn);
+}
+
+
+static void
+qemuAutostartWorker(void *opaque)
+{
+    qemuAutostartDataPtr data = opaque;
+    virConnectPtr netConn = NULL;
+    virConnectPtr nwfilterConn = NULL;
+    virConnectPtr storageConn = NULL;
+
+    /* Opening connections to other drivers is not free, especially with
+     * split daemons. Open those the domains need once and let all the
+     * domains started by this thread share them. */
+    if (data->connect & QEMU_AUTOSTART_CONNECT_NETWORK)
+        netConn = qemuAutostartCacheConnect(virGetConnectNetwork,
+                                            virSetConnectNetwork);
+    if (data->connect & QEMU_AUTOSTART_CONNECT_NWFILTER)
+        nwfilterConn = qemuAutostartCacheConnect(virGetConnectNWFilter,
+                                                 virSetConnectNWFilter);
+    if (data->connect & QEMU_AUTOSTART_CONNECT_STORAGE)
+        storageConn = qemuAutostartCacheConnect(virGetConnectStorage,
+                                                virSetConnectStorage);
+
+    virMutexLock(&data->lock);
+    while (data->next < data->nvms) {
+        size_t idx = data->next++;
+
+        qemuAutostartAdmit(data, idx);
+        virMutexUnlock(&data->lock);
+
+        qemuAutostartDomain(data->vms[idx], data->driver);
+
+        virMutexLock(&data->lock);
+        data->claimMem[idx] = 0;
+        data->nstarting--;
+        virCondBroadcast(&data->cond);
+    }
+    virMutexUnlock(&data->lock);
+
+    qemuAutostartUncacheConnect(storageConn, virSetConnectStorage);
+    qemuAutostartUncacheConnect(nwfilterConn, virSetConnectNWFilter);
+    qemuAutostartUncacheConnect(netConn, virSetConnectNetwork);
+}
+
+
+static unsigned int
+qemuAutostartGetConnect(virDomainObjPtr vm)
+{
+    virDomainDefPtr def = vm->def;
+    unsigned int connect = 0;
+    size_t i;
+
+    for (i = 0; i < def->nnets; i++) {
+        if (def->nets[i]->type == VIR_DOMAIN_NET_TYPE_NETWORK)
+            connect |= QEMU_AUTOSTART_CONNECT_NETWORK;
+        if (def->nets[i]->filter)
+            connect |= QEMU_AUTOSTART_CONNECT_NWFILTER;
+    }
+
+    for (i = 0; i < def->ndisks; i++) {
+        if (def->disks[i]->src->type == VIR_STORAGE_TYPE_VOLUME)
+            connect |= QEMU_AUTOSTART_CONNECT_STORAGE;
+    }
+
+    return connect;
+}
+
+
 static void
 qemuAutostartDomains(virQEMUDriverPtr driver)
 {
-    virDomainObjListForEach(driver->domains, false, qemuAutostartDomain, driver);
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    qemuAutostartData data = { 0 };
+    g_autofree virThread *workers = NULL;
+    size_t nworkers;
+    size_t nthreads = 0;
+    unsigned long long then = 0;
+    unsigned long long now = 0;
+    size_t i;
+
+    if (virDomainObjListCollect(driver->domains, NULL, &data.vms, &data.nvms,
+                                NULL, VIR_CONNECT_LIST_DOMAINS_AUTOSTART |
+                                VIR_CONNECT_LIST_DOMAINS_INACTIVE) < 0)
+        return;
+
+    if (data.nvms == 0)
+        goto cleanup;
+
+    if (virMutexInit(&data.lock) < 0) {
+        VIR_ERROR(_("Unable to init mutex, not autostarting domains"));
+        goto cleanup;
+    }
+
+    if (virCondInit(&data.cond) < 0) {
+        VIR_ERROR(_("Unable to init condition, not autostarting domains"));
+        virMutexDestroy(&data.lock);
+        goto cleanup;
+    }
+
+    data.driver = driver;
+    data.claimMem = g_new0(unsigned long long, data.nvms);
+    data.claimPageSize = g_new0(unsigned int, data.nvms);
+
+    for (i = 0; i < data.nvms; i++) {
+        virObjectLock(data.vms[i]);
+        data.connect |= qemuAutostartGetConnect(data.vms[i]);
+        virObjectUnlock(data.vms[i]);
+    }
+
+    ignore_value(virTimeMillisNow(&then));
+
+    /* The calling thread is a worker too */
+    nworkers = MIN(cfg->autoStartParallel, data.nvms) - 1;
+    workers = g_new0(virThread, nworkers);
+
+    for (i = 0; i < nworkers; i++) {
+        if (virThreadCreateFull(&workers[i], true, qemuAutostartWorker,
+                                "qemu-autostart", false, &data) < 0) {
+            VIR_WARN("Failed to start autostart worker, continuing with %zu",
+                     nthreads + 1);
+            virResetLastError();
+            break;
+        }
+        nthreads++;
+    }
+
+    qemuAutostartWorker(&data);
+
+    for (i = 0; i < nthreads; i++)
+        virThreadJoin(&workers[i]);
+
+    ignore_value(virTimeMillisNow(&now));
+    VIR_DEBUG("Autostarting %zu VMs using %zu threads took %llu ms",
+              data.nvms, nthreads + 1, now - then);
+
+    virCondDestroy(&data.cond);
+    virMutexDestroy(&data.lock);
+
+ cleanup:
+    g_free(data.claimMem);
+    g_free(data.claimPageSize);
+    virObjectListFreeCount(data.vms, data.nvms);
 }
 
 
@@ -770,6 +1068,9 @@ qemuStateInitialize(bool privileged,
     if (!(qemu_driver->sharedDevices = virHashNew(qemuSharedDeviceEntryFree)))
         goto error;
 
+    if (!(qemu_driver->hugepageLedger = qemuHugepageLedgerNew()))
+        goto error;
+
     if (qemuMigrationDstErrorInit(qemu_driver) < 0)
         goto error;
 
@@ -962,6 +1263,9 @@ qemuStateInitialize(bool privileged,
 
     qemuProcessReconnectAll(qemu_driver);
 
+    if (qemuResctrlTuneStart(qemu_driver) < 0)
+        goto error;
+
     if (virDriverShouldAutostart(cfg->stateDir, &autostart) < 0)
         goto error;
 
@@ -1109,7 +1413,9 @@ qemuStateCleanup(void)
     if (!qemu_driver)
         return -1;
 
+    qemuResctrlTuneStop(qemu_driver);
     virObjectUnref(qemu_driver->migrationErrors);
+    VIR_FREE(qemu_driver->numaVcpus);
     virObjectUnref(qemu_driver->closeCallbacks);
     virLockManagerPluginUnref(qemu_driver->lockManager);
     virSysinfoDefFree(qemu_driver->hostsysinfo);
@@ -1117,6 +1423,7 @@ qemuStateCleanup(void)
     virPortAllocatorRangeFree(qemu_driver->webSocketPorts);
     virPortAllocatorRangeFree(qemu_driver->remotePorts);
     virHashFree(qemu_driver->sharedDevices);
+    qemuHugepageLedgerFree(qemu_driver->hugepageLedger);
     virObjectUnref(qemu_driver->hostdevMgr);
     virObjectUnref(qemu_driver->securityManager);
     virObjectUnref(qemu_driver->domainEventState);
@@ -8958,6 +9265,223 @@ qemuDomainGetNumaParameters(virDomainPtr dom,
     return ret;
 }
 
+
+/* Sum of @memory on nodes which are not in @nodeset */
+static unsigned long long
+qemuDomainNumaMemoryOutside(const unsigned long long *memory,
+                            size_t nmemory,
+                            virBitmapPtr nodeset)
+{
+    unsigned long long ret = 0;
+    size_t i;
+
+    for (i = 0; i < nmemory; i++) {
+        if (!virBitmapIsBitSet(nodeset, i))
+            ret += memory[i];
+    }
+
+    return ret;
+}
+
+
+static int
+qemuDomainMoveNumaNodes(virDomainPtr dom,
+                        const char *nodeset,
+                        virTypedParameterPtr *params,
+                        int *nparams,
+                        unsigned int flags)
+{
+    virQEMUDriverPtr driver = dom->conn->privateData;
+    g_autoptr(virQEMUDriverConfig) cfg = NULL;
+    g_autoptr(virTypedParamList) list = NULL;
+    g_autoptr(virBitmap) nodes = NULL;
+    g_autoptr(virBitmap) others = NULL;
+    g_autoptr(virBitmap) oldMems = NULL;
+    g_autofree unsigned long long *before = NULL;
+    g_autofree unsigned long long *after = NULL;
+    g_autofree char *mems = NULL;
+    size_t nbefore = 0;
+    size_t nafter = 0;
+    unsigned long long outsideBefore;
+    unsigned long long outsideAfter;
+    unsigned long long start;
+    virDomainObjPtr vm = NULL;
+    qemuDomainObjPrivatePtr priv;
+    virErrorPtr orig_err = NULL;
+    virDomainNumatuneMemMode mode;
+    size_t i;
+    int ret = -1;
+
+    virCheckFlags(0, -1);
+
+    if (virBitmapParse(nodeset, &nodes, VIR_DOMAIN_CPUMASK_LEN) < 0)
+        return -1;
+
+    if (virBitmapIsAllClear(nodes)) {
+        virReportError(VIR_ERR_INVALID_ARG,
+                       _("Invalid nodeset: %s"), nodeset);
+        return -1;
+    }
+
+    if (!(vm = qemuDomainObjFromDomain(dom)))
+        return -1;
+
+    priv = vm->privateData;
+    cfg = virQEMUDriverGetConfig(driver);
+
+    if (virDomainMoveNumaNodesEnsureACL(dom->conn, vm->def) < 0)
+        goto cleanup;
+
+    if (qemuDomainObjBeginJob(driver, vm, QEMU_JOB_MODIFY) < 0)
+        goto cleanup;
+
+    if (virDomainObjCheckActive(vm) < 0)
+        goto endjob;
+
+    if (!driver->privileged) {
+        virReportError(VIR_ERR_OPERATION_UNSUPPORTED, "%s",
+                       _("NUMA tuning is not available in session mode"));
+        goto endjob;
+    }
+
+    if (!virCgroupHasController(priv->cgroup, VIR_CGROUP_CONTROLLER_CPUSET)) {
+        virReportError(VIR_ERR_OPERATION_INVALID, "%s",
+                       _("cgroup cpuset controller is not mounted"));
+        goto endjob;
+    }
+
+    if (virDomainNumatuneGetMode(vm->def->numa, -1, &mode) == 0 &&
+        mode != VIR_DOMAIN_NUMATUNE_MEM_STRICT) {
+        virReportError(VIR_ERR_OPERATION_INVALID, "%s",
+                       _("change of nodeset for running domain "
+                         "requires strict numa mode"));
+        goto endjob;
+    }
+
+    if (!virNumaNodesetIsAvailable(nodes))
+        goto endjob;
+
+    if (virDomainNumatuneHasPerNodeBinding(vm->def->numa)) {
+        virReportError(VIR_ERR_OPERATION_UNSUPPORTED, "%s",
+                       _("can't move domain with guest NUMA nodes bound "
+                         "to host nodes"));
+        goto endjob;
+    }
+
+    /* Explicit pinning of individual threads would have to be thrown
+     * away, let the user deal with it instead. */
+    if (vm->def->cputune.emulatorpin) {
+        virReportError(VIR_ERR_OPERATION_UNSUPPORTED, "%s",
+                       _("can't move domain with pinned emulator threads"));
+        goto endjob;
+    }
+
+    for (i = 0; i < virDomainDefGetVcpusMax(vm->def); i++) {
+        if (virDomainDefGetVcpu(vm->def, i)->cpumask) {
+            virReportError(VIR_ERR_OPERATION_UNSUPPORTED, "%s",
+                           _("can't move domain with pinned vCPUs"));
+            goto endjob;
+        }
+    }
+
+    for (i = 0; i < vm->def->niothreadids; i++) {
+        if (vm->def->iothreadids[i]->cpumask) {
+            virReportError(VIR_ERR_OPERATION_UNSUPPORTED, "%s",
+                           _("can't move domain with pinned I/O threads"));
+            goto endjob;
+        }
+    }
+
+    if (virNumaGetProcessNodeMemory(vm->pid, &before, &nbefore) < 0)
+        goto endjob;
+
+    start = g_get_monotonic_time();
+
+    /* The new nodes have to be allowed in the domain cgroup before its
+     * children can use them. qemuDomainSetNumaParamsLive narrows it
+     * down again afterwards. */
+    if (virCgroupGetCpusetMems(priv->cgroup, &mems) < 0)
+        goto endjob;
+
+    if (*mems) {
+        g_autoptr(virBitmap) allowed = NULL;
+        g_autofree char *allowedStr = NULL;
+
+        if (virBitmapParse(mems, &oldMems, VIR_DOMAIN_CPUMASK_LEN) < 0 ||
+            !(allowed = virBitmapNewCopy(oldMems)) ||
+            virBitmapUnion(allowed, nodes) < 0 ||
+            !(allowedStr = virBitmapFormat(allowed)))
+            goto endjob;
+
+        if (virCgroupSetCpusetMems(priv->cgroup, allowedStr) < 0)
+            goto endjob;
+    }
+
+    if (qemuDomainSetNumaParamsLive(vm, nodes) < 0 ||
+        qemuProcessRepinNUMA(driver, vm, nodes) < 0) {
+        /* Put the domain and its threads back onto the nodes they were
+         * allowed to use before. */
+        virErrorPreserveLast(&orig_err);
+        if (oldMems) {
+            if (qemuDomainSetNumaParamsLive(vm, oldMems) < 0)
+                VIR_WARN("Unable to restore memory nodes of domain %s",
+                         vm->def->name);
+            if (virCgroupSetCpusetMems(priv->cgroup, mems) < 0)
+                VIR_WARN("Unable to restore cpuset.mems of domain %s",
+                         vm->def->name);
+        }
+        virErrorRestore(&orig_err);
+        goto endjob;
+    }
+
+    /* Changing cpuset.mems migrates the pages charged to the cgroups,
+     * catch whatever was left behind. */
+    others = virBitmapNew(nbefore);
+    for (i = 0; i < nbefore; i++) {
+        if (before[i] && !virBitmapIsBitSet(nodes, i))
+            ignore_value(virBitmapSetBit(others, i));
+    }
+
+    if (!virBitmapIsAllClear(others) &&
+        virNumaMigratePages(vm->pid, others, nodes) < 0) {
+        VIR_WARN("Unable to move remaining memory of domain %s: %s",
+                 vm->def->name, virGetLastErrorMessage());
+        virResetLastError();
+    }
+
+    if (virDomainObjSave(vm, driver->xmlopt, cfg->stateDir) < 0)
+        goto endjob;
+
+    if (virNumaGetProcessNodeMemory(vm->pid, &after, &nafter) < 0)
+        goto endjob;
+
+    outsideBefore = qemuDomainNumaMemoryOutside(before, nbefore, nodes);
+    outsideAfter = qemuDomainNumaMemoryOutside(after, nafter, nodes);
+
+    list = g_new0(virTypedParamList, 1);
+
+    if (virTypedParamListAddULLong(list,
+                                   outsideBefore > outsideAfter ?
+                                   outsideBefore - outsideAfter : 0,
+                                   "%s", VIR_DOMAIN_NUMA_MOVE_BYTES) < 0 ||
+        virTypedParamListAddULLong(list, outsideAfter,
+                                   "%s", VIR_DOMAIN_NUMA_MOVE_REMAINING) < 0 ||
+        virTypedParamListAddULLong(list,
+                                   (g_get_monotonic_time() - start) / 1000,
+                                   "%s", VIR_DOMAIN_NUMA_MOVE_TIME) < 0)
+        goto endjob;
+
+    *nparams = virTypedParamListStealParams(list, params);
+    ret = 0;
+
+ endjob:
+    qemuDomainObjEndJob(driver, vm);
+
+ cleanup:
+    virDomainObjEndAPI(&vm);
+    return ret;
+}
+
 static int
 qemuSetGlobalBWLive(virCgroupPtr cgroup, unsigned long long period,
                     long long quota)
@@ -12725,6 +13249,7 @@ qemuDomainGetJobStatsInternal(virQEMUDriverPtr driver,
             goto cleanup;
         break;
 
+    case QEMU_DOMAIN_JOB_STATS_TYPE_START:
     case QEMU_DOMAIN_JOB_STATS_TYPE_NONE:
         break;
     }
@@ -17101,6 +17626,26 @@ qemuNodeGetMemoryStats(virConnectPtr conn,
 }
 
 
+static int
+qemuNodeGetAllStats(virConnectPtr conn,
+                    virTypedParameterPtr *params,
+                    int *nparams,
+                    unsigned int flags)
+{
+    g_autoptr(virHostStats) stats = NULL;
+
+    virCheckFlags(0, -1);
+
+    if (virNodeGetAllStatsEnsureACL(conn) < 0)
+        return -1;
+
+    if (!(stats = virHostStatsNew()))
+        return -1;
+
+    return virHostStatsFormatParams(stats, params, nparams);
+}
+
+
 static int
 qemuNodeGetCellsFreeMemory(virConnectPtr conn,
                            unsigned long long *freeMems,
@@ -17922,11 +18467,10 @@ qemuDomainGetStatsCpuCgroup(virDomainObjPtr dom,
     if (!priv->cgroup)
         return 0;
 
-    err = virCgroupGetCpuacctUsage(priv->cgroup, &cpu_time);
+    err = virCgroupGetCpuacctTimes(priv->cgroup, &cpu_time,
+                                   &user_time, &sys_time);
     if (!err && virTypedParamListAddULLong(params, cpu_time, "cpu.time") < 0)
         return -1;
-
-    err = virCgroupGetCpuacctStat(priv->cgroup, &user_time, &sys_time);
     if (!err && virTypedParamListAddULLong(params, user_time, "cpu.user") < 0)
         return -1;
     if (!err && virTypedParamListAddULLong(params, sys_time, "cpu.system") < 0)
@@ -18616,6 +19160,329 @@ qemuDomainGetStatsPerf(virQEMUDriverPtr driver G_GNUC_UNUSED,
     return 0;
 }
 
+
+static int
+qemuDomainGetStatsPerfVcpuRates(virPerfVcpuSamplePtr cur,
+                                virPerfVcpuSamplePtr prev,
+                                unsigned int vcpu,
+                                virTypedParamListPtr params)
+{
+    virPerfVcpuRates rates;
+
+    virPerfVcpuComputeRates(cur, prev, &rates);
+
+    if (rates.hasIpc &&
+        virTypedParamListAddDouble(params, rates.ipc,
+                                   "perf.vcpu.%u.ipc", vcpu) < 0)
+        return -1;
+
+    if (rates.hasCacheMissesRate &&
+        virTypedParamListAddDouble(params, rates.cacheMissesRate,
+                                   "perf.vcpu.%u.cache_misses_rate",
+                                   vcpu) < 0)
+        return -1;
+
+    if (rates.hasCacheMissRatio &&
+        virTypedParamListAddDouble(params, rates.cacheMissRatio,
+                                   "perf.vcpu.%u.cache_miss_ratio",
+                                   vcpu) < 0)
+        return -1;
+
+    return 0;
+}
+
+
+static int
+qemuDomainGetStatsPerfVcpu(virQEMUDriverPtr driver G_GNUC_UNUSED,
+                           virDomainObjPtr dom,
+                           virTypedParamListPtr params,
+                           unsigned int privflags G_GNUC_UNUSED)
+{
+    qemuDomainObjPrivatePtr priv = dom->privateData;
+    size_t maxvcpus = virDomainDefGetVcpusMax(dom->def);
+    size_t i;
+    size_t j;
+
+    if (!virDomainObjIsActive(dom) || !priv->perf)
+        return 0;
+
+    for (i = 0; i < maxvcpus; i++) {
+        virDomainVcpuDefPtr vcpu = virDomainDefGetVcpu(dom->def, i);
+        pid_t tid = qemuDomainGetVcpuPid(dom, i);
+        virPerfVcpuSample cur;
+        virPerfVcpuSample prev;
+        int rc;
+
+        if (!vcpu->online || tid <= 0)
+            continue;
+
+        if ((rc = virPerfReadVcpu(priv->perf, i, tid, &cur, &prev)) < 0) {
+            /* it's ok to be silent and go ahead */
+            virResetLastError();
+            continue;
+        }
+
+        if (cur.timestamp == 0)
+            continue;
+
+        if (virTypedParamListAddULLong(params, cur.timeEnabled,
+                                       "perf.vcpu.%zu.time_enabled", i) < 0 ||
+            virTypedParamListAddULLong(params, cur.timeRunning,
+                                       "perf.vcpu.%zu.time_running", i) < 0)
+            return -1;
+
+        for (j = 0; j < VIR_PERF_EVENT_LAST; j++) {
+            if (!cur.present[j])
+                continue;
+
+            if (virTypedParamListAddULLong(params, cur.values[j],
+                                           "perf.vcpu.%zu.%s", i,
+                                           virPerfEventTypeToString(j)) < 0)
+                return -1;
+        }
+
+        if (rc > 0 &&
+            qemuDomainGetStatsPerfVcpuRates(&cur, &prev, i, params) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+qemuDomainGetStatsKVMVcpus(virQEMUDriverPtr driver,
+                           virDomainObjPtr dom,
+                           virTypedParamListPtr params)
+{
+    qemuDomainObjPrivatePtr priv = dom->privateData;
+    size_t maxvcpus = virDomainDefGetVcpusMax(dom->def);
+    qemuMonitorVcpuStatsKVMPtr stats = NULL;
+    size_t nstats = 0;
+    size_t i;
+    size_t j;
+    size_t k;
+    int rc;
+    int ret = -1;
+
+    qemuDomainObjEnterMonitor(driver, dom);
+    rc = qemuMonitorGetVcpuStatsKVM(priv->mon, &stats, &nstats);
+    if (qemuDomainObjExitMonitor(driver, dom) < 0)
+        goto cleanup;
+
+    if (rc < 0) {
+        /* it's ok to be silent and go ahead */
+        virResetLastError();
+        ret = 0;
+        goto cleanup;
+    }
+
+    for (i = 0; i < maxvcpus; i++) {
+        virDomainVcpuDefPtr vcpu = virDomainDefGetVcpu(dom->def, i);
+        pid_t tid = qemuDomainGetVcpuPid(dom, i);
+
+        if (!vcpu->online || tid <= 0)
+            continue;
+
+        for (j = 0; j < nstats; j++) {
+            if (stats[j].tid != tid)
+                continue;
+
+            for (k = 0; k < stats[j].nstats; k++) {
+                if (virTypedParamListAddULLong(params, stats[j].values[k],
+                                               "kvm.vcpu.%zu.%s", i,
+                                               stats[j].names[k]) < 0)
+                    goto cleanup;
+            }
+
+            break;
+        }
+    }
+
+    ret = 0;
+
+ cleanup:
+    qemuMonitorVcpuStatsKVMFree(stats, nstats);
+    return ret;
+}
+
+
+static int
+qemuDomainGetStatsKVM(virQEMUDriverPtr driver,
+                      virDomainObjPtr dom,
+                      virTypedParamListPtr params,
+                      unsigned int privflags)
+{
+    qemuDomainObjPrivatePtr priv = dom->privateData;
+    g_autofree virKVMStatsValuePtr values = NULL;
+    size_t nvalues = 0;
+    size_t i;
+
+    if (!virDomainObjIsActive(dom) ||
+        dom->def->virtType != VIR_DOMAIN_VIRT_KVM)
+        return 0;
+
+    /* The per vcpu statistics can only be obtained by QEMU itself */
+    if (virQEMUCapsGet(priv->qemuCaps, QEMU_CAPS_QUERY_STATS)) {
+        if (!HAVE_JOB(privflags))
+            return 0;
+
+        return qemuDomainGetStatsKVMVcpus(driver, dom, params);
+    }
+
+    if (priv->kvmStatsUnavailable)
+        return 0;
+
+    if (!priv->kvmStats &&
+        !(priv->kvmStats = virKVMStatsNew(dom->pid))) {
+        VIR_DEBUG("KVM statistics of domain %s are not available: %s",
+                  dom->def->name, virGetLastErrorMessage());
+        virResetLastError();
+        priv->kvmStatsUnavailable = true;
+        return 0;
+    }
+
+    if (virKVMStatsReadVM(priv->kvmStats, &values, &nvalues) < 0) {
+        virResetLastError();
+        return 0;
+    }
+
+    for (i = 0; i < nvalues; i++) {
+        if (virTypedParamListAddULLong(params, values[i].value,
+                                       "kvm.%s", values[i].name) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+qemuDomainGetStatsCgroupPressureOne(virTypedParamListPtr params,
+                                    const char *resource,
+                                    const char *kind,
+                                    virCgroupPressureStatPtr stat)
+{
+    if (virTypedParamListAddDouble(params, stat->avg10,
+                                   "cgroup.pressure.%s.%s.avg10",
+                                   resource, kind) < 0 ||
+        virTypedParamListAddDouble(params, stat->avg60,
+                                   "cgroup.pressure.%s.%s.avg60",
+                                   resource, kind) < 0 ||
+        virTypedParamListAddDouble(params, stat->avg300,
+                                   "cgroup.pressure.%s.%s.avg300",
+                                   resource, kind) < 0 ||
+        virTypedParamListAddULLong(params, stat->total,
+                                   "cgroup.pressure.%s.%s.total",
+                                   resource, kind) < 0)
+        return -1;
+
+    return 0;
+}
+
+
+static int
+qemuDomainGetStatsCgroupPressure(virCgroupPtr cgroup,
+                                 virTypedParamListPtr params)
+{
+    size_t i;
+
+    for (i = 0; i < VIR_CGROUP_PRESSURE_LAST; i++) {
+        const char *resource = virCgroupPressureResourceTypeToString(i);
+        virCgroupPressure pressure;
+
+        /* Not available with cgroup v1 or without PSI support */
+        if (!virCgroupSupportsPressure(cgroup, i))
+            continue;
+
+        if (virCgroupGetPressure(cgroup, i, &pressure) < 0) {
+            virResetLastError();
+            continue;
+        }
+
+        if (qemuDomainGetStatsCgroupPressureOne(params, resource, "some",
+                                                &pressure.some) < 0)
+            return -1;
+
+        if (pressure.hasFull &&
+            qemuDomainGetStatsCgroupPressureOne(params, resource, "full",
+                                                &pressure.full) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+qemuDomainGetStatsCgroup(virQEMUDriverPtr driver G_GNUC_UNUSED,
+                         virDomainObjPtr dom,
+                         virTypedParamListPtr params,
+                         unsigned int privflags G_GNUC_UNUSED)
+{
+    qemuDomainObjPrivatePtr priv = dom->privateData;
+    unsigned long usage;
+    unsigned long long cache;
+    unsigned long long activeAnon;
+    unsigned long long inactiveAnon;
+    unsigned long long activeFile;
+    unsigned long long inactiveFile;
+    unsigned long long unevictable;
+    long long bytesRead;
+    long long bytesWrite;
+    long long reqsRead;
+    long long reqsWrite;
+
+    if (!virDomainObjIsActive(dom) || !priv->cgroup)
+        return 0;
+
+    if (virCgroupHasController(priv->cgroup, VIR_CGROUP_CONTROLLER_MEMORY)) {
+        if (virCgroupGetMemoryUsage(priv->cgroup, &usage) == 0 &&
+            virTypedParamListAddULLong(params, usage,
+                                       "cgroup.memory.usage") < 0)
+            return -1;
+
+        if (virCgroupGetMemoryStat(priv->cgroup, &cache,
+                                   &activeAnon, &inactiveAnon,
+                                   &activeFile, &inactiveFile,
+                                   &unevictable) == 0) {
+            if (virTypedParamListAddULLong(params, cache,
+                                           "cgroup.memory.cache") < 0 ||
+                virTypedParamListAddULLong(params, activeAnon,
+                                           "cgroup.memory.active_anon") < 0 ||
+                virTypedParamListAddULLong(params, inactiveAnon,
+                                           "cgroup.memory.inactive_anon") < 0 ||
+                virTypedParamListAddULLong(params, activeFile,
+                                           "cgroup.memory.active_file") < 0 ||
+                virTypedParamListAddULLong(params, inactiveFile,
+                                           "cgroup.memory.inactive_file") < 0 ||
+                virTypedParamListAddULLong(params, unevictable,
+                                           "cgroup.memory.unevictable") < 0)
+                return -1;
+        }
+    }
+
+    if (virCgroupHasController(priv->cgroup, VIR_CGROUP_CONTROLLER_BLKIO) &&
+        virCgroupGetBlkioIoServiced(priv->cgroup, &bytesRead, &bytesWrite,
+                                    &reqsRead, &reqsWrite) == 0) {
+        if (virTypedParamListAddLLong(params, bytesRead,
+                                      "cgroup.io.read.bytes") < 0 ||
+            virTypedParamListAddLLong(params, bytesWrite,
+                                      "cgroup.io.write.bytes") < 0 ||
+            virTypedParamListAddLLong(params, reqsRead,
+                                      "cgroup.io.read.reqs") < 0 ||
+            virTypedParamListAddLLong(params, reqsWrite,
+                                      "cgroup.io.write.reqs") < 0)
+            return -1;
+    }
+
+    if (qemuDomainGetStatsCgroupPressure(priv->cgroup, params) < 0)
+        return -1;
+
+    return 0;
+}
+
+
 typedef int
 (*qemuDomainGetStatsFunc)(virQEMUDriverPtr driver,
                           virDomainObjPtr dom,
@@ -18628,6 +19495,10 @@ struct qemuDomainGetStatsWorker {
     bool monitor;
 };
 
+/* Groups that are only returned when asked for, because collecting them
+ * costs resources for every vCPU of every domain queried */
+#define QEMU_DOMAIN_STATS_EXPLICIT VIR_DOMAIN_STATS_PERF_VCPU
+
 static struct qemuDomainGetStatsWorker qemuDomainGetStatsWorkers[] = {
     { qemuDomainGetStatsState, VIR_DOMAIN_STATS_STATE, false },
     { qemuDomainGetStatsCpu, VIR_DOMAIN_STATS_CPU_TOTAL, false },
@@ -18638,6 +19509,9 @@ static struct qemuDomainGetStatsWorker qemuDomainGetStatsWorkers[] = {
     { qemuDomainGetStatsPerf, VIR_DOMAIN_STATS_PERF, false },
     { qemuDomainGetStatsIOThread, VIR_DOMAIN_STATS_IOTHREAD, true },
     { qemuDomainGetStatsMemory, VIR_DOMAIN_STATS_MEMORY, false },
+    { qemuDomainGetStatsCgroup, VIR_DOMAIN_STATS_CGROUP, false },
+    { qemuDomainGetStatsPerfVcpu, VIR_DOMAIN_STATS_PERF_VCPU, false },
+    { qemuDomainGetStatsKVM, VIR_DOMAIN_STATS_KVM, true },
     { NULL, 0, false }
 };
 
@@ -18653,7 +19527,7 @@ qemuDomainGetStatsCheckSupport(unsigned int *stats,
         supportedstats |= qemuDomainGetStatsWorkers[i].stats;
 
     if (*stats == 0) {
-        *stats = supportedstats;
+        *stats = supportedstats & ~QEMU_DOMAIN_STATS_EXPLICIT;
         return 0;
     }
 
@@ -20557,6 +21431,8 @@ static virHypervisorDriver qemuHypervisorDriver = {
     .domainBackupGetXMLDesc = qemuDomainBackupGetXMLDesc, /* 6.0.0 */
     .domainAuthorizedSSHKeysGet = qemuDomainAuthorizedSSHKeysGet, /* 6.10.0 */
     .domainAuthorizedSSHKeysSet = qemuDomainAuthorizedSSHKeysSet, /* 6.10.0 */
+    .domainMoveNumaNodes = qemuDomainMoveNumaNodes, /* 7.1.0 */
+    .nodeGetAllStats = qemuNodeGetAllStats, /* 7.1.0 */
 };
 
 
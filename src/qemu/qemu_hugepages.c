@@ -0,0 +1,794 @@
+/*
+ * qemu_hugepages.c: QEMU huge page reservation and pre-allocation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "qemu_domain.h"
+#define LIBVIRT_QEMU_HUGEPAGESPRIV_H_ALLOW
+#include "qemu_hugepagespriv.h"
+#include "qemu_security.h"
+#include "viralloc.h"
+#include "virerror.h"
+#include "virfile.h"
+#include "virlog.h"
+#include "virnuma.h"
+#include "virstring.h"
+#include "virthread.h"
+
+#define VIR_FROM_THIS VIR_FROM_QEMU
+
+VIR_LOG_INIT("qemu.qemu_hugepages");
+
+#ifndef MADV_POPULATE_WRITE
+# define MADV_POPULATE_WRITE 23
+#endif
+
+/*
+ * With hugepages_reserve set in qemu.conf, the huge pages each running
+ * domain needs are recorded in a ledger per host NUMA node and page size.
+ * A domain is admitted only if, with the ledger lock held, the pages it
+ * needs fit both into the pool not yet promised to other domains and
+ * into the free pages not yet taken by domains still starting up
+ * ("pending" pages, which the kernel doesn't count as used yet).
+ *
+ * With hugepages_prefault_threads set, the backing file of every shared
+ * hugetlbfs memory backend is created and allocated by libvirt on the
+ * right host node before QEMU is started and QEMU is pointed at the file
+ * instead of the hugetlbfs directory.
+ */
+
+typedef struct _qemuHugepageLedgerEntry qemuHugepageLedgerEntry;
+struct _qemuHugepageLedgerEntry {
+    int node;
+    unsigned long long pagesize;
+    unsigned long long reserved; /* pages of running domains */
+    unsigned long long pending;  /* subset of @reserved not allocated yet */
+};
+
+struct _qemuHugepageLedger {
+    virMutex lock;
+
+    qemuHugepageLedgerEntry *entries;
+    size_t nentries;
+};
+
+
+void
+qemuHugepagesItemsFree(qemuHugepagesItemPtr items,
+                       size_t nitems)
+{
+    size_t i;
+
+    for (i = 0; i < nitems; i++) {
+        g_free(items[i].alias);
+        g_free(items[i].path);
+    }
+
+    g_free(items);
+}
+
+
+qemuHugepageLedgerPtr
+qemuHugepageLedgerNew(void)
+{
+    qemuHugepageLedgerPtr ledger = g_new0(qemuHugepageLedger, 1);
+
+    if (virMutexInit(&ledger->lock) < 0) {
+        virReportSystemError(errno, "%s",
+                             _("unable to init huge page ledger mutex"));
+        g_free(ledger);
+        return NULL;
+    }
+
+    return ledger;
+}
+
+
+void
+qemuHugepageLedgerFree(qemuHugepageLedgerPtr ledger)
+{
+    if (!ledger)
+        return;
+
+    virMutexDestroy(&ledger->lock);
+    g_free(ledger->entries);
+    g_free(ledger);
+}
+
+
+static qemuHugepageLedgerEntry *
+qemuHugepageLedgerFind(qemuHugepageLedgerPtr ledger,
+                       int node,
+                       unsigned long long pagesize)
+{
+    qemuHugepageLedgerEntry entry = { .node = node, .pagesize = pagesize };
+    size_t i;
+
+    for (i = 0; i < ledger->nentries; i++) {
+        if (ledger->entries[i].node == node &&
+            ledger->entries[i].pagesize == pagesize)
+            return &ledger->entries[i];
+    }
+
+    ignore_value(VIR_APPEND_ELEMENT(ledger->entries, ledger->nentries, entry));
+    return &ledger->entries[ledger->nentries - 1];
+}
+
+
+/**
+ * qemuHugepageLedgerCheck:
+ * @ledger: locked ledger
+ * @node: host NUMA node, or -1 for the whole host
+ * @pagesize: huge page size in KiB
+ * @count: number of pages needed
+ *
+ * Checks that @count more pages of @pagesize can be handed out on
+ * @node. Pages reserved on any node count against the whole host.
+ *
+ * Returns 0 if they can, -1 otherwise (with error reported).
+ */
+static int
+qemuHugepageLedgerCheck(qemuHugepageLedgerPtr ledger,
+                        int node,
+                        unsigned long long pagesize,
+                        unsigned long long count)
+{
+    g_autofree unsigned int *pageSizes = NULL;
+    g_autofree unsigned long long *pageTotal = NULL;
+    g_autofree unsigned long long *pageFree = NULL;
+    size_t npages = 0;
+    unsigned long long poolTotal = 0;
+    unsigned long long poolFree = 0;
+    unsigned long long reserved = 0;
+    unsigned long long pending = 0;
+    unsigned long long avail;
+    size_t i;
+
+    if (virNumaGetHugePages(node, &pageSizes, &pageTotal,
+                            &pageFree, &npages) < 0)
+        return -1;
+
+    for (i = 0; i < npages; i++) {
+        if (pageSizes[i] == pagesize) {
+            poolTotal = pageTotal[i];
+            poolFree = pageFree[i];
+        }
+    }
+
+    for (i = 0; i < ledger->nentries; i++) {
+        qemuHugepageLedgerEntry *entry = &ledger->entries[i];
+
+        if (entry->pagesize != pagesize ||
+            (node >= 0 && entry->node != node))
+            continue;
+
+        reserved += entry->reserved;
+        pending += entry->pending;
+    }
+
+    avail = MIN(poolTotal > reserved ? poolTotal - reserved : 0,
+                poolFree > pending ? poolFree - pending : 0);
+
+    VIR_DEBUG("node=%d pagesize=%llu count=%llu total=%llu free=%llu "
+              "reserved=%llu pending=%llu",
+              node, pagesize, count, poolTotal, poolFree, reserved, pending);
+
+    if (count > avail) {
+        if (node >= 0) {
+            virReportError(VIR_ERR_OPERATION_FAILED,
+                           _("not enough free huge pages of %llu KiB on host "
+                             "NUMA node %d: %llu needed, %llu available"),
+                           pagesize, node, count, avail);
+        } else {
+            virReportError(VIR_ERR_OPERATION_FAILED,
+                           _("not enough free huge pages of %llu KiB: "
+                             "%llu needed, %llu available"),
+                           pagesize, count, avail);
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/* Sums the pages of @items on @node (or all of them for -1) */
+static unsigned long long
+qemuHugepagesCount(qemuHugepagesItemPtr items,
+                   size_t nitems,
+                   int node,
+                   unsigned long long pagesize)
+{
+    unsigned long long count = 0;
+    size_t i;
+
+    for (i = 0; i < nitems; i++) {
+        if (items[i].pagesize == pagesize &&
+            (node < 0 || items[i].node == node))
+            count += items[i].size / items[i].pagesize;
+    }
+
+    return count;
+}
+
+
+/**
+ * qemuHugepageLedgerAdmit:
+ * @ledger: locked ledger
+ * @items: huge pages a domain needs
+ * @nitems: number of @items
+ *
+ * Checks that @items fit both onto the host NUMA nodes they are bound to
+ * and onto the host as a whole.
+ *
+ * Returns 0 if they do, -1 otherwise (with error reported).
+ */
+int
+qemuHugepageLedgerAdmit(qemuHugepageLedgerPtr ledger,
+                        qemuHugepagesItemPtr items,
+                        size_t nitems)
+{
+    size_t i;
+
+    for (i = 0; i < nitems; i++) {
+        qemuHugepagesItemPtr item = &items[i];
+
+        if (item->node >= 0 &&
+            qemuHugepageLedgerCheck(ledger, item->node, item->pagesize,
+                                    qemuHugepagesCount(items, nitems,
+                                                       item->node,
+                                                       item->pagesize)) < 0)
+            return -1;
+
+        if (qemuHugepageLedgerCheck(ledger, -1, item->pagesize,
+                                    qemuHugepagesCount(items, nitems, -1,
+                                                       item->pagesize)) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * qemuHugepageLedgerUpdate:
+ * @ledger: locked ledger
+ * @items: huge pages of a domain
+ * @nitems: number of @items
+ * @add: whether @items are reserved or returned
+ * @pending: whether @items are not allocated by the kernel yet
+ *
+ * Adds @items to or removes them from the pages recorded in @ledger.
+ */
+void
+qemuHugepageLedgerUpdate(qemuHugepageLedgerPtr ledger,
+                         qemuHugepagesItemPtr items,
+                         size_t nitems,
+                         bool add,
+                         bool pending)
+{
+    size_t i;
+
+    for (i = 0; i < nitems; i++) {
+        qemuHugepageLedgerEntry *entry;
+        unsigned long long count = items[i].size / items[i].pagesize;
+
+        entry = qemuHugepageLedgerFind(ledger, items[i].node,
+                                       items[i].pagesize);
+
+        if (add) {
+            entry->reserved += count;
+            if (pending)
+                entry->pending += count;
+        } else {
+            entry->reserved -= MIN(entry->reserved, count);
+            if (pending)
+                entry->pending -= MIN(entry->pending, count);
+        }
+    }
+}
+
+
+/* Returns the host NUMA node memory of guest NUMA node @cell is bound
+ * to, or -1 if it may be allocated on more than one node. */
+static int
+qemuHugepagesGetNode(virDomainDefPtr def,
+                     virBitmapPtr autoNodeset,
+                     int cell)
+{
+    virDomainNumatuneMemMode mode;
+    virBitmapPtr nodeset;
+
+    if (!virNumaIsAvailable())
+        return -1;
+
+    if (virDomainNumatuneGetMode(def->numa, cell, &mode) < 0)
+        mode = VIR_DOMAIN_NUMATUNE_MEM_STRICT;
+
+    if (mode != VIR_DOMAIN_NUMATUNE_MEM_STRICT)
+        return -1;
+
+    nodeset = virDomainNumatuneGetNodeset(def->numa, autoNodeset, cell);
+
+    if (!nodeset || virBitmapCountBits(nodeset) != 1)
+        return -1;
+
+    return virBitmapNextSetBit(nodeset, -1);
+}
+
+
+static void
+qemuHugepagesAddItem(qemuHugepagesItemPtr *items,
+                     size_t *nitems,
+                     virQEMUDriverConfigPtr cfg,
+                     virDomainObjPtr vm,
+                     const char *alias,
+                     int cell,
+                     unsigned long long pagesize,
+                     unsigned long long size,
+                     virDomainMemoryAccess access)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    qemuHugepagesItem item = { 0 };
+
+    if (pagesize == virGetSystemPageSizeKB())
+        return;
+
+    if (pagesize == 0) {
+        virHugeTLBFSPtr fs;
+
+        if (!cfg->nhugetlbfs)
+            return;
+
+        if (!(fs = virFileGetDefaultHugepage(cfg->hugetlbfs, cfg->nhugetlbfs)))
+            fs = &cfg->hugetlbfs[0];
+
+        pagesize = fs->size;
+    }
+
+    item.node = qemuHugepagesGetNode(vm->def, priv->autoNodeset, cell);
+    item.pagesize = pagesize;
+    item.size = size - size % pagesize;
+
+    /* QEMU maps backing files of private memory copy-on-write, writes
+     * to pages allocated in advance would only double the usage */
+    if (alias &&
+        access == VIR_DOMAIN_MEMORY_ACCESS_SHARED &&
+        vm->def->mem.source != VIR_DOMAIN_MEMORY_SOURCE_MEMFD)
+        item.alias = g_strdup(alias);
+
+    ignore_value(VIR_APPEND_ELEMENT(*items, *nitems, item));
+}
+
+
+/**
+ * qemuHugepagesGetItems:
+ * @cfg: driver config
+ * @vm: domain object
+ * @items: filled with the huge page backed memory of @vm
+ * @nitems: filled with the number of @items
+ *
+ * Collects the huge pages the memory of each guest NUMA node of @vm
+ * (or its whole memory if there are none) needs, the same way
+ * qemuBuildMemoryBackendProps() picks the page size.
+ */
+static void
+qemuHugepagesGetItems(virQEMUDriverConfigPtr cfg,
+                      virDomainObjPtr vm,
+                      qemuHugepagesItemPtr *items,
+                      size_t *nitems)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    virDomainDefPtr def = vm->def;
+    size_t ncells = virDomainNumaGetNodeCount(def->numa);
+    size_t i;
+    size_t j;
+
+    if (!def->mem.nhugepages)
+        return;
+
+    if (ncells == 0) {
+        /* Without a default RAM backend QEMU gets the hugetlbfs
+         * directory through -mem-path */
+        const char *alias = virQEMUCapsGetMachineDefaultRAMid(priv->qemuCaps,
+                                                              def->virtType,
+                                                              def->os.machine);
+
+        qemuHugepagesAddItem(items, nitems, cfg, vm, alias, -1,
+                             def->mem.hugepages[0].size,
+                             virDomainDefGetMemoryInitial(def),
+                             def->mem.access);
+        return;
+    }
+
+    for (i = 0; i < ncells; i++) {
+        virDomainHugePagePtr hugepage = NULL;
+        virDomainMemoryAccess access;
+        g_autofree char *alias = NULL;
+
+        for (j = 0; j < def->mem.nhugepages; j++) {
+            virDomainHugePagePtr tmp = &def->mem.hugepages[j];
+
+            if (!tmp->nodemask) {
+                if (!hugepage)
+                    hugepage = tmp;
+                continue;
+            }
+
+            if (virBitmapIsBitSet(tmp->nodemask, i)) {
+                hugepage = tmp;
+                break;
+            }
+        }
+
+        if (!hugepage)
+            continue;
+
+        access = virDomainNumaGetNodeMemoryAccessMode(def->numa, i);
+        if (access == VIR_DOMAIN_MEMORY_ACCESS_DEFAULT)
+            access = def->mem.access;
+
+        alias = g_strdup_printf("ram-node%zu", i);
+
+        qemuHugepagesAddItem(items, nitems, cfg, vm, alias, i,
+                             hugepage->size,
+                             virDomainNumaGetNodeMemorySize(def->numa, i),
+                             access);
+    }
+}
+
+
+/**
+ * qemuHugepagesReserve:
+ * @driver: qemu driver
+ * @vm: domain object
+ * @reconnect: whether @vm is already running
+ *
+ * Collects the huge pages @vm needs and, if hugepages_reserve is set,
+ * reserves them in the ledger. Unless @reconnect is true, the domain is
+ * refused if there are not enough pages left for it.
+ *
+ * Returns 0 on success, -1 otherwise (with error reported).
+ */
+int
+qemuHugepagesReserve(virQEMUDriverPtr driver,
+                     virDomainObjPtr vm,
+                     bool reconnect)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    qemuHugepageLedgerPtr ledger = driver->hugepageLedger;
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    qemuHugepagesItemPtr items = NULL;
+    size_t nitems = 0;
+    int ret = -1;
+
+    if (priv->hugepages ||
+        (!cfg->hugepagesReserve && !cfg->hugepagesPrefaultThreads))
+        return 0;
+
+    qemuHugepagesGetItems(cfg, vm, &items, &nitems);
+
+    if (nitems == 0)
+        return 0;
+
+    if (!cfg->hugepagesReserve) {
+        priv->hugepages = items;
+        priv->nhugepages = nitems;
+        return 0;
+    }
+
+    virMutexLock(&ledger->lock);
+
+    if (!reconnect &&
+        qemuHugepageLedgerAdmit(ledger, items, nitems) < 0)
+        goto cleanup;
+
+    qemuHugepageLedgerUpdate(ledger, items, nitems, true, !reconnect);
+
+    priv->hugepages = g_steal_pointer(&items);
+    priv->nhugepages = nitems;
+    priv->hugepagesPending = !reconnect;
+    ret = 0;
+
+ cleanup:
+    virMutexUnlock(&ledger->lock);
+    if (ret < 0)
+        qemuHugepagesItemsFree(items, nitems);
+    return ret;
+}
+
+
+/**
+ * qemuHugepagesCommit:
+ * @driver: qemu driver
+ * @vm: domain object
+ *
+ * Marks the huge pages reserved for @vm as allocated, i.e. accounted
+ * as used by the kernel.
+ */
+void
+qemuHugepagesCommit(virQEMUDriverPtr driver,
+                    virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    qemuHugepageLedgerPtr ledger = driver->hugepageLedger;
+    size_t i;
+
+    if (!priv->hugepagesPending)
+        return;
+
+    virMutexLock(&ledger->lock);
+
+    for (i = 0; i < priv->nhugepages; i++) {
+        qemuHugepagesItemPtr item = &priv->hugepages[i];
+        qemuHugepageLedgerEntry *entry;
+        unsigned long long count = item->size / item->pagesize;
+
+        entry = qemuHugepageLedgerFind(ledger, item->node, item->pagesize);
+        entry->pending -= MIN(entry->pending, count);
+    }
+
+    priv->hugepagesPending = false;
+
+    virMutexUnlock(&ledger->lock);
+}
+
+
+/**
+ * qemuHugepagesRelease:
+ * @driver: qemu driver
+ * @vm: domain object
+ *
+ * Returns the huge pages reserved for @vm to the ledger.
+ */
+void
+qemuHugepagesRelease(virQEMUDriverPtr driver,
+                     virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    qemuHugepageLedgerPtr ledger = driver->hugepageLedger;
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+
+    if (!priv->hugepages)
+        return;
+
+    if (cfg->hugepagesReserve) {
+        virMutexLock(&ledger->lock);
+        qemuHugepageLedgerUpdate(ledger, priv->hugepages, priv->nhugepages,
+                                 false, priv->hugepagesPending);
+        virMutexUnlock(&ledger->lock);
+    }
+
+    qemuHugepagesItemsFree(priv->hugepages, priv->nhugepages);
+    priv->hugepages = NULL;
+    priv->nhugepages = 0;
+    priv->hugepagesPending = false;
+}
+
+
+typedef struct _qemuHugepagesPrefaultChunk qemuHugepagesPrefaultChunk;
+struct _qemuHugepagesPrefaultChunk {
+    int fd;
+    char *addr;
+    size_t offset;
+    size_t len;
+    int err;
+};
+
+
+static void
+qemuHugepagesPrefaultWorker(void *opaque)
+{
+    qemuHugepagesPrefaultChunk *chunk = opaque;
+
+    /* Unlike touching the pages, MADV_POPULATE_WRITE reports a lack of
+     * huge pages as an error rather than with SIGBUS. Older kernels
+     * don't know it, fall back to fallocate() which allocates the pages
+     * just as well, but serialized on the file. */
+    if (madvise(chunk->addr + chunk->offset, chunk->len,
+                MADV_POPULATE_WRITE) == 0)
+        return;
+
+    if (errno != EINVAL) {
+        chunk->err = errno;
+        return;
+    }
+
+    if (fallocate(chunk->fd, 0, chunk->offset, chunk->len) < 0)
+        chunk->err = errno;
+}
+
+
+static int
+qemuHugepagesPrefaultItem(virQEMUDriverPtr driver,
+                          virDomainObjPtr vm,
+                          qemuHugepagesItemPtr item,
+                          unsigned int nthreads)
+{
+    g_autofree char *dir = NULL;
+    g_autofree char *path = NULL;
+    g_autofree qemuHugepagesPrefaultChunk *chunks = NULL;
+    g_autofree virThread *threads = NULL;
+    size_t pagesize = item->pagesize * 1024;
+    size_t len = item->size * 1024;
+    size_t npages = item->size / item->pagesize;
+    size_t nchunks = MIN(nthreads, npages);
+    size_t nstarted = 0;
+    char *addr = MAP_FAILED;
+    int fd = -1;
+    int err = 0;
+    int ret = -1;
+    size_t i;
+
+    if (qemuGetDomainHupageMemPath(driver, vm->def, item->pagesize, &dir) < 0)
+        return -1;
+
+    path = g_strdup_printf("%s/%s", dir, item->alias);
+
+    VIR_DEBUG("Allocating %zu huge pages of %llu KiB for %s in %s on node %d",
+              npages, item->pagesize, item->alias, path, item->node);
+
+    if ((fd = open(path, O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR)) < 0) {
+        virReportSystemError(errno, _("unable to create '%s'"), path);
+        goto cleanup;
+    }
+
+    if (ftruncate(fd, len) < 0) {
+        virReportSystemError(errno, _("unable to resize '%s'"), path);
+        goto cleanup;
+    }
+
+    if ((addr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        virReportSystemError(errno, _("unable to map '%s'"), path);
+        goto cleanup;
+    }
+
+    /* The policy of a shared mapping sticks to the file */
+    if (item->node >= 0 &&
+        virNumaBindMemory(addr, len, item->node) < 0)
+        goto cleanup;
+
+    chunks = g_new0(qemuHugepagesPrefaultChunk, nchunks);
+    threads = g_new0(virThread, nchunks);
+
+    for (i = 0; i < nchunks; i++) {
+        chunks[i].fd = fd;
+        chunks[i].addr = addr;
+        chunks[i].offset = npages * i / nchunks * pagesize;
+        chunks[i].len = npages * (i + 1) / nchunks * pagesize -
+                        chunks[i].offset;
+
+        if (virThreadCreateFull(&threads[i], true,
+                                qemuHugepagesPrefaultWorker,
+                                "qemu-hugepages", false, &chunks[i]) < 0) {
+            virReportSystemError(errno, "%s",
+                                 _("unable to create huge page allocation thread"));
+            break;
+        }
+        nstarted++;
+    }
+
+    for (i = 0; i < nstarted; i++) {
+        virThreadJoin(&threads[i]);
+        if (chunks[i].err)
+            err = chunks[i].err;
+    }
+
+    if (nstarted < nchunks)
+        goto cleanup;
+
+    if (err) {
+        virReportSystemError(err, _("unable to allocate huge pages for '%s'"),
+                             path);
+        goto cleanup;
+    }
+
+    if (qemuSecurityDomainSetPathLabel(driver, vm, path, false) < 0)
+        goto cleanup;
+
+    item->path = g_steal_pointer(&path);
+    ret = 0;
+
+ cleanup:
+    if (addr != MAP_FAILED)
+        munmap(addr, len);
+    VIR_FORCE_CLOSE(fd);
+    if (ret < 0 && path)
+        unlink(path);
+    return ret;
+}
+
+
+/**
+ * qemuHugepagesPrefault:
+ * @driver: qemu driver
+ * @vm: domain object
+ *
+ * Unless hugepages_prefault_threads is 0, creates the backing files of
+ * the huge page backed memory backends of @vm and allocates them using
+ * that many threads. Has to be called once the hugetlbfs directories of
+ * @vm exist and before its command line is built.
+ *
+ * The cgroup of @vm doesn't exist yet at that point, the pages are charged
+ * to the hugetlb cgroup of the daemon and stay charged there for as long
+ * as @vm keeps them.
+ *
+ * Returns 0 on success, -1 otherwise (with error reported).
+ */
+int
+qemuHugepagesPrefault(virQEMUDriverPtr driver,
+                      virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    bool all = true;
+    size_t i;
+
+    if (!cfg->hugepagesPrefaultThreads)
+        return 0;
+
+    for (i = 0; i < priv->nhugepages; i++) {
+        qemuHugepagesItemPtr item = &priv->hugepages[i];
+
+        if (!item->alias) {
+            all = false;
+            continue;
+        }
+
+        if (!item->path &&
+            qemuHugepagesPrefaultItem(driver, vm, item,
+                                      cfg->hugepagesPrefaultThreads) < 0)
+            return -1;
+    }
+
+    /* The kernel accounts the pages as used now, unless some of the
+     * memory is left for QEMU to allocate */
+    if (all)
+        qemuHugepagesCommit(driver, vm);
+
+    return 0;
+}
+
+
+/**
+ * qemuHugepagesGetPath:
+ * @items: huge page backed memory of a domain
+ * @nitems: number of @items
+ * @alias: memory backend alias
+ *
+ * Returns the prefaulted backing file of the memory backend @alias, or
+ * NULL if there is none.
+ */
+const char *
+qemuHugepagesGetPath(qemuHugepagesItemPtr items,
+                     size_t nitems,
+                     const char *alias)
+{
+    size_t i;
+
+    for (i = 0; i < nitems; i++) {
+        if (STREQ_NULLABLE(items[i].alias, alias))
+            return items[i].path;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,64 @@
+/*
+ * qemu_hugepages.h: QEMU huge page reservation and pre-allocation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "qemu_conf.h"
+
+/* Huge pages backing one memory backend of a domain */
+typedef struct _qemuHugepagesItem qemuHugepagesItem;
+typedef qemuHugepagesItem *qemuHugepagesItemPtr;
+struct _qemuHugepagesItem {
+    char *alias;    /* memory backend alias, NULL if it can't be prefaulted */
+    int node;       /* host NUMA node, -1 if not bound to a single one */
+    unsigned long long pagesize; /* in KiB */
+    unsigned long long size;     /* in KiB */
+    char *path;     /* prefaulted backing file, if any */
+};
+
+void
+qemuHugepagesItemsFree(qemuHugepagesItemPtr items,
+                       size_t nitems);
+
+qemuHugepageLedgerPtr
+qemuHugepageLedgerNew(void);
+
+void
+qemuHugepageLedgerFree(qemuHugepageLedgerPtr ledger);
+
+int
+qemuHugepagesReserve(virQEMUDriverPtr driver,
+                     virDomainObjPtr vm,
+                     bool reconnect);
+
+void
+qemuHugepagesCommit(virQEMUDriverPtr driver,
+                    virDomainObjPtr vm);
+
+void
+qemuHugepagesRelease(virQEMUDriverPtr driver,
+                     virDomainObjPtr vm);
+
+int
+qemuHugepagesPrefault(virQEMUDriverPtr driver,
+                      virDomainObjPtr vm);
+
+const char *
+qemuHugepagesGetPath(qemuHugepagesItemPtr items,
+                     size_t nitems,
+                     const char *alias);
@@ -0,0 +1,38 @@
+/*
+ * qemu_hugepagespriv.h: private declarations for huge page reservation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LIBVIRT_QEMU_HUGEPAGESPRIV_H_ALLOW
+# error "qemu_hugepagespriv.h may only be included by qemu_hugepages.c or test suites"
+#endif /* LIBVIRT_QEMU_HUGEPAGESPRIV_H_ALLOW */
+
+#pragma once
+
+#include "qemu_hugepages.h"
+
+int
+qemuHugepageLedgerAdmit(qemuHugepageLedgerPtr ledger,
+                        qemuHugepagesItemPtr items,
+                        size_t nitems);
+
+void
+qemuHugepageLedgerUpdate(qemuHugepageLedgerPtr ledger,
+                         qemuHugepagesItemPtr items,
+                         size_t nitems,
+                         bool add,
+                         bool pending);
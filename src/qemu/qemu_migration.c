@@ -555,6 +555,8 @@ qemuMigrationNBDReportMirrorError(qemuBlockJobDataPtr job,
 /**
  * qemuMigrationSrcNBDStorageCopyReady:
  * @vm: domain
+ * @asyncJob: current async job
+ * @notReadyRet: filled with the number of mirrors not ready yet (optional)
  *
  * Check the status of all drives copied via qemuMigrationSrcNBDStorageCopy.
  * Any pending block job events for the mirrored disks will be processed.
@@ -565,7 +567,8 @@ qemuMigrationNBDReportMirrorError(qemuBlockJobDataPtr job,
  */
 static int
 qemuMigrationSrcNBDStorageCopyReady(virDomainObjPtr vm,
-                                    qemuDomainAsyncJob asyncJob)
+                                    qemuDomainAsyncJob asyncJob,
+                                    size_t *notReadyRet)
 {
     size_t i;
     size_t notReady = 0;
@@ -597,6 +600,9 @@ qemuMigrationSrcNBDStorageCopyReady(virDomainObjPtr vm,
         virObjectUnref(job);
     }
 
+    if (notReadyRet)
+        *notReadyRet = notReady;
+
     if (notReady) {
         VIR_DEBUG("Waiting for %zu disk mirrors to get ready", notReady);
         return 0;
@@ -1037,6 +1043,135 @@ qemuMigrationSrcNBDStorageCopyOne(virQEMUDriverPtr driver,
 }
 
 
+typedef struct _qemuMigrationNBDDiskOrder qemuMigrationNBDDiskOrder;
+struct _qemuMigrationNBDDiskOrder {
+    virDomainDiskDefPtr disk;
+    unsigned long long capacity;
+    size_t idx;
+};
+
+
+static int
+qemuMigrationSrcNBDDiskOrderCompare(const void *a,
+                                    const void *b)
+{
+    const qemuMigrationNBDDiskOrder *da = a;
+    const qemuMigrationNBDDiskOrder *db = b;
+
+    if (da->capacity != db->capacity)
+        return da->capacity < db->capacity ? -1 : 1;
+
+    return da->idx < db->idx ? -1 : 1;
+}
+
+
+/**
+ * qemuMigrationSrcNBDStorageCopyOrder:
+ * @vm: domain
+ * @mig: migration cookie from the destination
+ * @nmigrate_disks: number of disks in @migrate_disks
+ * @migrate_disks: disks selected by the user for migration
+ * @ndisks: filled with the number of returned disks
+ *
+ * Returns the disks which should be copied, smallest first, so that small
+ * disks finish their initial copy early rather than waiting for the big
+ * ones. Disks of unknown size go last in their original order.
+ */
+static virDomainDiskDefPtr *
+qemuMigrationSrcNBDStorageCopyOrder(virDomainObjPtr vm,
+                                    qemuMigrationCookiePtr mig,
+                                    size_t nmigrate_disks,
+                                    const char **migrate_disks,
+                                    size_t *ndisks)
+{
+    g_autofree qemuMigrationNBDDiskOrder *order = NULL;
+    virDomainDiskDefPtr *disks;
+    size_t n = 0;
+    size_t i;
+    size_t j;
+
+    order = g_new0(qemuMigrationNBDDiskOrder, vm->def->ndisks);
+
+    for (i = 0; i < vm->def->ndisks; i++) {
+        virDomainDiskDefPtr disk = vm->def->disks[i];
+
+        /* check whether disk should be migrated */
+        if (!qemuMigrationAnyCopyDisk(disk, nmigrate_disks, migrate_disks))
+            continue;
+
+        order[n].disk = disk;
+        order[n].capacity = ULLONG_MAX;
+        order[n].idx = n;
+
+        for (j = 0; j < mig->nbd->ndisks; j++) {
+            if (STREQ(mig->nbd->disks[j].target, disk->dst) &&
+                mig->nbd->disks[j].capacity > 0) {
+                order[n].capacity = mig->nbd->disks[j].capacity;
+                break;
+            }
+        }
+
+        n++;
+    }
+
+    qsort(order, n, sizeof(*order), qemuMigrationSrcNBDDiskOrderCompare);
+
+    disks = g_new0(virDomainDiskDefPtr, n);
+    for (i = 0; i < n; i++)
+        disks[i] = order[i].disk;
+
+    *ndisks = n;
+    return disks;
+}
+
+
+/**
+ * qemuMigrationSrcNBDStorageCopySetSpeed:
+ * @driver: qemu driver
+ * @vm: domain
+ * @disks: disks being copied
+ * @ndisks: number of disks in @disks
+ * @speed: new bandwidth limit in bytes/s for each of them
+ *
+ * Changes the bandwidth limit of the disk mirrors which are still in their
+ * initial copy. Mirrors which already reached the ready state are left
+ * alone so that they do not get a share computed for the syncing ones.
+ */
+static int
+qemuMigrationSrcNBDStorageCopySetSpeed(virQEMUDriverPtr driver,
+                                       virDomainObjPtr vm,
+                                       virDomainDiskDefPtr *disks,
+                                       size_t ndisks,
+                                       unsigned long long speed)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    size_t i;
+    int rc = 0;
+
+    VIR_DEBUG("Limiting %zu disk mirrors to %llu bytes/s", ndisks, speed);
+
+    if (qemuDomainObjEnterMonitorAsync(driver, vm,
+                                       QEMU_ASYNC_JOB_MIGRATION_OUT) < 0)
+        return -1;
+
+    for (i = 0; i < ndisks && rc == 0; i++) {
+        qemuBlockJobDataPtr job;
+
+        if (!(job = qemuBlockJobDiskGetJob(disks[i])))
+            continue;
+
+        if (job->state != VIR_DOMAIN_BLOCK_JOB_READY)
+            rc = qemuMonitorBlockJobSetSpeed(priv->mon, job->name, speed);
+        virObjectUnref(job);
+    }
+
+    if (qemuDomainObjExitMonitor(driver, vm) < 0 || rc < 0)
+        return -1;
+
+    return 0;
+}
+
+
 /**
  * qemuMigrationSrcNBDStorageCopy:
  * @driver: qemu driver
@@ -1045,9 +1180,16 @@ qemuMigrationSrcNBDStorageCopyOne(virQEMUDriverPtr driver,
  * @host: where are we migrating to
  * @speed: bandwidth limit in MiB/s
  * @migrate_flags: migrate monitor command flags
+ * @migParams: migration parameters
  *
  * Migrate non-shared storage using the NBD protocol to the server running
  * inside the qemu process on dst and wait until the copy converges.
+ *
+ * Disks are copied smallest first. If @migParams limit the number of disks
+ * copied in parallel, a new mirror is only started once another one has
+ * finished its initial copy. If they limit the bandwidth available to all
+ * disks, it is split evenly among the mirrors which have not finished the
+ * initial copy yet; the limit overrides @speed then.
  * On success update @migrate_flags so we don't tell 'migrate' command
  * to do the very same operation. On failure, the caller is
  * expected to call qemuMigrationSrcNBDCopyCancel to stop all
@@ -1068,13 +1210,20 @@ qemuMigrationSrcNBDStorageCopy(virQEMUDriverPtr driver,
                                virConnectPtr dconn,
                                const char *tlsAlias,
                                const char *nbdURI,
+                               qemuMigrationParamsPtr migParams,
                                unsigned int flags)
 {
     qemuDomainObjPrivatePtr priv = vm->privateData;
     int port;
-    size_t i;
     unsigned long long mirror_speed = speed;
     bool mirror_shallow = *migrate_flags & QEMU_MONITOR_MIGRATE_NON_SHARED_INC;
+    unsigned int maxParallel = qemuMigrationParamsGetDisksParallel(migParams);
+    unsigned long long bandwidth = qemuMigrationParamsGetDisksBandwidth(migParams);
+    unsigned long long curSpeed;
+    g_autofree virDomainDiskDefPtr *disks = NULL;
+    size_t ndisks = 0;
+    size_t nstarted = 0;
+    size_t nsyncing = 0;
     int rv;
     g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
     g_autoptr(virURI) uri = NULL;
@@ -1127,29 +1276,71 @@ qemuMigrationSrcNBDStorageCopy(virQEMUDriverPtr driver,
         }
     }
 
-    for (i = 0; i < vm->def->ndisks; i++) {
-        virDomainDiskDefPtr disk = vm->def->disks[i];
+    disks = qemuMigrationSrcNBDStorageCopyOrder(vm, mig, nmigrate_disks,
+                                                migrate_disks, &ndisks);
 
-        /* check whether disk should be migrated */
-        if (!qemuMigrationAnyCopyDisk(disk, nmigrate_disks, migrate_disks))
-            continue;
+    if (bandwidth > 0)
+        mirror_speed = bandwidth;
+    curSpeed = mirror_speed;
 
-        if (qemuMigrationSrcNBDStorageCopyOne(driver, vm, disk, host, port,
-                                              socket,
-                                              mirror_speed, mirror_shallow,
-                                              tlsAlias, flags) < 0)
-            return -1;
+    for (;;) {
+        /* Start mirrors for as many disks as we are allowed to */
+        while (nstarted < ndisks &&
+               (maxParallel == 0 || nsyncing < maxParallel)) {
+            virDomainDiskDefPtr disk = disks[nstarted];
+
+            if (bandwidth > 0) {
+                mirror_speed = MAX(bandwidth / (nsyncing + 1), 1);
+
+                /* Make room for the new mirror before starting it */
+                if (nsyncing > 0 && mirror_speed != curSpeed &&
+                    qemuMigrationSrcNBDStorageCopySetSpeed(driver, vm, disks,
+                                                           nstarted,
+                                                           mirror_speed) < 0)
+                    return -1;
+                curSpeed = mirror_speed;
+            }
 
-        if (virDomainObjSave(vm, driver->xmlopt, cfg->stateDir) < 0) {
-            VIR_WARN("Failed to save status on vm %s", vm->def->name);
-            return -1;
+            VIR_DEBUG("Starting mirror of disk %s (%zu of %zu)",
+                      disk->dst, nstarted + 1, ndisks);
+
+            if (qemuMigrationSrcNBDStorageCopyOne(driver, vm, disk, host, port,
+                                                  socket,
+                                                  mirror_speed, mirror_shallow,
+                                                  tlsAlias, flags) < 0)
+                return -1;
+
+            nstarted++;
+            nsyncing++;
+
+            if (virDomainObjSave(vm, driver->xmlopt, cfg->stateDir) < 0) {
+                VIR_WARN("Failed to save status on vm %s", vm->def->name);
+                return -1;
+            }
         }
-    }
 
-    while ((rv = qemuMigrationSrcNBDStorageCopyReady(vm, QEMU_ASYNC_JOB_MIGRATION_OUT)) != 1) {
-        if (rv < 0)
+        if ((rv = qemuMigrationSrcNBDStorageCopyReady(vm, QEMU_ASYNC_JOB_MIGRATION_OUT,
+                                                      &nsyncing)) < 0)
             return -1;
 
+        if (rv == 1 && nstarted == ndisks)
+            break;
+
+        /* Redistribute the bandwidth whenever the number of mirrors in
+         * their initial copy changes */
+        if (bandwidth > 0 &&
+            MAX(bandwidth / MAX(nsyncing, 1), 1) != curSpeed) {
+            curSpeed = MAX(bandwidth / MAX(nsyncing, 1), 1);
+            if (qemuMigrationSrcNBDStorageCopySetSpeed(driver, vm, disks,
+                                                       nstarted, curSpeed) < 0)
+                return -1;
+        }
+
+        /* Some mirror got ready, start the next one right away */
+        if (nstarted < ndisks &&
+            (maxParallel == 0 || nsyncing < maxParallel))
+            continue;
+
         if (priv->job.abortJob) {
             priv->job.current->status = QEMU_DOMAIN_JOB_STATUS_CANCELED;
             virReportError(VIR_ERR_OPERATION_ABORTED, _("%s: %s"),
@@ -1745,7 +1936,7 @@ qemuMigrationAnyCompleted(virQEMUDriverPtr driver,
 
     /* This flag should only be set when run on src host */
     if (flags & QEMU_MIGRATION_COMPLETED_CHECK_STORAGE &&
-        qemuMigrationSrcNBDStorageCopyReady(vm, asyncJob) < 0)
+        qemuMigrationSrcNBDStorageCopyReady(vm, asyncJob, NULL) < 0)
         goto error;
 
     if (flags & QEMU_MIGRATION_COMPLETED_ABORT_ON_ERROR &&
@@ -1817,6 +2008,149 @@ qemuMigrationAnyCompleted(virQEMUDriverPtr driver,
 }
 
 
+/* How often the convergence controller looks at migration statistics */
+#define QEMU_MIGRATION_CONVERGE_INTERVAL 1000 /* ms */
+
+typedef struct _qemuMigrationConverge qemuMigrationConverge;
+typedef qemuMigrationConverge *qemuMigrationConvergePtr;
+struct _qemuMigrationConverge {
+    unsigned long long deadline; /* ms since epoch, 0 if not set */
+    unsigned long long maxDowntime; /* ms, 0 if not set */
+    unsigned long long downtime; /* downtime limit we set last */
+    unsigned long long lastCheck; /* ms since epoch */
+    bool postcopy; /* we already asked for switching to post-copy */
+};
+
+
+static int
+qemuMigrationSrcConvergeSetDowntime(virQEMUDriverPtr driver,
+                                    virDomainObjPtr vm,
+                                    qemuDomainAsyncJob asyncJob,
+                                    unsigned long long downtime)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    g_autoptr(virJSONValue) params = NULL;
+    int rc;
+
+    /* Only touch downtime-limit here; going through qemuMigrationParamsApply
+     * would also reset all migration capabilities of the running job. */
+    if (virQEMUCapsGet(priv->qemuCaps, QEMU_CAPS_MIGRATION_PARAM_DOWNTIME) &&
+        virJSONValueObjectCreate(&params,
+                                 "U:downtime-limit", downtime,
+                                 NULL) < 0)
+        return -1;
+
+    if (qemuDomainObjEnterMonitorAsync(driver, vm, asyncJob) < 0)
+        return -1;
+    if (params)
+        rc = qemuMonitorSetMigrationParams(priv->mon, &params);
+    else
+        rc = qemuMonitorSetMigrationDowntime(priv->mon, downtime);
+    if (qemuDomainObjExitMonitor(driver, vm) < 0 || rc < 0)
+        return -1;
+
+    return 0;
+}
+
+
+/**
+ * qemuMigrationSrcConverge:
+ *
+ * Looks at the current migration statistics and steers the migration
+ * towards the targets in @conv. Once QEMU has finished the first pass over
+ * guest memory and either is not keeping up with the rate at which the
+ * guest dirties it or would miss the deadline, the downtime limit is raised
+ * to what is needed to transfer the remaining memory at the current speed
+ * as long as it stays within the maximum downtime allowed. When the
+ * deadline passes and post-copy was enabled for the migration, it is
+ * switched to post-copy.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+static int
+qemuMigrationSrcConverge(virQEMUDriverPtr driver,
+                         virDomainObjPtr vm,
+                         qemuDomainAsyncJob asyncJob,
+                         qemuMigrationConvergePtr conv,
+                         unsigned int flags)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    qemuDomainJobInfoPtr jobInfo = priv->job.current;
+    qemuMonitorMigrationStats *stats = &jobInfo->stats.mig;
+    unsigned long long now;
+    unsigned long long dirtyBps;
+    unsigned long long needed;
+    bool converging;
+    bool late;
+    int rc;
+
+    if (virTimeMillisNow(&now) < 0)
+        return -1;
+
+    if (now - conv->lastCheck < QEMU_MIGRATION_CONVERGE_INTERVAL)
+        return 0;
+    conv->lastCheck = now;
+
+    if (virQEMUCapsGet(priv->qemuCaps, QEMU_CAPS_MIGRATION_EVENT) &&
+        qemuMigrationAnyFetchStats(driver, vm, asyncJob, jobInfo, NULL) < 0)
+        return -1;
+
+    if (jobInfo->status != QEMU_DOMAIN_JOB_STATUS_MIGRATING ||
+        stats->ram_iteration < 2 ||
+        stats->ram_bps == 0)
+        return 0;
+
+    dirtyBps = stats->ram_dirty_rate * stats->ram_page_size;
+    late = conv->deadline && now >= conv->deadline;
+    converging = stats->ram_bps > dirtyBps;
+    if (converging && conv->deadline && !late) {
+        unsigned long long eta = stats->ram_remaining * 1000 /
+                                 (stats->ram_bps - dirtyBps);
+        converging = now + eta <= conv->deadline;
+    }
+
+    VIR_DEBUG("Migration of %s: remaining=%llu bps=%llu dirty=%llu "
+              "converging=%d late=%d",
+              vm->def->name, stats->ram_remaining, stats->ram_bps,
+              dirtyBps, converging, late);
+
+    if (converging && !late)
+        return 0;
+
+    needed = stats->ram_remaining * 1000 / stats->ram_bps;
+    /* leave some room for the data dirtied meanwhile */
+    needed += needed / 10;
+
+    if (conv->maxDowntime && needed > conv->downtime) {
+        unsigned long long downtime = MIN(needed, conv->maxDowntime);
+
+        if (downtime > conv->downtime) {
+            VIR_INFO("Raising downtime limit of migrating domain %s to %llums",
+                     vm->def->name, downtime);
+            if (qemuMigrationSrcConvergeSetDowntime(driver, vm, asyncJob,
+                                                    downtime) < 0)
+                return -1;
+            conv->downtime = downtime;
+        }
+    }
+
+    if (late && !conv->postcopy &&
+        flags & QEMU_MIGRATION_COMPLETED_POSTCOPY &&
+        (!conv->maxDowntime || needed > conv->maxDowntime)) {
+        VIR_INFO("Migration of domain %s missed its deadline, "
+                 "switching to post-copy", vm->def->name);
+        if (qemuDomainObjEnterMonitorAsync(driver, vm, asyncJob) < 0)
+            return -1;
+        rc = qemuMonitorMigrateStartPostCopy(priv->mon);
+        if (qemuDomainObjExitMonitor(driver, vm) < 0 || rc < 0)
+            return -1;
+        conv->postcopy = true;
+    }
+
+    return 0;
+}
+
+
 /* Returns 0 on success, -2 when migration needs to be cancelled, or -1 when
  * QEMU reports failed migration.
  */
@@ -1825,21 +2159,51 @@ qemuMigrationSrcWaitForCompletion(virQEMUDriverPtr driver,
                                   virDomainObjPtr vm,
                                   qemuDomainAsyncJob asyncJob,
                                   virConnectPtr dconn,
+                                  qemuMigrationParamsPtr migParams,
                                   unsigned int flags)
 {
     qemuDomainObjPrivatePtr priv = vm->privateData;
     qemuDomainJobInfoPtr jobInfo = priv->job.current;
     bool events = virQEMUCapsGet(priv->qemuCaps, QEMU_CAPS_MIGRATION_EVENT);
+    qemuMigrationConverge conv = { 0 };
+    bool converge = false;
     int rv;
 
     jobInfo->status = QEMU_DOMAIN_JOB_STATUS_MIGRATING;
 
+    if (migParams) {
+        unsigned long long deadline = qemuMigrationParamsGetConvergeDeadline(migParams);
+
+        conv.maxDowntime = qemuMigrationParamsGetConvergeDowntime(migParams);
+        if (deadline)
+            conv.deadline = jobInfo->started + deadline;
+        converge = conv.deadline || conv.maxDowntime;
+    }
+
     while ((rv = qemuMigrationAnyCompleted(driver, vm, asyncJob,
                                            dconn, flags)) != 1) {
         if (rv < 0)
             return rv;
 
-        if (events) {
+        if (converge &&
+            qemuMigrationSrcConverge(driver, vm, asyncJob, &conv, flags) < 0) {
+            /* tuning is best effort, let the migration continue */
+            VIR_WARN("Failed to tune migration of domain %s: %s",
+                     vm->def->name, virGetLastErrorMessage());
+            virResetLastError();
+            converge = false;
+        }
+
+        if (events && converge) {
+            unsigned long long now;
+
+            if (virTimeMillisNow(&now) < 0 ||
+                virDomainObjWaitUntil(vm, now + QEMU_MIGRATION_CONVERGE_INTERVAL) < 0) {
+                if (virDomainObjIsActive(vm))
+                    jobInfo->status = QEMU_DOMAIN_JOB_STATUS_FAILED;
+                return -2;
+            }
+        } else if (events) {
             if (virDomainObjWait(vm) < 0) {
                 if (virDomainObjIsActive(vm))
                     jobInfo->status = QEMU_DOMAIN_JOB_STATUS_FAILED;
@@ -3324,8 +3688,14 @@ struct _qemuMigrationSpec {
     } fwd;
 };
 
+/* Size of a single chunk sent over the stream */
 #define TUNNEL_SEND_BUF_SIZE 65536
 
+/* Data read from QEMU is queued in several larger buffers so that the
+ * next read can happen while the previous data is still being sent */
+#define TUNNEL_READ_BUF_SIZE (1024 * 1024)
+#define TUNNEL_READ_BUFS 4
+
 typedef struct _qemuMigrationIOThread qemuMigrationIOThread;
 typedef qemuMigrationIOThread *qemuMigrationIOThreadPtr;
 struct _qemuMigrationIOThread {
@@ -3335,20 +3705,133 @@ struct _qemuMigrationIOThread {
     virError err;
     int wakeupRecvFD;
     int wakeupSendFD;
+
+    /* Queue of data read from @sock, protected by @lock */
+    virThread sendThread;
+    virMutex lock;
+    virCond cond;
+    char *bufs[TUNNEL_READ_BUFS];
+    size_t lens[TUNNEL_READ_BUFS];
+    size_t head; /* first filled buffer */
+    size_t count; /* number of filled buffers */
+    bool done; /* no more buffers will be queued */
+    int discard; /* drop queued data; accessed atomically */
+    bool sendFailed;
+    virError sendErr;
 };
 
+
+/* Sends data queued by qemuMigrationSrcIOFunc to the stream. */
+static void
+qemuMigrationSrcIOSendFunc(void *arg)
+{
+    qemuMigrationIOThreadPtr data = arg;
+
+    virMutexLock(&data->lock);
+    for (;;) {
+        char *buf;
+        size_t len;
+        size_t off;
+
+        if (g_atomic_int_get(&data->discard))
+            break;
+
+        if (data->count == 0) {
+            if (data->done)
+                break;
+            if (virCondWait(&data->cond, &data->lock) < 0) {
+                virReportSystemError(errno, "%s",
+                                     _("failed to wait on condition"));
+                goto error;
+            }
+            continue;
+        }
+
+        buf = data->bufs[data->head];
+        len = data->lens[data->head];
+        virMutexUnlock(&data->lock);
+
+        for (off = 0; off < len; off += TUNNEL_SEND_BUF_SIZE) {
+            if (g_atomic_int_get(&data->discard))
+                break;
+
+            if (virStreamSend(data->st, buf + off,
+                              MIN(len - off, TUNNEL_SEND_BUF_SIZE)) < 0) {
+                virMutexLock(&data->lock);
+                goto error;
+            }
+        }
+
+        virMutexLock(&data->lock);
+        data->head = (data->head + 1) % TUNNEL_READ_BUFS;
+        data->count--;
+        virCondSignal(&data->cond);
+    }
+    virMutexUnlock(&data->lock);
+    return;
+
+ error:
+    data->sendFailed = true;
+    virCopyLastError(&data->sendErr);
+    virResetLastError();
+    virCondSignal(&data->cond);
+    virMutexUnlock(&data->lock);
+}
+
+
+/* Tells the sending thread no more data is coming and waits for it to
+ * send whatever is still queued, or to drop it right away if @discard is
+ * true. Returns -1 with the error of the sending thread set if it
+ * failed. */
+static int
+qemuMigrationSrcIOStopSend(qemuMigrationIOThreadPtr data,
+                           bool discard)
+{
+    if (discard)
+        g_atomic_int_set(&data->discard, 1);
+
+    virMutexLock(&data->lock);
+    data->done = true;
+    virCondSignal(&data->cond);
+    virMutexUnlock(&data->lock);
+
+    virThreadJoin(&data->sendThread);
+
+    if (data->sendFailed) {
+        virSetError(&data->sendErr);
+        virResetError(&data->sendErr);
+        return -1;
+    }
+
+    return 0;
+}
+
+
 static void qemuMigrationSrcIOFunc(void *arg)
 {
     qemuMigrationIOThreadPtr data = arg;
-    char *buffer = NULL;
     struct pollfd fds[2];
     int timeout = -1;
     virErrorPtr err = NULL;
+    bool sending = false;
+    size_t i;
 
     VIR_DEBUG("Running migration tunnel; stream=%p, sock=%d",
               data->st, data->sock);
 
-    buffer = g_new0(char, TUNNEL_SEND_BUF_SIZE);
+    for (i = 0; i < TUNNEL_READ_BUFS; i++)
+        data->bufs[i] = g_new0(char, TUNNEL_READ_BUF_SIZE);
+
+    if (virThreadCreateFull(&data->sendThread, true,
+                            qemuMigrationSrcIOSendFunc,
+                            "qemu-mig-send",
+                            false,
+                            data) < 0) {
+        virReportSystemError(errno, "%s",
+                             _("Unable to create migration thread"));
+        goto abrt;
+    }
+    sending = true;
 
     fds[0].fd = data->sock;
     fds[1].fd = data->wakeupRecvFD;
@@ -3397,13 +3880,38 @@ static void qemuMigrationSrcIOFunc(void *arg)
         }
 
         if (fds[0].revents & (POLLIN | POLLERR | POLLHUP)) {
-            int nbytes;
+            ssize_t nbytes;
+            size_t slot;
+            bool sendFailed;
+
+            /* Wait for the sending thread to free up a buffer */
+            virMutexLock(&data->lock);
+            while (data->count == TUNNEL_READ_BUFS && !data->sendFailed)
+                ignore_value(virCondWait(&data->cond, &data->lock));
+            slot = (data->head + data->count) % TUNNEL_READ_BUFS;
+            sendFailed = data->sendFailed;
+            virMutexUnlock(&data->lock);
+
+            if (sendFailed) {
+                sending = false;
+                if (qemuMigrationSrcIOStopSend(data, false) < 0)
+                    goto error;
+            }
+
+            while ((nbytes = read(data->sock, data->bufs[slot],
+                                  TUNNEL_READ_BUF_SIZE)) < 0 &&
+                   errno == EINTR)
+                ;
 
-            nbytes = saferead(data->sock, buffer, TUNNEL_SEND_BUF_SIZE);
             if (nbytes > 0) {
-                if (virStreamSend(data->st, buffer, nbytes) < 0)
-                    goto error;
+                virMutexLock(&data->lock);
+                data->lens[slot] = nbytes;
+                data->count++;
+                virCondSignal(&data->cond);
+                virMutexUnlock(&data->lock);
             } else if (nbytes < 0) {
+                if (errno == EAGAIN)
+                    continue;
                 virReportSystemError(errno, "%s",
                         _("tunnelled migration failed to read from qemu"));
                 goto abrt;
@@ -3414,13 +3922,15 @@ static void qemuMigrationSrcIOFunc(void *arg)
         }
     }
 
+    sending = false;
+    if (qemuMigrationSrcIOStopSend(data, false) < 0)
+        goto error;
+
     if (virStreamFinish(data->st) < 0)
         goto error;
 
     VIR_FORCE_CLOSE(data->sock);
-    VIR_FREE(buffer);
-
-    return;
+    goto cleanup;
 
  abrt:
     virErrorPreserveLast(&err);
@@ -3428,6 +3938,12 @@ static void qemuMigrationSrcIOFunc(void *arg)
         virFreeError(err);
         err = NULL;
     }
+    if (sending) {
+        /* Neither queued data nor any error of the sending thread
+         * matter anymore */
+        sending = false;
+        ignore_value(qemuMigrationSrcIOStopSend(data, true));
+    }
     virStreamAbort(data->st);
     virErrorRestore(&err);
 
@@ -3438,7 +3954,10 @@ static void qemuMigrationSrcIOFunc(void *arg)
     if (!virLastErrorIsSystemErrno(EPIPE))
         virCopyLastError(&data->err);
     virResetLastError();
-    VIR_FREE(buffer);
+
+ cleanup:
+    for (i = 0; i < TUNNEL_READ_BUFS; i++)
+        VIR_FREE(data->bufs[i]);
 }
 
 
@@ -3459,6 +3978,13 @@ qemuMigrationSrcStartTunnel(virStreamPtr st,
     io->wakeupRecvFD = wakeupFD[0];
     io->wakeupSendFD = wakeupFD[1];
 
+    if (virMutexInit(&io->lock) < 0 ||
+        virCondInit(&io->cond) < 0) {
+        virReportSystemError(errno, "%s",
+                             _("Unable to initialize migration tunnel"));
+        goto error;
+    }
+
     if (virThreadCreateFull(&io->thread, true,
                             qemuMigrationSrcIOFunc,
                             "qemu-mig-tunnel",
@@ -3508,6 +4034,8 @@ qemuMigrationSrcStopTunnel(qemuMigrationIOThreadPtr io, bool error)
  cleanup:
     VIR_FORCE_CLOSE(io->wakeupSendFD);
     VIR_FORCE_CLOSE(io->wakeupRecvFD);
+    virCondDestroy(&io->cond);
+    virMutexDestroy(&io->lock);
     VIR_FREE(io);
     return rv;
 }
@@ -3781,7 +4309,7 @@ qemuMigrationSrcRun(virQEMUDriverPtr driver,
                                                nmigrate_disks,
                                                migrate_disks,
                                                dconn, tlsAlias,
-                                               nbdURI, flags) < 0) {
+                                               nbdURI, migParams, flags) < 0) {
                 goto error;
             }
         } else {
@@ -3894,7 +4422,7 @@ qemuMigrationSrcRun(virQEMUDriverPtr driver,
 
     rc = qemuMigrationSrcWaitForCompletion(driver, vm,
                                            QEMU_ASYNC_JOB_MIGRATION_OUT,
-                                           dconn, waitFlags);
+                                           dconn, migParams, waitFlags);
     if (rc == -2) {
         goto error;
     } else if (rc == -1) {
@@ -3934,7 +4462,7 @@ qemuMigrationSrcRun(virQEMUDriverPtr driver,
 
         rc = qemuMigrationSrcWaitForCompletion(driver, vm,
                                                QEMU_ASYNC_JOB_MIGRATION_OUT,
-                                               dconn, waitFlags);
+                                               dconn, migParams, waitFlags);
         if (rc == -2) {
             goto error;
         } else if (rc == -1) {
@@ -5606,7 +6134,7 @@ qemuMigrationSrcToFile(virQEMUDriverPtr driver, virDomainObjPtr vm,
     if (rc < 0)
         goto cleanup;
 
-    rc = qemuMigrationSrcWaitForCompletion(driver, vm, asyncJob, NULL, 0);
+    rc = qemuMigrationSrcWaitForCompletion(driver, vm, asyncJob, NULL, NULL, 0);
 
     if (rc < 0) {
         if (rc == -2) {
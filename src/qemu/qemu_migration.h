@@ -85,6 +85,10 @@
     VIR_MIGRATE_PARAM_PARALLEL_CONNECTIONS, VIR_TYPED_PARAM_INT, \
     VIR_MIGRATE_PARAM_TLS_DESTINATION, VIR_TYPED_PARAM_STRING, \
     VIR_MIGRATE_PARAM_DISKS_URI,     VIR_TYPED_PARAM_STRING, \
+    VIR_MIGRATE_PARAM_DISKS_PARALLEL, VIR_TYPED_PARAM_INT, \
+    VIR_MIGRATE_PARAM_BANDWIDTH_DISKS, VIR_TYPED_PARAM_ULLONG, \
+    VIR_MIGRATE_PARAM_CONVERGE_DEADLINE, VIR_TYPED_PARAM_ULLONG, \
+    VIR_MIGRATE_PARAM_CONVERGE_DOWNTIME, VIR_TYPED_PARAM_ULLONG, \
     NULL
 
 
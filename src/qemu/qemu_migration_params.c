@@ -63,6 +63,14 @@ struct _qemuMigrationParams {
     unsigned long long compMethods; /* bit-wise OR of qemuMigrationCompressMethod */
     virBitmapPtr caps;
     qemuMigrationParamValue params[QEMU_MIGRATION_PARAM_LAST];
+
+    /* Used by libvirt itself when copying non-shared storage */
+    unsigned int disksParallel; /* 0 means all disks at once */
+    unsigned long long disksBandwidth; /* bytes/s, 0 means unlimited */
+
+    /* Targets for steering the migration to converge */
+    unsigned long long convergeDeadline; /* ms since the job started */
+    unsigned long long convergeDowntime; /* ms */
 };
 
 typedef enum {
@@ -524,6 +532,77 @@ qemuMigrationParamsSetCompression(virTypedParameterPtr params,
 }
 
 
+static int
+qemuMigrationParamsSetDisks(virTypedParameterPtr params,
+                            int nparams,
+                            qemuMigrationParamsPtr migParams)
+{
+    int parallel = 0;
+    unsigned long long bandwidth = 0;
+
+    if (!params)
+        return 0;
+
+    if (virTypedParamsGetInt(params, nparams,
+                             VIR_MIGRATE_PARAM_DISKS_PARALLEL,
+                             &parallel) < 0 ||
+        virTypedParamsGetULLong(params, nparams,
+                                VIR_MIGRATE_PARAM_BANDWIDTH_DISKS,
+                                &bandwidth) < 0)
+        return -1;
+
+    if (parallel < 0) {
+        virReportError(VIR_ERR_INVALID_ARG,
+                       _("migration parameter '%s' must not be negative"),
+                       VIR_MIGRATE_PARAM_DISKS_PARALLEL);
+        return -1;
+    }
+
+    if (bandwidth > LLONG_MAX >> 20) {
+        virReportError(VIR_ERR_OVERFLOW,
+                       _("migration parameter '%s' must be less than %llu"),
+                       VIR_MIGRATE_PARAM_BANDWIDTH_DISKS, LLONG_MAX >> 20);
+        return -1;
+    }
+
+    migParams->disksParallel = parallel;
+    migParams->disksBandwidth = bandwidth << 20;
+
+    return 0;
+}
+
+
+static int
+qemuMigrationParamsSetConverge(virTypedParameterPtr params,
+                               int nparams,
+                               qemuMigrationParamsPtr migParams)
+{
+    unsigned long long deadline = 0;
+
+    if (!params)
+        return 0;
+
+    if (virTypedParamsGetULLong(params, nparams,
+                                VIR_MIGRATE_PARAM_CONVERGE_DEADLINE,
+                                &deadline) < 0 ||
+        virTypedParamsGetULLong(params, nparams,
+                                VIR_MIGRATE_PARAM_CONVERGE_DOWNTIME,
+                                &migParams->convergeDowntime) < 0)
+        return -1;
+
+    if (deadline > ULLONG_MAX / 1000) {
+        virReportError(VIR_ERR_OVERFLOW,
+                       _("migration parameter '%s' must be less than %llu"),
+                       VIR_MIGRATE_PARAM_CONVERGE_DEADLINE, ULLONG_MAX / 1000);
+        return -1;
+    }
+
+    migParams->convergeDeadline = deadline * 1000;
+
+    return 0;
+}
+
+
 qemuMigrationParamsPtr
 qemuMigrationParamsFromFlags(virTypedParameterPtr params,
                              int nparams,
@@ -600,6 +679,11 @@ qemuMigrationParamsFromFlags(virTypedParameterPtr params,
     if (qemuMigrationParamsSetCompression(params, nparams, flags, migParams) < 0)
         return NULL;
 
+    if (party & QEMU_MIGRATION_SOURCE &&
+        (qemuMigrationParamsSetDisks(params, nparams, migParams) < 0 ||
+         qemuMigrationParamsSetConverge(params, nparams, migParams) < 0))
+        return NULL;
+
     return g_steal_pointer(&migParams);
 }
 
@@ -1101,6 +1185,62 @@ qemuMigrationParamsGetULL(qemuMigrationParamsPtr migParams,
 }
 
 
+/**
+ * qemuMigrationParamsGetDisksParallel:
+ * @migParams: migration parameters
+ *
+ * Returns the maximum number of disks which should be in their initial
+ * copy at the same time or 0 if there's no limit.
+ */
+unsigned int
+qemuMigrationParamsGetDisksParallel(qemuMigrationParamsPtr migParams)
+{
+    return migParams->disksParallel;
+}
+
+
+/**
+ * qemuMigrationParamsGetDisksBandwidth:
+ * @migParams: migration parameters
+ *
+ * Returns the bandwidth in bytes/s shared by all copied disks or 0 if
+ * there's no limit.
+ */
+unsigned long long
+qemuMigrationParamsGetDisksBandwidth(qemuMigrationParamsPtr migParams)
+{
+    return migParams->disksBandwidth;
+}
+
+
+/**
+ * qemuMigrationParamsGetConvergeDeadline:
+ * @migParams: migration parameters
+ *
+ * Returns the time in milliseconds since the start of the migration by
+ * which it should converge or 0 if there's no deadline.
+ */
+unsigned long long
+qemuMigrationParamsGetConvergeDeadline(qemuMigrationParamsPtr migParams)
+{
+    return migParams->convergeDeadline;
+}
+
+
+/**
+ * qemuMigrationParamsGetConvergeDowntime:
+ * @migParams: migration parameters
+ *
+ * Returns the maximum downtime in milliseconds libvirt may allow to make
+ * the migration converge or 0 if it must not change the downtime limit.
+ */
+unsigned long long
+qemuMigrationParamsGetConvergeDowntime(qemuMigrationParamsPtr migParams)
+{
+    return migParams->convergeDowntime;
+}
+
+
 /**
  * qemuMigrationParamsCheck:
  *
@@ -132,6 +132,18 @@ qemuMigrationParamsGetULL(qemuMigrationParamsPtr migParams,
                           qemuMigrationParam param,
                           unsigned long long *value);
 
+unsigned int
+qemuMigrationParamsGetDisksParallel(qemuMigrationParamsPtr migParams);
+
+unsigned long long
+qemuMigrationParamsGetDisksBandwidth(qemuMigrationParamsPtr migParams);
+
+unsigned long long
+qemuMigrationParamsGetConvergeDeadline(qemuMigrationParamsPtr migParams);
+
+unsigned long long
+qemuMigrationParamsGetConvergeDowntime(qemuMigrationParamsPtr migParams);
+
 int
 qemuMigrationParamsCheck(virQEMUDriverPtr driver,
                          virDomainObjPtr vm,
@@ -4229,6 +4229,80 @@ qemuMonitorSetIOThread(qemuMonitorPtr mon,
 }
 
 
+void
+qemuMonitorVcpuStatsKVMFree(qemuMonitorVcpuStatsKVMPtr stats,
+                            size_t nstats)
+{
+    size_t i;
+    size_t j;
+
+    if (!stats)
+        return;
+
+    for (i = 0; i < nstats; i++) {
+        for (j = 0; j < stats[i].nstats; j++)
+            g_free(stats[i].names[j]);
+
+        g_free(stats[i].names);
+        g_free(stats[i].values);
+        g_free(stats[i].qom_path);
+    }
+
+    g_free(stats);
+}
+
+
+/**
+ * qemuMonitorGetVcpuStatsKVM:
+ * @mon: Pointer to the monitor
+ * @stats: Location to return the array of statistics of each vcpu
+ * @nstats: Count of vcpus in @stats
+ *
+ * Issue query-stats for the statistics KVM keeps about each vcpu. Only
+ * QEMU can ask KVM for them, as the kernel hands them out to the process
+ * that owns the vcpus only. query-stats identifies the vcpus by their QOM
+ * path, query-cpus-fast is used to find the thread running each of them.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+qemuMonitorGetVcpuStatsKVM(qemuMonitorPtr mon,
+                           qemuMonitorVcpuStatsKVMPtr *stats,
+                           size_t *nstats)
+{
+    struct qemuMonitorQueryCpusEntry *cpus = NULL;
+    size_t ncpus = 0;
+    size_t i;
+    size_t j;
+
+    VIR_DEBUG("stats=%p", stats);
+
+    QEMU_CHECK_MONITOR(mon);
+
+    if (qemuMonitorJSONQueryStatsVcpuKVM(mon, stats, nstats) < 0)
+        return -1;
+
+    if (qemuMonitorJSONQueryCPUs(mon, &cpus, &ncpus, false, true) == -1) {
+        qemuMonitorVcpuStatsKVMFree(*stats, *nstats);
+        *stats = NULL;
+        *nstats = 0;
+        return -1;
+    }
+
+    for (i = 0; i < *nstats; i++) {
+        for (j = 0; j < ncpus; j++) {
+            if (STREQ_NULLABLE((*stats)[i].qom_path, cpus[j].qom_path)) {
+                (*stats)[i].tid = cpus[j].tid;
+                break;
+            }
+        }
+    }
+
+    qemuMonitorQueryCpusFree(cpus, ncpus);
+    return 0;
+}
+
+
 /**
  * qemuMonitorGetMemoryDeviceInfo:
  * @mon: pointer to the monitor
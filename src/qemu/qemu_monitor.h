@@ -1367,6 +1367,21 @@ int qemuMonitorGetIOThreads(qemuMonitorPtr mon,
 int qemuMonitorSetIOThread(qemuMonitorPtr mon,
                            qemuMonitorIOThreadInfoPtr iothreadInfo);
 
+typedef struct _qemuMonitorVcpuStatsKVM qemuMonitorVcpuStatsKVM;
+typedef qemuMonitorVcpuStatsKVM *qemuMonitorVcpuStatsKVMPtr;
+struct _qemuMonitorVcpuStatsKVM {
+    char *qom_path;
+    pid_t tid; /* thread of the vcpu, 0 if not known */
+    size_t nstats;
+    char **names;
+    unsigned long long *values;
+};
+void qemuMonitorVcpuStatsKVMFree(qemuMonitorVcpuStatsKVMPtr stats,
+                                 size_t nstats);
+int qemuMonitorGetVcpuStatsKVM(qemuMonitorPtr mon,
+                               qemuMonitorVcpuStatsKVMPtr *stats,
+                               size_t *nstats);
+
 typedef struct _qemuMonitorMemoryDeviceInfo qemuMonitorMemoryDeviceInfo;
 typedef qemuMonitorMemoryDeviceInfo *qemuMonitorMemoryDeviceInfoPtr;
 
@@ -8196,6 +8196,108 @@ qemuMonitorJSONSetIOThread(qemuMonitorPtr mon,
 }
 
 
+/**
+ * qemuMonitorJSONQueryStatsVcpuKVM:
+ * @mon: Pointer to the monitor
+ * @stats: Location to return the array of statistics of each vcpu
+ * @nstats: Count of vcpus in @stats
+ *
+ * Issue query-stats for the vcpu target and parse the statistics of the
+ * "kvm" provider. The reply looks like:
+ *
+ *   [{"provider": "kvm",
+ *     "qom-path": "/machine/unattached/device[0]",
+ *     "stats": [{"name": "exits", "value": 131078},
+ *               {"name": "halt_wait_hist", "value": [0, 12, 3]},
+ *               ...]},
+ *    ...]
+ *
+ * Histograms don't fit into a single value and are skipped. The threads
+ * of the vcpus are not filled in.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+qemuMonitorJSONQueryStatsVcpuKVM(qemuMonitorPtr mon,
+                                 qemuMonitorVcpuStatsKVMPtr *stats,
+                                 size_t *nstats)
+{
+    g_autoptr(virJSONValue) cmd = NULL;
+    g_autoptr(virJSONValue) reply = NULL;
+    virJSONValuePtr data;
+    qemuMonitorVcpuStatsKVMPtr entries = NULL;
+    size_t nentries = 0;
+    size_t n;
+    size_t i;
+    size_t j;
+
+    *stats = NULL;
+    *nstats = 0;
+
+    if (!(cmd = qemuMonitorJSONMakeCommand("query-stats",
+                                           "s:target", "vcpu",
+                                           NULL)))
+        return -1;
+
+    if (qemuMonitorJSONCommand(mon, cmd, &reply) < 0)
+        return -1;
+
+    if (qemuMonitorJSONCheckReply(cmd, reply, VIR_JSON_TYPE_ARRAY) < 0)
+        return -1;
+
+    data = virJSONValueObjectGetArray(reply, "return");
+    n = virJSONValueArraySize(data);
+
+    entries = g_new0(qemuMonitorVcpuStatsKVM, n);
+
+    for (i = 0; i < n; i++) {
+        virJSONValuePtr result = virJSONValueArrayGet(data, i);
+        qemuMonitorVcpuStatsKVMPtr entry;
+        virJSONValuePtr list;
+        const char *qom_path;
+        size_t nlist;
+
+        if (STRNEQ_NULLABLE(virJSONValueObjectGetString(result, "provider"),
+                            "kvm"))
+            continue;
+
+        if (!(qom_path = virJSONValueObjectGetString(result, "qom-path")) ||
+            !(list = virJSONValueObjectGetArray(result, "stats"))) {
+            virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                           _("query-stats reply data was missing 'qom-path' "
+                             "or 'stats'"));
+            qemuMonitorVcpuStatsKVMFree(entries, nentries);
+            return -1;
+        }
+
+        nlist = virJSONValueArraySize(list);
+
+        entry = entries + nentries++;
+        entry->qom_path = g_strdup(qom_path);
+        entry->names = g_new0(char *, nlist);
+        entry->values = g_new0(unsigned long long, nlist);
+
+        for (j = 0; j < nlist; j++) {
+            virJSONValuePtr stat = virJSONValueArrayGet(list, j);
+            virJSONValuePtr value = virJSONValueObjectGet(stat, "value");
+            const char *name = virJSONValueObjectGetString(stat, "name");
+
+            if (!name || !value ||
+                virJSONValueGetType(value) != VIR_JSON_TYPE_NUMBER ||
+                virJSONValueGetNumberUlong(value,
+                                           &entry->values[entry->nstats]) < 0)
+                continue;
+
+            entry->names[entry->nstats++] = g_strdup(name);
+        }
+    }
+
+    *stats = g_steal_pointer(&entries);
+    *nstats = nentries;
+    return 0;
+}
+
+
 int
 qemuMonitorJSONGetMemoryDeviceInfo(qemuMonitorPtr mon,
                                    GHashTable *info)
@@ -558,6 +558,11 @@ int qemuMonitorJSONSetIOThread(qemuMonitorPtr mon,
                                qemuMonitorIOThreadInfoPtr iothreadInfo)
     ATTRIBUTE_NONNULL(1) ATTRIBUTE_NONNULL(2);
 
+int qemuMonitorJSONQueryStatsVcpuKVM(qemuMonitorPtr mon,
+                                     qemuMonitorVcpuStatsKVMPtr *stats,
+                                     size_t *nstats)
+    ATTRIBUTE_NONNULL(2) ATTRIBUTE_NONNULL(3);
+
 int qemuMonitorJSONGetMemoryDeviceInfo(qemuMonitorPtr mon,
                                        GHashTable *info)
     ATTRIBUTE_NONNULL(1) ATTRIBUTE_NONNULL(2);
@@ -1158,6 +1158,21 @@ qemuNamespaceMknodItemInit(qemuNamespaceMknodItemPtr item,
 }
 
 
+static bool
+qemuNamespaceMknodDataHasItem(qemuNamespaceMknodDataPtr data,
+                              const char *file)
+{
+    size_t i;
+
+    for (i = 0; i < data->nitems; i++) {
+        if (STREQ(data->items[i].file, file))
+            return true;
+    }
+
+    return false;
+}
+
+
 static int
 qemuNamespacePrepareOneItem(qemuNamespaceMknodDataPtr data,
                             virQEMUDriverConfigPtr cfg,
@@ -1176,6 +1191,13 @@ qemuNamespacePrepareOneItem(qemuNamespaceMknodDataPtr data,
         bool addToData = false;
         int rc;
 
+        /* Many devices share nodes (e.g. /dev/vfio/vfio or backing
+         * images). If @next was seen already, so was the rest of the
+         * symlink chain. Creating it twice would just waste time and
+         * bind mount the same file twice. */
+        if (qemuNamespaceMknodDataHasItem(data, next))
+            break;
+
         rc = qemuNamespaceMknodItemInit(&item, cfg, vm, next);
         if (rc == -2) {
             /* @file doesn't exist. We can break here. */
@@ -1254,6 +1276,16 @@ qemuNamespaceMknodPaths(virDomainObjPtr vm,
             goto cleanup;
     }
 
+    /* Everything lives on preserved mounts, no need to enter the
+     * namespace at all. */
+    if (data.nitems == 0) {
+        ret = 0;
+        goto cleanup;
+    }
+
+    VIR_DEBUG("Creating %zu items in namespace of domain %s",
+              data.nitems, vm->def->name);
+
     for (i = 0; i < data.nitems; i++) {
         qemuNamespaceMknodItemPtr item = &data.items[i];
         if (item->target &&
@@ -1340,6 +1372,7 @@ qemuNamespaceUnlinkPaths(virDomainObjPtr vm,
     size_t ndevMountsPath = 0;
     size_t npaths;
     size_t i;
+    size_t j;
     int ret = -1;
 
     npaths = virStringListLength(paths);
@@ -1357,16 +1390,17 @@ qemuNamespaceUnlinkPaths(virDomainObjPtr vm,
         const char *file = paths[i];
 
         if (STRPREFIX(file, QEMU_DEVPREFIX)) {
-            for (i = 0; i < ndevMountsPath; i++) {
-                if (STREQ(devMountsPath[i], "/dev"))
+            for (j = 0; j < ndevMountsPath; j++) {
+                if (STREQ(devMountsPath[j], "/dev"))
                     continue;
-                if (STRPREFIX(file, devMountsPath[i]))
+                if (STRPREFIX(file, devMountsPath[j]))
                     break;
             }
 
-            if (i == ndevMountsPath &&
+            if (j == ndevMountsPath &&
+                !virStringListHasString((const char **) unlinkPaths, file) &&
                 virStringListAdd(&unlinkPaths, file) < 0)
-                return -1;
+                goto cleanup;
         }
     }
 
@@ -1374,7 +1408,7 @@ qemuNamespaceUnlinkPaths(virDomainObjPtr vm,
         virProcessRunInMountNamespace(vm->pid,
                                       qemuNamespaceUnlinkHelper,
                                       unlinkPaths) < 0)
-        return -1;
+        goto cleanup;
 
     ret = 0;
  cleanup:
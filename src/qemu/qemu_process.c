@@ -33,6 +33,7 @@
 #endif
 
 #include <sys/utsname.h>
+#include <glib-unix.h>
 
 #if WITH_CAPNG
 # include <cap-ng.h>
@@ -52,6 +53,7 @@
 #include "qemu_command.h"
 #include "qemu_hostdev.h"
 #include "qemu_hotplug.h"
+#include "qemu_hugepages.h"
 #include "qemu_migration.h"
 #include "qemu_migration_params.h"
 #include "qemu_interface.h"
@@ -2651,6 +2653,16 @@ qemuProcessSetLinkStates(virQEMUDriverPtr driver,
     int ret = -1;
     int rv;
 
+    /* All links are up by default, don't bother entering the monitor unless
+     * there's something to change */
+    for (i = 0; i < def->nnets; i++) {
+        if (def->nets[i]->linkstate == VIR_DOMAIN_NET_INTERFACE_LINK_STATE_DOWN)
+            break;
+    }
+
+    if (i == def->nnets)
+        return 0;
+
     if (qemuDomainObjEnterMonitorAsync(driver, vm, asyncJob) < 0)
         return -1;
 
@@ -5142,18 +5154,26 @@ qemuProcessSetupBalloon(virQEMUDriverPtr driver,
 {
     unsigned long long balloon = vm->def->mem.cur_balloon;
     qemuDomainObjPrivatePtr priv = vm->privateData;
+    bool deflated;
     int ret = -1;
 
     if (!virDomainDefHasMemballoon(vm->def))
         return 0;
 
+    /* The balloon starts fully deflated, so asking QEMU to set the target
+     * to the full memory size is a no-op. */
+    deflated = balloon >= virDomainDefGetMemoryTotal(vm->def);
+    if (deflated && !vm->def->memballoon->period)
+        return 0;
+
     if (qemuDomainObjEnterMonitorAsync(driver, vm, asyncJob) < 0)
         return -1;
 
     if (vm->def->memballoon->period)
         qemuMonitorSetMemoryStatsPeriod(priv->mon, vm->def->memballoon,
                                         vm->def->memballoon->period);
-    if (qemuMonitorSetBalloon(priv->mon, balloon) < 0)
+    if (!deflated &&
+        qemuMonitorSetBalloon(priv->mon, balloon) < 0)
         goto cleanup;
 
     ret = 0;
@@ -5611,6 +5631,79 @@ qemuProcessPrepareQEMUCaps(virDomainObjPtr vm,
 }
 
 
+static void
+qemuProcessStartPhaseReset(virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+
+    memset(&priv->startStats, 0, sizeof(priv->startStats));
+    ignore_value(virTimeMillisNowRaw(&priv->startStats.mark));
+}
+
+
+/**
+ * qemuProcessStartPhaseEnd:
+ * @vm: domain object
+ * @phase: phase of the start which was just finished
+ *
+ * Accounts the time since the end of the previous phase to @phase.
+ */
+static void
+qemuProcessStartPhaseEnd(virDomainObjPtr vm,
+                         qemuDomainStartPhase phase)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    unsigned long long now;
+
+    if (virTimeMillisNowRaw(&now) < 0)
+        return;
+
+    priv->startStats.phases[phase] += now - priv->startStats.mark;
+    priv->startStats.mark = now;
+}
+
+
+/**
+ * qemuProcessStartPhaseReport:
+ * @vm: domain object
+ * @asyncJob: async job the domain was started in
+ *
+ * Logs the time spent in each phase of starting @vm and, when the domain
+ * was started by its own job, records them as statistics of the completed
+ * job.
+ */
+static void
+qemuProcessStartPhaseReport(virDomainObjPtr vm,
+                            qemuDomainAsyncJob asyncJob)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    g_auto(virBuffer) buf = VIR_BUFFER_INITIALIZER;
+    g_autofree char *str = NULL;
+    qemuDomainJobInfoPtr jobInfo;
+    size_t i;
+
+    for (i = 0; i < QEMU_DOMAIN_START_PHASE_LAST; i++) {
+        virBufferAsprintf(&buf, " %s=%llu",
+                          qemuDomainStartPhaseTypeToString(i),
+                          priv->startStats.phases[i]);
+    }
+    str = virBufferContentAndReset(&buf);
+    VIR_DEBUG("Start phases of domain %s (ms):%s", vm->def->name, NULLSTR_EMPTY(str));
+
+    if (asyncJob != QEMU_ASYNC_JOB_START || !priv->job.current)
+        return;
+
+    jobInfo = qemuDomainJobInfoCopy(priv->job.current);
+    jobInfo->status = QEMU_DOMAIN_JOB_STATUS_COMPLETED;
+    jobInfo->statsType = QEMU_DOMAIN_JOB_STATS_TYPE_START;
+    jobInfo->stats.start = priv->startStats;
+    ignore_value(qemuDomainJobInfoUpdateTime(jobInfo));
+
+    g_clear_pointer(&priv->job.completed, qemuDomainJobInfoFree);
+    priv->job.completed = jobInfo;
+}
+
+
 /**
  * qemuProcessInit:
  *
@@ -5641,6 +5734,8 @@ qemuProcessInit(virQEMUDriverPtr driver,
 
     VIR_DEBUG("Beginning VM startup process");
 
+    qemuProcessStartPhaseReset(vm);
+
     if (virDomainObjIsActive(vm)) {
         virReportError(VIR_ERR_OPERATION_INVALID, "%s",
                        _("VM is already active"));
@@ -5703,6 +5798,7 @@ qemuProcessInit(virQEMUDriverPtr driver,
         priv->origCPU = g_steal_pointer(&origCPU);
     }
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_INIT);
     ret = 0;
 
  cleanup:
@@ -6199,49 +6295,360 @@ qemuProcessUpdateGuestCPU(virDomainDefPtr def,
 }
 
 
+/**
+ * qemuProcessGetNUMAPlacementLoad:
+ * @driver: qemu driver
+ * @def: domain definition
+ * @caps: host NUMA topology
+ * @load: array of @caps->cells->len items to fill
+ *
+ * Fill @load with the memory each host NUMA node has free for @def and
+ * with the number of vCPUs of running domains bound to the node. For
+ * domains backed by huge pages only free pages of the right size count.
+ *
+ * Returns 0 on success, -1 on error.
+ */
 static int
-qemuProcessPrepareDomainNUMAPlacement(virDomainObjPtr vm)
+qemuProcessGetNUMAPlacementLoad(virQEMUDriverPtr driver,
+                                virDomainDefPtr def,
+                                virCapsHostNUMAPtr caps,
+                                virCapsHostNUMAPlacementLoadPtr load)
+{
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    g_autofree unsigned int *vcpus = NULL;
+    unsigned long long pagesize = 0;
+    bool numa = virNumaIsAvailable();
+    size_t nvcpus = 0;
+    size_t i;
+    size_t j;
+
+    if (def->mem.nhugepages) {
+        pagesize = def->mem.hugepages[0].size;
+
+        if (pagesize == 0) {
+            virHugeTLBFSPtr fs = virFileGetDefaultHugepage(cfg->hugetlbfs,
+                                                           cfg->nhugetlbfs);
+
+            if (fs)
+                pagesize = fs->size;
+        }
+    }
+
+    vcpus = virQEMUDriverGetNUMAVcpus(driver, &nvcpus);
+
+    for (i = 0; i < caps->cells->len; i++) {
+        virCapsHostNUMACellPtr cell = g_ptr_array_index(caps->cells, i);
+
+        if (cell->num < nvcpus)
+            load[i].vcpus = vcpus[cell->num];
+
+        if (pagesize) {
+            g_autofree unsigned int *pageSizes = NULL;
+            g_autofree unsigned long long *pageFree = NULL;
+            size_t npages = 0;
+
+            if (virNumaGetPages(numa ? cell->num : -1, &pageSizes, NULL,
+                                &pageFree, &npages) < 0)
+                return -1;
+
+            for (j = 0; j < npages; j++) {
+                if (pageSizes[j] == pagesize)
+                    load[i].memFree = pageFree[j] * pagesize;
+            }
+        } else {
+            unsigned long long memFree;
+
+            if (numa && virNumaGetNodeMemory(cell->num, NULL, &memFree) == 0)
+                load[i].memFree = memFree / 1024;
+            else
+                load[i].memFree = cell->mem;
+        }
+
+        VIR_DEBUG("node=%d memFree=%llu vcpus=%u",
+                  cell->num, load[i].memFree, load[i].vcpus);
+    }
+
+    return 0;
+}
+
+
+static int
+qemuProcessPrepareDomainNUMAPlacement(virQEMUDriverPtr driver,
+                                      virDomainObjPtr vm)
 {
     qemuDomainObjPrivatePtr priv = vm->privateData;
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
     g_autofree char *nodeset = NULL;
-    g_autoptr(virBitmap) numadNodeset = NULL;
+    g_autoptr(virBitmap) autoNodeset = NULL;
     g_autoptr(virBitmap) hostMemoryNodeset = NULL;
     g_autoptr(virCapsHostNUMA) caps = NULL;
+    unsigned int vcpus = virDomainDefGetVcpus(vm->def);
+    unsigned long long memory = virDomainDefGetMemoryTotal(vm->def);
 
-    /* Get the advisory nodeset from numad if 'placement' of
-     * either <vcpu> or <numatune> is 'auto'.
+    /* Pick the nodeset if 'placement' of either <vcpu> or <numatune>
+     * is 'auto'.
      */
     if (!virDomainDefNeedsPlacementAdvice(vm->def))
         return 0;
 
-    nodeset = virNumaGetAutoPlacementAdvice(virDomainDefGetVcpus(vm->def),
-                                            virDomainDefGetMemoryTotal(vm->def));
-
-    if (!nodeset)
+    if (!(caps = virCapabilitiesHostNUMANewHost()))
         return -1;
 
+    if (cfg->numadPlacement) {
+        if (!(nodeset = virNumaGetAutoPlacementAdvice(vcpus, memory)))
+            return -1;
+
+        VIR_DEBUG("Nodeset returned from numad: %s", nodeset);
+
+        if (virBitmapParse(nodeset, &autoNodeset, VIR_DOMAIN_CPUMASK_LEN) < 0)
+            return -1;
+    } else {
+        g_autofree virCapsHostNUMAPlacementLoad *load = NULL;
+
+        load = g_new0(virCapsHostNUMAPlacementLoad, caps->cells->len);
+
+        if (qemuProcessGetNUMAPlacementLoad(driver, vm->def, caps, load) < 0)
+            return -1;
+
+        if (!(autoNodeset = virCapabilitiesHostNUMAPlace(caps, load,
+                                                         vcpus, memory)))
+            return -1;
+
+        nodeset = virBitmapFormat(autoNodeset);
+        VIR_DEBUG("Nodeset chosen by placement: %s", NULLSTR(nodeset));
+    }
+
     if (!(hostMemoryNodeset = virNumaGetHostMemoryNodeset()))
         return -1;
 
-    VIR_DEBUG("Nodeset returned from numad: %s", nodeset);
+    /* The nodeset may contain nodes with cpus only but cgroups don't play
+     * well with that. Set the autoCpuset from all cpus from that nodeset, but
+     * assign autoNodeset only with nodes containing memory. */
+    if (!(priv->autoCpuset = virCapabilitiesHostNUMAGetCpus(caps, autoNodeset)))
+        return -1;
+
+    virBitmapIntersect(autoNodeset, hostMemoryNodeset);
+
+    priv->autoNodeset = g_steal_pointer(&autoNodeset);
+
+    return 0;
+}
+
+
+/**
+ * qemuProcessNUMAVcpusAccount:
+ * @driver: qemu driver
+ * @vm: domain object
+ *
+ * Account online vCPUs of @vm to the host NUMA nodes their pinning lets
+ * them run on so that automatic placement of domains started later
+ * avoids those nodes. vCPUs allowed to run anywhere are not accounted.
+ * Changes of the pinning while the domain runs are not reflected.
+ */
+static void
+qemuProcessNUMAVcpusAccount(virQEMUDriverPtr driver,
+                            virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    g_autoptr(virCaps) caps = NULL;
+    g_autofree unsigned int *vcpus = NULL;
+    virBitmapPtr defmask = vm->def->cpumask;
+    size_t maxvcpus = virDomainDefGetVcpusMax(vm->def);
+    size_t nvcpus = 0;
+    size_t i;
+    size_t j;
+    size_t k;
+
+    if (priv->numaVcpus)
+        return;
+
+    if (vm->def->placement_mode == VIR_DOMAIN_CPU_PLACEMENT_MODE_AUTO)
+        defmask = priv->autoCpuset;
+
+    if (!(caps = virQEMUDriverGetCapabilities(driver, false)) ||
+        !caps->host.numa) {
+        virResetLastError();
+        return;
+    }
+
+    for (i = 0; i < caps->host.numa->cells->len; i++) {
+        virCapsHostNUMACellPtr cell = g_ptr_array_index(caps->host.numa->cells, i);
+
+        nvcpus = MAX(nvcpus, cell->num + 1);
+    }
+
+    vcpus = g_new0(unsigned int, nvcpus);
+
+    for (i = 0; i < maxvcpus; i++) {
+        virDomainVcpuDefPtr vcpu = virDomainDefGetVcpu(vm->def, i);
+        virBitmapPtr cpumask = vcpu->cpumask ? vcpu->cpumask : defmask;
+
+        if (!vcpu->online || !cpumask)
+            continue;
+
+        for (j = 0; j < caps->host.numa->cells->len; j++) {
+            virCapsHostNUMACellPtr cell = g_ptr_array_index(caps->host.numa->cells, j);
+
+            for (k = 0; k < cell->ncpus; k++) {
+                if (virBitmapIsBitSet(cpumask, cell->cpus[k].id)) {
+                    vcpus[cell->num]++;
+                    break;
+                }
+            }
+        }
+    }
+
+    virQEMUDriverUpdateNUMAVcpus(driver, vcpus, nvcpus, true);
+    priv->numaVcpus = g_steal_pointer(&vcpus);
+    priv->nnumaVcpus = nvcpus;
+}
+
 
-    if (virBitmapParse(nodeset, &numadNodeset, VIR_DOMAIN_CPUMASK_LEN) < 0)
+static void
+qemuProcessNUMAVcpusRelease(virQEMUDriverPtr driver,
+                            virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+
+    if (!priv->numaVcpus)
+        return;
+
+    virQEMUDriverUpdateNUMAVcpus(driver, priv->numaVcpus,
+                                 priv->nnumaVcpus, false);
+    VIR_FREE(priv->numaVcpus);
+    priv->nnumaVcpus = 0;
+}
+
+
+static int
+qemuProcessRepinNUMAThreads(virDomainObjPtr vm)
+{
+    size_t i;
+
+    if (qemuProcessSetupEmulator(vm) < 0)
         return -1;
 
+    for (i = 0; i < virDomainDefGetVcpusMax(vm->def); i++) {
+        if (!virDomainDefGetVcpu(vm->def, i)->online)
+            continue;
+
+        if (qemuProcessSetupVcpu(vm, i) < 0)
+            return -1;
+    }
+
+    for (i = 0; i < vm->def->niothreadids; i++) {
+        if (qemuProcessSetupIOThread(vm, vm->def->iothreadids[i]) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * qemuProcessRepinNUMA:
+ * @driver: qemu driver
+ * @vm: domain object
+ * @nodeset: host NUMA nodes the domain is moved to
+ *
+ * Point the automatic or static placement of running @vm at @nodeset
+ * and the host CPUs in it and redo the setup of the emulator, vCPU and
+ * I/O threads accordingly. The memory of @vm is expected to be already
+ * restricted to @nodeset. Note that with static placement the host CPUs
+ * of @nodeset replace the <vcpu cpuset=...> of the live definition.
+ *
+ * On error the placement of @vm is restored and its threads are set up
+ * according to it again.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+qemuProcessRepinNUMA(virQEMUDriverPtr driver,
+                     virDomainObjPtr vm,
+                     virBitmapPtr nodeset)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    g_autoptr(virCapsHostNUMA) caps = NULL;
+    g_autoptr(virBitmap) cpuset = NULL;
+    g_autoptr(virBitmap) oldAutoNodeset = NULL;
+    g_autoptr(virBitmap) oldAutoCpuset = NULL;
+    g_autoptr(virBitmap) oldNodeset = NULL;
+    g_autoptr(virBitmap) oldCpumask = NULL;
+    bool setNumatune = false;
+    virErrorPtr orig_err = NULL;
+
     if (!(caps = virCapabilitiesHostNUMANewHost()))
         return -1;
 
-    /* numad may return a nodeset that only contains cpus but cgroups don't play
-     * well with that. Set the autoCpuset from all cpus from that nodeset, but
-     * assign autoNodeset only with nodes containing memory. */
-    if (!(priv->autoCpuset = virCapabilitiesHostNUMAGetCpus(caps, numadNodeset)))
+    if (!(cpuset = virCapabilitiesHostNUMAGetCpus(caps, nodeset)))
         return -1;
 
-    virBitmapIntersect(numadNodeset, hostMemoryNodeset);
+    if (priv->autoNodeset) {
+        oldAutoNodeset = g_steal_pointer(&priv->autoNodeset);
+        oldAutoCpuset = g_steal_pointer(&priv->autoCpuset);
+        priv->autoNodeset = virBitmapNewCopy(nodeset);
+        priv->autoCpuset = virBitmapNewCopy(cpuset);
+    } else if (virDomainNumatuneGetNodeset(vm->def->numa, NULL, -1)) {
+        oldNodeset = virBitmapNewCopy(virDomainNumatuneGetNodeset(vm->def->numa,
+                                                                  NULL, -1));
+        if (virDomainNumatuneSet(vm->def->numa,
+                                 vm->def->placement_mode ==
+                                 VIR_DOMAIN_CPU_PLACEMENT_MODE_STATIC,
+                                 -1, -1, nodeset) < 0)
+            return -1;
+    } else {
+        /* Without a nodeset the threads don't touch cpuset.mems which is
+         * set up already, record the new nodeset once they are moved so
+         * that there's nothing to undo on failure. */
+        setNumatune = true;
+    }
+
+    if (vm->def->placement_mode != VIR_DOMAIN_CPU_PLACEMENT_MODE_AUTO) {
+        oldCpumask = g_steal_pointer(&vm->def->cpumask);
+        vm->def->cpumask = virBitmapNewCopy(cpuset);
+    }
 
-    priv->autoNodeset = g_steal_pointer(&numadNodeset);
+    if (qemuProcessRepinNUMAThreads(vm) < 0)
+        goto error;
+
+    if (setNumatune &&
+        virDomainNumatuneSet(vm->def->numa,
+                             vm->def->placement_mode ==
+                             VIR_DOMAIN_CPU_PLACEMENT_MODE_STATIC,
+                             -1, -1, nodeset) < 0)
+        goto error;
+
+    qemuProcessNUMAVcpusRelease(driver, vm);
+    qemuProcessNUMAVcpusAccount(driver, vm);
 
     return 0;
+
+ error:
+    virErrorPreserveLast(&orig_err);
+
+    if (oldAutoNodeset) {
+        virBitmapFree(priv->autoNodeset);
+        priv->autoNodeset = g_steal_pointer(&oldAutoNodeset);
+        virBitmapFree(priv->autoCpuset);
+        priv->autoCpuset = g_steal_pointer(&oldAutoCpuset);
+    } else if (oldNodeset) {
+        ignore_value(virDomainNumatuneSet(vm->def->numa,
+                                          vm->def->placement_mode ==
+                                          VIR_DOMAIN_CPU_PLACEMENT_MODE_STATIC,
+                                          -1, -1, oldNodeset));
+    }
+
+    if (vm->def->placement_mode != VIR_DOMAIN_CPU_PLACEMENT_MODE_AUTO) {
+        virBitmapFree(vm->def->cpumask);
+        vm->def->cpumask = g_steal_pointer(&oldCpumask);
+    }
+
+    if (qemuProcessRepinNUMAThreads(vm) < 0)
+        VIR_WARN("Unable to restore placement of threads of domain %s",
+                 vm->def->name);
+
+    virErrorRestore(&orig_err);
+    return -1;
 }
 
 
@@ -6430,7 +6837,13 @@ qemuProcessPrepareDomain(virQEMUDriverPtr driver,
         }
         virDomainAuditSecurityLabel(vm, true);
 
-        if (qemuProcessPrepareDomainNUMAPlacement(vm) < 0)
+        if (qemuProcessPrepareDomainNUMAPlacement(driver, vm) < 0)
+            return -1;
+
+        qemuProcessNUMAVcpusAccount(driver, vm);
+
+        VIR_DEBUG("Reserving huge pages");
+        if (qemuHugepagesReserve(driver, vm, false) < 0)
             return -1;
     }
 
@@ -6532,6 +6945,7 @@ qemuProcessPrepareDomain(virQEMUDriverPtr driver,
             return -1;
     }
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_PREPARE_DOMAIN);
     return 0;
 }
 
@@ -6713,6 +7127,10 @@ qemuProcessPrepareHost(virQEMUDriverPtr driver,
     if (qemuProcessBuildDestroyMemoryPaths(driver, vm, NULL, true) < 0)
         return -1;
 
+    VIR_DEBUG("Preallocating huge pages");
+    if (qemuHugepagesPrefault(driver, vm) < 0)
+        return -1;
+
     /* Ensure no historical cgroup for this VM is lying around bogus
      * settings */
     VIR_DEBUG("Ensuring no historical cgroup is lying around");
@@ -6767,6 +7185,7 @@ qemuProcessPrepareHost(virQEMUDriverPtr driver,
     if (qemuProcessPrepareSEVGuestInput(vm) < 0)
         return -1;
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_PREPARE_HOST);
     return 0;
 }
 
@@ -6892,6 +7311,133 @@ qemuProcessEnablePerf(virDomainObjPtr vm)
 }
 
 
+typedef struct _qemuProcessPressureWatch qemuProcessPressureWatch;
+struct _qemuProcessPressureWatch {
+    virQEMUDriverPtr driver;
+    virDomainObjPtr vm;
+    virDomainPressureResource resource;
+    unsigned long long stall;
+    unsigned long long window;
+    int fd;
+};
+
+
+static void
+qemuProcessPressureWatchFree(void *opaque)
+{
+    qemuProcessPressureWatch *watch = opaque;
+
+    VIR_FORCE_CLOSE(watch->fd);
+    virObjectUnref(watch->vm);
+    g_free(watch);
+}
+
+
+static gboolean
+qemuProcessPressureIO(int fd G_GNUC_UNUSED,
+                      GIOCondition cond,
+                      gpointer opaque)
+{
+    qemuProcessPressureWatch *watch = opaque;
+    virObjectEventPtr event = NULL;
+
+    /* The cgroup was removed under us, the trigger is gone */
+    if (cond & (G_IO_ERR | G_IO_HUP | G_IO_NVAL))
+        return G_SOURCE_REMOVE;
+
+    virObjectLock(watch->vm);
+    if (virDomainObjIsActive(watch->vm))
+        event = virDomainEventPressureNewFromObj(watch->vm, watch->resource,
+                                                 watch->stall, watch->window);
+    virObjectUnlock(watch->vm);
+
+    virObjectEventStateQueue(watch->driver->domainEventState, event);
+
+    return G_SOURCE_CONTINUE;
+}
+
+
+/**
+ * qemuProcessPressureWatchStart:
+ * @driver: qemu driver data
+ * @vm: domain object
+ *
+ * Arms the pressure stall triggers configured in qemu.conf on the cgroup
+ * of @vm. The kernel wakes the domain's event loop whenever a threshold
+ * is exceeded, which then emits VIR_DOMAIN_EVENT_ID_PRESSURE. Failing to
+ * arm a trigger, e.g. because the host doesn't provide PSI, is not fatal.
+ */
+static void
+qemuProcessPressureWatchStart(virQEMUDriverPtr driver,
+                              virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    const unsigned int stalls[VIR_DOMAIN_PRESSURE_RESOURCE_LAST] = {
+        [VIR_DOMAIN_PRESSURE_RESOURCE_MEMORY] = cfg->pressureMemoryStall,
+        [VIR_DOMAIN_PRESSURE_RESOURCE_IO] = cfg->pressureIOStall,
+    };
+    const virCgroupPressureResource resources[VIR_DOMAIN_PRESSURE_RESOURCE_LAST] = {
+        [VIR_DOMAIN_PRESSURE_RESOURCE_MEMORY] = VIR_CGROUP_PRESSURE_MEMORY,
+        [VIR_DOMAIN_PRESSURE_RESOURCE_IO] = VIR_CGROUP_PRESSURE_IO,
+    };
+    size_t i;
+
+    if (!priv->cgroup || !priv->eventThread)
+        return;
+
+    for (i = 0; i < VIR_DOMAIN_PRESSURE_RESOURCE_LAST; i++) {
+        qemuProcessPressureWatch *watch;
+        unsigned long long stall = stalls[i] * 1000ULL;
+        unsigned long long window = cfg->pressureWindow * 1000ULL;
+        int fd;
+
+        if (stall == 0 || priv->pressureWatch[i])
+            continue;
+
+        if ((fd = virCgroupOpenPressureTrigger(priv->cgroup, resources[i],
+                                               stall, window)) < 0) {
+            VIR_WARN("Unable to watch %s pressure of domain %s: %s",
+                     virCgroupPressureResourceTypeToString(resources[i]),
+                     vm->def->name, virGetLastErrorMessage());
+            virResetLastError();
+            continue;
+        }
+
+        watch = g_new0(qemuProcessPressureWatch, 1);
+        watch->driver = driver;
+        watch->vm = virObjectRef(vm);
+        watch->resource = i;
+        watch->stall = stall;
+        watch->window = window;
+        watch->fd = fd;
+
+        priv->pressureWatch[i] = g_unix_fd_source_new(fd, G_IO_PRI | G_IO_ERR);
+        g_source_set_callback(priv->pressureWatch[i],
+                              (GSourceFunc)qemuProcessPressureIO,
+                              watch, qemuProcessPressureWatchFree);
+        g_source_attach(priv->pressureWatch[i],
+                        virEventThreadGetContext(priv->eventThread));
+    }
+}
+
+
+static void
+qemuProcessPressureWatchStop(virDomainObjPtr vm)
+{
+    qemuDomainObjPrivatePtr priv = vm->privateData;
+    size_t i;
+
+    for (i = 0; i < VIR_DOMAIN_PRESSURE_RESOURCE_LAST; i++) {
+        if (!priv->pressureWatch[i])
+            continue;
+
+        g_source_destroy(priv->pressureWatch[i]);
+        g_clear_pointer(&priv->pressureWatch[i], g_source_unref);
+    }
+}
+
+
 /**
  * qemuProcessLaunch:
  *
@@ -7035,6 +7581,8 @@ qemuProcessLaunch(virConnectPtr conn,
     virCommandDaemonize(cmd);
     virCommandRequireHandshake(cmd);
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_COMMAND_LINE);
+
     if (qemuSecurityPreFork(driver->securityManager) < 0)
         goto cleanup;
     rv = virCommandRun(cmd, NULL);
@@ -7068,10 +7616,14 @@ qemuProcessLaunch(virConnectPtr conn,
         goto cleanup;
     }
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_EXEC);
+
     VIR_DEBUG("Building domain mount namespace (if required)");
     if (qemuDomainBuildNamespace(cfg, vm) < 0)
         goto cleanup;
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_NAMESPACE);
+
     VIR_DEBUG("Setting up domain cgroup (if required)");
     if (qemuSetupCgroup(vm, nnicindexes, nicindexes) < 0)
         goto cleanup;
@@ -7102,6 +7654,8 @@ qemuProcessLaunch(virConnectPtr conn,
         qemuProcessStartManagedPRDaemon(vm) < 0)
         goto cleanup;
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_CGROUP);
+
     VIR_DEBUG("Setting domain security labels");
     if (qemuSecuritySetAllLabel(driver,
                                 vm,
@@ -7139,16 +7693,25 @@ qemuProcessLaunch(virConnectPtr conn,
         goto cleanup;
     VIR_DEBUG("Handshake complete, child running");
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_LABEL);
+
     if (qemuDomainObjStartWorker(vm) < 0)
         goto cleanup;
 
+    qemuProcessPressureWatchStart(driver, vm);
+
     VIR_DEBUG("Waiting for monitor to show up");
     if (qemuProcessWaitForMonitor(driver, vm, asyncJob, logCtxt) < 0)
         goto cleanup;
 
+    /* QEMU allocated its memory by now */
+    qemuHugepagesCommit(driver, vm);
+
     if (qemuConnectAgent(driver, vm) < 0)
         goto cleanup;
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_MONITOR);
+
     VIR_DEBUG("Verifying and updating provided guest CPU");
     if (qemuProcessUpdateAndVerifyCPU(driver, vm, asyncJob) < 0)
         goto cleanup;
@@ -7217,8 +7780,10 @@ qemuProcessLaunch(virConnectPtr conn,
 
     /* Since CPUs were not started yet, the balloon could not return the memory
      * to the host and thus cur_balloon needs to be updated so that GetXMLdesc
-     * and friends return the correct size in case they can't grab the job */
+     * and friends return the correct size in case they can't grab the job.
+     * There's nothing to refresh if the balloon was left deflated. */
     if (!incoming && !snapshot &&
+        vm->def->mem.cur_balloon < virDomainDefGetMemoryTotal(vm->def) &&
         qemuProcessRefreshBalloonState(driver, vm, asyncJob) < 0)
         goto cleanup;
 
@@ -7230,6 +7795,8 @@ qemuProcessLaunch(virConnectPtr conn,
     if (qemuSnapshotCreateDisksTransient(vm, asyncJob) < 0)
         goto cleanup;
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_SETUP);
+
     ret = 0;
 
  cleanup:
@@ -7400,6 +7967,8 @@ qemuProcessStart(virConnectPtr conn,
             goto stop;
     }
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_REFRESH);
+
     if (qemuProcessFinishStartup(driver, vm, asyncJob,
                                  !(flags & VIR_QEMU_PROCESS_START_PAUSED),
                                  incoming ?
@@ -7407,6 +7976,9 @@ qemuProcessStart(virConnectPtr conn,
                                  VIR_DOMAIN_PAUSED_USER) < 0)
         goto stop;
 
+    qemuProcessStartPhaseEnd(vm, QEMU_DOMAIN_START_PHASE_FINISH);
+    qemuProcessStartPhaseReport(vm, asyncJob);
+
     if (!incoming) {
         /* Keep watching qemu log for errors during incoming migration, otherwise
          * unset reporting errors from qemu log. */
@@ -7658,8 +8230,12 @@ void qemuProcessStop(virQEMUDriverPtr driver,
         priv->monConfig = NULL;
     }
 
+    qemuProcessPressureWatchStop(vm);
     qemuDomainObjStopWorker(vm);
 
+    qemuProcessNUMAVcpusRelease(driver, vm);
+    qemuHugepagesRelease(driver, vm);
+
     /* Remove the master key */
     qemuDomainMasterKeyRemove(priv);
 
@@ -8354,6 +8930,12 @@ qemuProcessReconnect(void *opaque)
     if (qemuConnectCgroup(obj) < 0)
         goto error;
 
+    qemuProcessPressureWatchStart(driver, obj);
+    qemuProcessNUMAVcpusAccount(driver, obj);
+
+    if (qemuHugepagesReserve(driver, obj, true) < 0)
+        goto error;
+
     if (qemuDomainPerfRestart(obj) < 0)
         goto error;
 
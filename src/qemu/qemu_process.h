@@ -197,6 +197,9 @@ int qemuProcessSetupVcpu(virDomainObjPtr vm,
                          unsigned int vcpuid);
 int qemuProcessSetupIOThread(virDomainObjPtr vm,
                              virDomainIOThreadIDDefPtr iothread);
+int qemuProcessRepinNUMA(virQEMUDriverPtr driver,
+                         virDomainObjPtr vm,
+                         virBitmapPtr nodeset);
 
 int qemuRefreshVirtioChannelState(virQEMUDriverPtr driver,
                                   virDomainObjPtr vm,
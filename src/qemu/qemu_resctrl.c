@@ -0,0 +1,705 @@
+/*
+ * qemu_resctrl.c: QEMU resource control auto-tuning
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include "qemu_domain.h"
+#include "qemu_resctrl.h"
+#include "domain_event.h"
+#include "viralloc.h"
+#include "virerror.h"
+#include "virlog.h"
+#include "virresctrl.h"
+#include "virstring.h"
+#include "virthreadpool.h"
+#include "virtime.h"
+
+#define VIR_FROM_THIS VIR_FROM_QEMU
+
+VIR_LOG_INIT("qemu.qemu_resctrl");
+
+/*
+ * When resctrl_tune_interval is set in qemu.conf, a timer in the main event
+ * loop periodically queues a tuning pass to a dedicated single worker pool.
+ * A pass samples the resctrl monitoring data of the allocation group of
+ * every cachetune/memorytune of all running persistent domains, lets
+ * virResctrlTuneCache() and virResctrlTuneMemoryBandwidth() decide on new
+ * sizes for all allocations sharing a cache or a memory bandwidth
+ * controller and applies the changes one domain at a time under a modify
+ * job.
+ */
+
+/* Memory bandwidth counter of one allocation, kept between passes to
+ * compute the bandwidth used */
+typedef struct _qemuResctrlTuneCounter qemuResctrlTuneCounter;
+struct _qemuResctrlTuneCounter {
+    virResctrlAllocPtr alloc;
+    unsigned int id;
+    unsigned long long bytes;
+    unsigned long long when;
+    bool seen;
+};
+
+struct _qemuResctrlTune {
+    virQEMUDriverPtr driver;
+
+    /* Immutable after start */
+    int timer;
+    virThreadPoolPtr pool;
+
+    /* Only accessed by the worker of @pool */
+    qemuResctrlTuneCounter *counters;
+    size_t ncounters;
+    /* Highest total bandwidth seen on each memory bandwidth controller,
+     * in bytes per second */
+    unsigned long long *peaks;
+    size_t npeaks;
+};
+
+/* One allocation of a domain on one cache or memory bandwidth controller */
+typedef struct _qemuResctrlTuneItem qemuResctrlTuneItem;
+struct _qemuResctrlTuneItem {
+    virDomainObjPtr vm;
+    virResctrlAllocPtr alloc;
+    char *vcpus;
+    virDomainResctrlResource resource;
+    unsigned int level;
+    unsigned int id;
+    unsigned long long step;
+    bool grouped;
+    virResctrlTuneEntry entry;
+};
+
+
+static void
+qemuResctrlTuneItemClear(qemuResctrlTuneItem *item)
+{
+    virObjectUnref(item->alloc);
+    g_free(item->vcpus);
+}
+
+
+static void
+qemuResctrlTuneFree(qemuResctrlTunePtr tune)
+{
+    size_t i;
+
+    if (!tune)
+        return;
+
+    if (tune->timer >= 0)
+        virEventRemoveTimeout(tune->timer);
+
+    /* Waits for a pass in progress to finish */
+    virThreadPoolFree(tune->pool);
+
+    for (i = 0; i < tune->ncounters; i++)
+        virObjectUnref(tune->counters[i].alloc);
+    g_free(tune->counters);
+    g_free(tune->peaks);
+    g_free(tune);
+}
+
+
+/* Rounds @size down to a multiple of @step and clamps it to @min..@max */
+static unsigned long long
+qemuResctrlTuneBound(unsigned long long size,
+                     unsigned long long step,
+                     unsigned long long min,
+                     unsigned long long max)
+{
+    size -= size % step;
+
+    return MAX(MIN(size, max), min);
+}
+
+
+static virDomainResctrlDefPtr
+qemuResctrlTuneFindBase(virDomainDefPtr def,
+                        virDomainResctrlDefPtr resctrl)
+{
+    size_t i;
+
+    for (i = 0; i < def->nresctrls; i++) {
+        if (virBitmapEqual(def->resctrls[i]->vcpus, resctrl->vcpus))
+            return def->resctrls[i];
+    }
+
+    return NULL;
+}
+
+
+static virResctrlInfoPerCachePtr
+qemuResctrlTuneGetCacheControl(virCapsPtr caps,
+                               unsigned int level,
+                               unsigned int id,
+                               unsigned long long *size)
+{
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < caps->host.cache.nbanks; i++) {
+        virCapsHostCacheBankPtr bank = caps->host.cache.banks[i];
+
+        if (bank->level != level || bank->id != id)
+            continue;
+
+        for (j = 0; j < bank->ncontrols; j++) {
+            if (bank->controls[j]->scope == VIR_CACHE_TYPE_BOTH) {
+                *size = bank->size;
+                return bank->controls[j];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+
+static virResctrlInfoMemBWPerNodePtr
+qemuResctrlTuneGetMemBWControl(virCapsPtr caps,
+                               unsigned int id)
+{
+    size_t i;
+
+    for (i = 0; i < caps->host.memBW.nnodes; i++) {
+        if (caps->host.memBW.nodes[i]->id == id)
+            return &caps->host.memBW.nodes[i]->control;
+    }
+
+    return NULL;
+}
+
+
+/* Returns the bandwidth used by @alloc on controller @id since the last
+ * pass in bytes per second, or false if this is the first sample */
+static bool
+qemuResctrlTuneGetRate(qemuResctrlTunePtr tune,
+                       virResctrlAllocPtr alloc,
+                       unsigned int id,
+                       unsigned long long bytes,
+                       unsigned long long now,
+                       unsigned long long *rate)
+{
+    qemuResctrlTuneCounter *counter = NULL;
+    bool ret = false;
+    size_t i;
+
+    for (i = 0; i < tune->ncounters; i++) {
+        if (tune->counters[i].alloc == alloc && tune->counters[i].id == id) {
+            counter = &tune->counters[i];
+            break;
+        }
+    }
+
+    if (!counter) {
+        qemuResctrlTuneCounter tmp = { .alloc = virObjectRef(alloc), .id = id };
+
+        ignore_value(VIR_APPEND_ELEMENT(tune->counters, tune->ncounters, tmp));
+        counter = &tune->counters[tune->ncounters - 1];
+    } else if (now > counter->when && bytes >= counter->bytes) {
+        *rate = (bytes - counter->bytes) * 1000 / (now - counter->when);
+        ret = true;
+    }
+
+    counter->bytes = bytes;
+    counter->when = now;
+    counter->seen = true;
+
+    return ret;
+}
+
+
+/* Drops the counters of allocations which are gone */
+static void
+qemuResctrlTuneForgetCounters(qemuResctrlTunePtr tune)
+{
+    size_t i = 0;
+
+    while (i < tune->ncounters) {
+        if (!tune->counters[i].seen) {
+            virObjectUnref(tune->counters[i].alloc);
+            VIR_DELETE_ELEMENT(tune->counters, i, tune->ncounters);
+            continue;
+        }
+
+        tune->counters[i++].seen = false;
+    }
+}
+
+
+static void
+qemuResctrlTuneAddItem(qemuResctrlTuneItem **items,
+                       size_t *nitems,
+                       virDomainObjPtr vm,
+                       virDomainResctrlDefPtr resctrl,
+                       virDomainResctrlResource resource,
+                       unsigned int level,
+                       unsigned int id,
+                       unsigned long long step,
+                       virResctrlTuneEntryPtr entry)
+{
+    qemuResctrlTuneItem item = {
+        .vm = vm,
+        .alloc = virObjectRef(resctrl->alloc),
+        .vcpus = virBitmapFormat(resctrl->vcpus),
+        .resource = resource,
+        .level = level,
+        .id = id,
+        .step = step,
+        .entry = *entry,
+    };
+
+    ignore_value(VIR_APPEND_ELEMENT(*items, *nitems, item));
+}
+
+
+static void
+qemuResctrlTuneCollectCache(virQEMUDriverConfigPtr cfg,
+                            virCapsPtr caps,
+                            virDomainObjPtr vm,
+                            virDomainResctrlDefPtr resctrl,
+                            virDomainResctrlDefPtr base,
+                            qemuResctrlTuneItem **items,
+                            size_t *nitems)
+{
+    virResctrlInfoMonPtr monitor = caps->host.cache.monitor;
+    const char *features[] = { "llc_occupancy", NULL };
+    virResctrlMonitorStatsPtr *stats = NULL;
+    size_t nstats = 0;
+    size_t i;
+
+    if (!monitor ||
+        !virStringListHasString((const char **)monitor->features, features[0]))
+        return;
+
+    if (virResctrlAllocGetStats(resctrl->alloc, features, &stats, &nstats) < 0) {
+        VIR_DEBUG("Unable to read cache occupancy of domain %s: %s",
+                  vm->def->name, virGetLastErrorMessage());
+        virResetLastError();
+        goto cleanup;
+    }
+
+    for (i = 0; i < nstats; i++) {
+        virResctrlInfoPerCachePtr control = NULL;
+        virResctrlTuneEntry entry = { 0 };
+        unsigned long long cachesize = 0;
+        unsigned long long basesize = 0;
+        unsigned long long min;
+        unsigned long long max;
+
+        if (!virResctrlAllocGetCacheSize(resctrl->alloc, monitor->cache_level,
+                                         VIR_CACHE_TYPE_BOTH, stats[i]->id,
+                                         &entry.size) ||
+            !virResctrlAllocGetCacheSize(base->alloc, monitor->cache_level,
+                                         VIR_CACHE_TYPE_BOTH, stats[i]->id,
+                                         &basesize))
+            continue;
+
+        if (!(control = qemuResctrlTuneGetCacheControl(caps, monitor->cache_level,
+                                                       stats[i]->id, &cachesize)) ||
+            control->granularity == 0)
+            continue;
+
+        /* The whole cache can never be allocated */
+        min = MAX(control->min, control->granularity);
+        max = cachesize - control->granularity;
+
+        entry.usage = stats[i]->vals[0];
+        entry.min = qemuResctrlTuneBound(basesize * cfg->resctrlTuneMin / 100,
+                                         control->granularity, min, max);
+        entry.max = qemuResctrlTuneBound(basesize * cfg->resctrlTuneMax / 100,
+                                         control->granularity, min, max);
+
+        qemuResctrlTuneAddItem(items, nitems, vm, resctrl,
+                               VIR_DOMAIN_RESCTRL_RESOURCE_CACHE,
+                               monitor->cache_level, stats[i]->id,
+                               control->granularity, &entry);
+    }
+
+ cleanup:
+    for (i = 0; i < nstats; i++)
+        virResctrlMonitorStatsFree(stats[i]);
+    g_free(stats);
+}
+
+
+static void
+qemuResctrlTuneCollectMemBW(qemuResctrlTunePtr tune,
+                            virQEMUDriverConfigPtr cfg,
+                            virCapsPtr caps,
+                            virDomainObjPtr vm,
+                            virDomainResctrlDefPtr resctrl,
+                            virDomainResctrlDefPtr base,
+                            qemuResctrlTuneItem **items,
+                            size_t *nitems)
+{
+    virResctrlInfoMonPtr monitor = caps->host.memBW.monitor;
+    const char *features[] = { "mbm_total_bytes", NULL };
+    virResctrlMonitorStatsPtr *stats = NULL;
+    unsigned long long now = 0;
+    size_t nstats = 0;
+    size_t i;
+
+    if (!monitor ||
+        !virStringListHasString((const char **)monitor->features, features[0]))
+        return;
+
+    if (virResctrlAllocGetStats(resctrl->alloc, features, &stats, &nstats) < 0 ||
+        virTimeMillisNow(&now) < 0) {
+        VIR_DEBUG("Unable to read memory bandwidth of domain %s: %s",
+                  vm->def->name, virGetLastErrorMessage());
+        virResetLastError();
+        goto cleanup;
+    }
+
+    for (i = 0; i < nstats; i++) {
+        virResctrlInfoMemBWPerNodePtr control = NULL;
+        virResctrlTuneEntry entry = { 0 };
+        unsigned int bandwidth = 0;
+        unsigned int basebandwidth = 0;
+        unsigned long long min;
+
+        if (!virResctrlAllocGetMemoryBandwidth(resctrl->alloc, stats[i]->id,
+                                               &bandwidth) ||
+            !virResctrlAllocGetMemoryBandwidth(base->alloc, stats[i]->id,
+                                               &basebandwidth))
+            continue;
+
+        if (!(control = qemuResctrlTuneGetMemBWControl(caps, stats[i]->id)) ||
+            control->granularity == 0)
+            continue;
+
+        if (!qemuResctrlTuneGetRate(tune, resctrl->alloc, stats[i]->id,
+                                    stats[i]->vals[0], now, &entry.usage))
+            continue;
+
+        min = MAX(control->min, control->granularity);
+
+        entry.size = bandwidth;
+        entry.min = qemuResctrlTuneBound(basebandwidth * cfg->resctrlTuneMin / 100,
+                                         control->granularity, min, 100);
+        entry.max = qemuResctrlTuneBound(basebandwidth * cfg->resctrlTuneMax / 100,
+                                         control->granularity, min, 100);
+
+        qemuResctrlTuneAddItem(items, nitems, vm, resctrl,
+                               VIR_DOMAIN_RESCTRL_RESOURCE_MEMORY_BANDWIDTH,
+                               0, stats[i]->id, control->granularity, &entry);
+    }
+
+ cleanup:
+    for (i = 0; i < nstats; i++)
+        virResctrlMonitorStatsFree(stats[i]);
+    g_free(stats);
+}
+
+
+/* Samples all allocations of @vm, which must be locked. Only persistent
+ * domains are tuned, as the bounds are relative to their persistent
+ * definition. */
+static void
+qemuResctrlTuneCollect(qemuResctrlTunePtr tune,
+                       virQEMUDriverConfigPtr cfg,
+                       virCapsPtr caps,
+                       virDomainObjPtr vm,
+                       qemuResctrlTuneItem **items,
+                       size_t *nitems)
+{
+    size_t i;
+
+    if (!virDomainObjIsActive(vm) || !vm->newDef)
+        return;
+
+    for (i = 0; i < vm->def->nresctrls; i++) {
+        virDomainResctrlDefPtr resctrl = vm->def->resctrls[i];
+        virDomainResctrlDefPtr base = NULL;
+
+        if (!resctrl->alloc || virResctrlAllocIsEmpty(resctrl->alloc))
+            continue;
+
+        if (!(base = qemuResctrlTuneFindBase(vm->newDef, resctrl)))
+            continue;
+
+        qemuResctrlTuneCollectCache(cfg, caps, vm, resctrl, base, items, nitems);
+        qemuResctrlTuneCollectMemBW(tune, cfg, caps, vm, resctrl, base,
+                                    items, nitems);
+    }
+}
+
+
+/* Decides on new sizes for all items sharing a cache or a memory
+ * bandwidth controller with @items[@first] */
+static void
+qemuResctrlTuneDecide(qemuResctrlTunePtr tune,
+                      virCapsPtr caps,
+                      qemuResctrlTuneItem *items,
+                      size_t nitems,
+                      size_t first)
+{
+    qemuResctrlTuneItem *item = &items[first];
+    g_autofree virResctrlTuneEntry *entries = g_new0(virResctrlTuneEntry, nitems);
+    g_autofree size_t *indexes = g_new0(size_t, nitems);
+    size_t nentries = 0;
+    size_t i;
+
+    for (i = first; i < nitems; i++) {
+        if (items[i].resource != item->resource ||
+            items[i].level != item->level ||
+            items[i].id != item->id)
+            continue;
+
+        items[i].grouped = true;
+        entries[nentries] = items[i].entry;
+        indexes[nentries++] = i;
+    }
+
+    if (item->resource == VIR_DOMAIN_RESCTRL_RESOURCE_CACHE) {
+        unsigned long long avail = 0;
+
+        if (virResctrlAllocGetUnusedCacheSize(caps->host.resctrl, item->level,
+                                              VIR_CACHE_TYPE_BOTH, item->id,
+                                              &avail) < 0) {
+            VIR_DEBUG("Unable to get unused size of cache %u: %s",
+                      item->id, virGetLastErrorMessage());
+            virResetLastError();
+        }
+
+        virResctrlTuneCache(entries, nentries, avail, item->step);
+    } else {
+        unsigned long long total = 0;
+
+        for (i = 0; i < nentries; i++)
+            total += entries[i].usage;
+
+        if (item->id >= tune->npeaks)
+            ignore_value(VIR_EXPAND_N(tune->peaks, tune->npeaks,
+                                      item->id - tune->npeaks + 1));
+
+        tune->peaks[item->id] = MAX(tune->peaks[item->id], total);
+
+        virResctrlTuneMemoryBandwidth(entries, nentries,
+                                      tune->peaks[item->id], item->step);
+    }
+
+    for (i = 0; i < nentries; i++)
+        items[indexes[i]].entry.target = entries[i].target;
+}
+
+
+static void
+qemuResctrlTuneApply(virQEMUDriverPtr driver,
+                     virQEMUDriverConfigPtr cfg,
+                     virCapsPtr caps,
+                     qemuResctrlTuneItem *item)
+{
+    virDomainObjPtr vm = item->vm;
+    virObjectEventPtr event = NULL;
+    size_t i;
+    int rc;
+
+    virObjectLock(vm);
+
+    if (qemuDomainObjBeginJob(driver, vm, QEMU_JOB_MODIFY) < 0) {
+        virResetLastError();
+        goto cleanup;
+    }
+
+    if (!virDomainObjIsActive(vm))
+        goto endjob;
+
+    /* The domain may have been restarted in the meantime */
+    for (i = 0; i < vm->def->nresctrls; i++) {
+        if (vm->def->resctrls[i]->alloc == item->alloc)
+            break;
+    }
+
+    if (i == vm->def->nresctrls)
+        goto endjob;
+
+    if (item->resource == VIR_DOMAIN_RESCTRL_RESOURCE_CACHE)
+        rc = virResctrlAllocResizeCache(caps->host.resctrl, item->alloc,
+                                        item->level, VIR_CACHE_TYPE_BOTH,
+                                        item->id, item->entry.target);
+    else
+        rc = virResctrlAllocResizeMemoryBandwidth(caps->host.resctrl, item->alloc,
+                                                  item->id, item->entry.target);
+
+    if (rc < 0) {
+        VIR_DEBUG("Unable to resize allocation of vcpus %s of domain %s: %s",
+                  item->vcpus, vm->def->name, virGetLastErrorMessage());
+        virResetLastError();
+        goto endjob;
+    }
+
+    VIR_DEBUG("Resized %s allocation of vcpus %s of domain %s on %u from %llu to %llu",
+              item->resource == VIR_DOMAIN_RESCTRL_RESOURCE_CACHE ?
+              "cache" : "memory bandwidth",
+              item->vcpus, vm->def->name, item->id,
+              item->entry.size, item->entry.target);
+
+    event = virDomainEventResctrlTuneNewFromObj(vm, item->resource, item->vcpus,
+                                                item->id, item->entry.target);
+
+    if (virDomainObjSave(vm, driver->xmlopt, cfg->stateDir) < 0)
+        VIR_WARN("Failed to save status on vm %s", vm->def->name);
+
+ endjob:
+    qemuDomainObjEndJob(driver, vm);
+ cleanup:
+    virObjectUnlock(vm);
+    virObjectEventStateQueue(driver->domainEventState, event);
+}
+
+
+static void
+qemuResctrlTuneRun(void *jobdata G_GNUC_UNUSED,
+                   void *opaque)
+{
+    qemuResctrlTunePtr tune = opaque;
+    virQEMUDriverPtr driver = tune->driver;
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    g_autoptr(virCaps) caps = NULL;
+    virDomainObjPtr *vms = NULL;
+    size_t nvms = 0;
+    qemuResctrlTuneItem *items = NULL;
+    size_t nitems = 0;
+    size_t i;
+
+    if (!(caps = virQEMUDriverGetCapabilities(driver, false))) {
+        VIR_WARN("Unable to get host capabilities: %s",
+                 virGetLastErrorMessage());
+        virResetLastError();
+        return;
+    }
+
+    if (virDomainObjListCollect(driver->domains, NULL, &vms, &nvms, NULL,
+                                VIR_CONNECT_LIST_DOMAINS_ACTIVE |
+                                VIR_CONNECT_LIST_DOMAINS_PERSISTENT) < 0) {
+        virResetLastError();
+        return;
+    }
+
+    for (i = 0; i < nvms; i++) {
+        virObjectLock(vms[i]);
+        qemuResctrlTuneCollect(tune, cfg, caps, vms[i], &items, &nitems);
+        virObjectUnlock(vms[i]);
+    }
+
+    qemuResctrlTuneForgetCounters(tune);
+
+    for (i = 0; i < nitems; i++) {
+        if (!items[i].grouped)
+            qemuResctrlTuneDecide(tune, caps, items, nitems, i);
+    }
+
+    /* Shrink first so that the ways (or bandwidth) released are already
+     * free when the allocations which grow into them are resized */
+    for (i = 0; i < nitems; i++) {
+        if (items[i].entry.target < items[i].entry.size)
+            qemuResctrlTuneApply(driver, cfg, caps, &items[i]);
+    }
+
+    for (i = 0; i < nitems; i++) {
+        if (items[i].entry.target > items[i].entry.size)
+            qemuResctrlTuneApply(driver, cfg, caps, &items[i]);
+    }
+
+    for (i = 0; i < nitems; i++)
+        qemuResctrlTuneItemClear(&items[i]);
+    g_free(items);
+    virObjectListFreeCount(vms, nvms);
+}
+
+
+static void
+qemuResctrlTuneTimer(int timer G_GNUC_UNUSED,
+                     void *opaque)
+{
+    qemuResctrlTunePtr tune = opaque;
+
+    /* Don't pile up passes if one takes longer than the interval */
+    if (virThreadPoolGetJobQueueDepth(tune->pool) > 0)
+        return;
+
+    if (virThreadPoolSendJob(tune->pool, 0, tune) < 0) {
+        VIR_WARN("Unable to queue resctrl tuning: %s",
+                 virGetLastErrorMessage());
+        virResetLastError();
+    }
+}
+
+
+/**
+ * qemuResctrlTuneStart:
+ * @driver: qemu driver data
+ *
+ * Starts periodic auto-tuning of resctrl allocations of running domains
+ * if enabled in qemu.conf. Hosts without resctrl monitoring are skipped
+ * with a warning.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+qemuResctrlTuneStart(virQEMUDriverPtr driver)
+{
+    g_autoptr(virQEMUDriverConfig) cfg = virQEMUDriverGetConfig(driver);
+    g_autoptr(virCaps) caps = NULL;
+    qemuResctrlTunePtr tune = NULL;
+
+    if (cfg->resctrlTuneInterval == 0)
+        return 0;
+
+    if (!(caps = virQEMUDriverGetCapabilities(driver, false)))
+        return -1;
+
+    if (!caps->host.cache.monitor && !caps->host.memBW.monitor) {
+        VIR_WARN("resctrl_tune_interval is set, but the host doesn't support "
+                 "resctrl monitoring");
+        return 0;
+    }
+
+    tune = g_new0(qemuResctrlTune, 1);
+    tune->driver = driver;
+    tune->timer = -1;
+
+    if (!(tune->pool = virThreadPoolNewFull(0, 1, 0, qemuResctrlTuneRun,
+                                            "qemu-resctrl-tune", tune)))
+        goto error;
+
+    if ((tune->timer = virEventAddTimeout(cfg->resctrlTuneInterval * 1000,
+                                          qemuResctrlTuneTimer,
+                                          tune, NULL)) < 0) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       _("Unable to add resctrl tuning timer"));
+        goto error;
+    }
+
+    driver->resctrlTune = tune;
+    return 0;
+
+ error:
+    qemuResctrlTuneFree(tune);
+    return -1;
+}
+
+
+void
+qemuResctrlTuneStop(virQEMUDriverPtr driver)
+{
+    qemuResctrlTuneFree(g_steal_pointer(&driver->resctrlTune));
+}
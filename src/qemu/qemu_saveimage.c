@@ -49,6 +49,7 @@ typedef enum {
      */
     QEMU_SAVE_FORMAT_XZ = 3,
     QEMU_SAVE_FORMAT_LZOP = 4,
+    QEMU_SAVE_FORMAT_ZSTD = 5,
     /* Note: add new members only at the end.
        These values are used in the on-disk format.
        Do not change or re-use numbers. */
@@ -64,6 +65,7 @@ VIR_ENUM_IMPL(qemuSaveCompression,
               "bzip2",
               "xz",
               "lzop",
+              "zstd",
 );
 
 static inline void
@@ -227,11 +229,42 @@ virQEMUSaveDataFinish(virQEMUSaveDataPtr data,
 }
 
 
+/* qemuSaveImageFindCompressionProgram:
+ * @compression: format of the image
+ * @parallel: set to true if the program splits the stream into
+ *            independently compressed chunks
+ *
+ * zstd images written by pzstd consist of independent frames which
+ * pzstd can also decompress on all host CPUs, while its output is
+ * still readable by plain zstd and vice versa. Prefer it if available.
+ *
+ * Returns the path to the program or NULL if it wasn't found.
+ */
+static char *
+qemuSaveImageFindCompressionProgram(virQEMUSaveFormat compression,
+                                    bool *parallel)
+{
+    char *path;
+
+    *parallel = false;
+
+    if (compression == QEMU_SAVE_FORMAT_ZSTD &&
+        (path = virFindFileInPath("pzstd"))) {
+        *parallel = true;
+        return path;
+    }
+
+    return virFindFileInPath(qemuSaveCompressionTypeToString(compression));
+}
+
+
 static virCommandPtr
 qemuSaveImageGetCompressionCommand(virQEMUSaveFormat compression)
 {
     virCommandPtr ret = NULL;
     const char *prog = qemuSaveCompressionTypeToString(compression);
+    g_autofree char *path = NULL;
+    bool parallel;
 
     if (!prog) {
         virReportError(VIR_ERR_OPERATION_FAILED,
@@ -240,6 +273,10 @@ qemuSaveImageGetCompressionCommand(virQEMUSaveFormat compression)
         return NULL;
     }
 
+    /* let virCommand report the missing program if there is none */
+    if ((path = qemuSaveImageFindCompressionProgram(compression, &parallel)))
+        prog = path;
+
     ret = virCommandNew(prog);
     virCommandAddArg(ret, "-dc");
 
@@ -296,7 +333,10 @@ qemuSaveImageCreate(virQEMUDriverPtr driver,
     if (virQEMUSaveDataWrite(data, fd, path) < 0)
         goto cleanup;
 
-    /* Perform the migration */
+    /* Perform the migration. There's no point in looking for zero pages
+     * in the stream here, QEMU already sends each of them as a single
+     * flagged page header without any data, which is also all that has
+     * to be read back for them on restore. */
     if (qemuMigrationSrcToFile(driver, vm, fd, compressor, asyncJob) < 0)
         goto cleanup;
 
@@ -359,7 +399,8 @@ qemuSaveImageGetCompressionProgram(const char *imageFormat,
                                    bool use_raw_on_fail)
 {
     int ret;
-    const char *prog;
+    g_autofree char *prog = NULL;
+    bool parallel;
 
     *compressor = NULL;
 
@@ -372,13 +413,16 @@ qemuSaveImageGetCompressionProgram(const char *imageFormat,
     if (ret == QEMU_SAVE_FORMAT_RAW)
         return QEMU_SAVE_FORMAT_RAW;
 
-    if (!(prog = virFindFileInPath(imageFormat)))
+    if (!(prog = qemuSaveImageFindCompressionProgram(ret, &parallel)))
         goto error;
 
     *compressor = virCommandNew(prog);
     virCommandAddArg(*compressor, "-c");
     if (ret == QEMU_SAVE_FORMAT_XZ)
         virCommandAddArg(*compressor, "-3");
+    /* plain zstd has to be asked to use more than one thread */
+    if (ret == QEMU_SAVE_FORMAT_ZSTD && !parallel)
+        virCommandAddArg(*compressor, "-T0");
 
     return ret;
 
@@ -236,6 +236,8 @@ qemuSnapshotCreateInactiveExternal(virQEMUDriverPtr driver,
         if (virCommandRun(cmd, NULL) < 0)
             goto cleanup;
 
+        virStorageFileMetadataCacheInvalidate(snapdisk->src->path);
+
         virCommandFree(cmd);
         cmd = NULL;
     }
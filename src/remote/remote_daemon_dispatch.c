@@ -1333,6 +1333,70 @@ remoteRelayDomainEventMemoryFailure(virConnectPtr conn,
 }
 
 
+static int
+remoteRelayDomainEventPressure(virConnectPtr conn,
+                               virDomainPtr dom,
+                               int resource,
+                               unsigned long long stall,
+                               unsigned long long window,
+                               void *opaque)
+{
+    daemonClientEventCallbackPtr callback = opaque;
+    remote_domain_event_pressure_msg data;
+
+    if (callback->callbackID < 0 ||
+        !remoteRelayDomainEventCheckACL(callback->client, conn, dom))
+        return -1;
+
+    /* build return data */
+    memset(&data, 0, sizeof(data));
+    data.callbackID = callback->callbackID;
+    data.resource = resource;
+    data.stall = stall;
+    data.window = window;
+    make_nonnull_domain(&data.dom, dom);
+
+    remoteDispatchObjectEventSend(callback->client, remoteProgram,
+                                  REMOTE_PROC_DOMAIN_EVENT_PRESSURE,
+                                  (xdrproc_t)xdr_remote_domain_event_pressure_msg, &data);
+
+    return 0;
+}
+
+
+static int
+remoteRelayDomainEventResctrlTune(virConnectPtr conn,
+                                  virDomainPtr dom,
+                                  int resource,
+                                  const char *vcpus,
+                                  unsigned int id,
+                                  unsigned long long value,
+                                  void *opaque)
+{
+    daemonClientEventCallbackPtr callback = opaque;
+    remote_domain_event_resctrl_tune_msg data;
+
+    if (callback->callbackID < 0 ||
+        !remoteRelayDomainEventCheckACL(callback->client, conn, dom))
+        return -1;
+
+    /* build return data */
+    memset(&data, 0, sizeof(data));
+    data.callbackID = callback->callbackID;
+    data.resource = resource;
+    data.vcpus = g_strdup(vcpus);
+    data.id = id;
+    data.value = value;
+    make_nonnull_domain(&data.dom, dom);
+
+    remoteDispatchObjectEventSend(callback->client, remoteProgram,
+                                  REMOTE_PROC_DOMAIN_EVENT_RESCTRL_TUNE,
+                                  (xdrproc_t)xdr_remote_domain_event_resctrl_tune_msg, &data);
+
+    return 0;
+}
+
+
 static virConnectDomainEventGenericCallback domainEventCallbacks[] = {
     VIR_DOMAIN_EVENT_CALLBACK(remoteRelayDomainEventLifecycle),
     VIR_DOMAIN_EVENT_CALLBACK(remoteRelayDomainEventReboot),
@@ -1360,6 +1424,8 @@ static virConnectDomainEventGenericCallback domainEventCallbacks[] = {
     VIR_DOMAIN_EVENT_CALLBACK(remoteRelayDomainEventMetadataChange),
     VIR_DOMAIN_EVENT_CALLBACK(remoteRelayDomainEventBlockThreshold),
     VIR_DOMAIN_EVENT_CALLBACK(remoteRelayDomainEventMemoryFailure),
+    VIR_DOMAIN_EVENT_CALLBACK(remoteRelayDomainEventPressure),
+    VIR_DOMAIN_EVENT_CALLBACK(remoteRelayDomainEventResctrlTune),
 };
 
 G_STATIC_ASSERT(G_N_ELEMENTS(domainEventCallbacks) == VIR_DOMAIN_EVENT_ID_LAST);
@@ -7463,3 +7529,81 @@ remoteDispatchDomainAuthorizedSshKeysSet(virNetServerPtr server G_GNUC_UNUSED,
 
     return rv;
 }
+
+static int
+remoteDispatchDomainMoveNumaNodes(virNetServerPtr server G_GNUC_UNUSED,
+                                  virNetServerClientPtr client,
+                                  virNetMessagePtr msg G_GNUC_UNUSED,
+                                  virNetMessageErrorPtr rerr,
+                                  remote_domain_move_numa_nodes_args *args,
+                                  remote_domain_move_numa_nodes_ret *ret)
+{
+    int rv = -1;
+    virConnectPtr conn = remoteGetHypervisorConn(client);
+    virDomainPtr dom = NULL;
+    virTypedParameterPtr params = NULL;
+    int nparams = 0;
+
+    if (!conn)
+        goto cleanup;
+
+    if (!(dom = get_nonnull_domain(conn, args->dom)))
+        goto cleanup;
+
+    if (virDomainMoveNumaNodes(dom, args->nodeset, &params, &nparams,
+                               args->flags) < 0)
+        goto cleanup;
+
+    if (virTypedParamsSerialize(params, nparams,
+                                REMOTE_DOMAIN_MOVE_NUMA_NODES_PARAMS_MAX,
+                                (virTypedParameterRemotePtr *) &ret->params.params_val,
+                                &ret->params.params_len,
+                                0) < 0)
+        goto cleanup;
+
+    rv = 0;
+
+ cleanup:
+    if (rv < 0)
+        virNetMessageSaveError(rerr);
+    virTypedParamsFree(params, nparams);
+    virObjectUnref(dom);
+
+    return rv;
+}
+
+static int
+remoteDispatchNodeGetAllStats(virNetServerPtr server G_GNUC_UNUSED,
+                              virNetServerClientPtr client,
+                              virNetMessagePtr msg G_GNUC_UNUSED,
+                              virNetMessageErrorPtr rerr,
+                              remote_node_get_all_stats_args *args,
+                              remote_node_get_all_stats_ret *ret)
+{
+    int rv = -1;
+    virConnectPtr conn = remoteGetHypervisorConn(client);
+    virTypedParameterPtr params = NULL;
+    int nparams = 0;
+
+    if (!conn)
+        goto cleanup;
+
+    if (virNodeGetAllStats(conn, &params, &nparams, args->flags) < 0)
+        goto cleanup;
+
+    if (virTypedParamsSerialize(params, nparams,
+                                REMOTE_NODE_ALL_STATS_MAX,
+                                (virTypedParameterRemotePtr *) &ret->params.params_val,
+                                &ret->params.params_len,
+                                0) < 0)
+        goto cleanup;
+
+    rv = 0;
+
+ cleanup:
+    if (rv < 0)
+        virNetMessageSaveError(rerr);
+    virTypedParamsFree(params, nparams);
+
+    return rv;
+}
@@ -409,6 +409,16 @@ remoteDomainBuildEventMemoryFailure(virNetClientProgramPtr prog,
                                     virNetClientPtr client,
                                     void *evdata, void *opaque);
 
+static void
+remoteDomainBuildEventPressure(virNetClientProgramPtr prog,
+                               virNetClientPtr client,
+                               void *evdata, void *opaque);
+
+static void
+remoteDomainBuildEventResctrlTune(virNetClientProgramPtr prog,
+                                  virNetClientPtr client,
+                                  void *evdata, void *opaque);
+
 static void
 remoteConnectNotifyEventConnectionClosed(virNetClientProgramPtr prog G_GNUC_UNUSED,
                                          virNetClientPtr client G_GNUC_UNUSED,
@@ -624,6 +634,14 @@ static virNetClientProgramEvent remoteEvents[] = {
       remoteDomainBuildEventMemoryFailure,
       sizeof(remote_domain_event_memory_failure_msg),
       (xdrproc_t)xdr_remote_domain_event_memory_failure_msg },
+    { REMOTE_PROC_DOMAIN_EVENT_PRESSURE,
+      remoteDomainBuildEventPressure,
+      sizeof(remote_domain_event_pressure_msg),
+      (xdrproc_t)xdr_remote_domain_event_pressure_msg },
+    { REMOTE_PROC_DOMAIN_EVENT_RESCTRL_TUNE,
+      remoteDomainBuildEventResctrlTune,
+      sizeof(remote_domain_event_resctrl_tune_msg),
+      (xdrproc_t)xdr_remote_domain_event_resctrl_tune_msg },
 };
 
 static void
@@ -5463,6 +5481,52 @@ remoteDomainBuildEventMemoryFailure(virNetClientProgramPtr prog G_GNUC_UNUSED,
 }
 
 
+static void
+remoteDomainBuildEventPressure(virNetClientProgramPtr prog G_GNUC_UNUSED,
+                               virNetClientPtr client G_GNUC_UNUSED,
+                               void *evdata, void *opaque)
+{
+    virConnectPtr conn = opaque;
+    remote_domain_event_pressure_msg *msg = evdata;
+    struct private_data *priv = conn->privateData;
+    virDomainPtr dom;
+    virObjectEventPtr event = NULL;
+
+    if (!(dom = get_nonnull_domain(conn, msg->dom)))
+        return;
+
+    event = virDomainEventPressureNewFromDom(dom, msg->resource,
+                                             msg->stall, msg->window);
+
+    virObjectUnref(dom);
+
+    virObjectEventStateQueueRemote(priv->eventState, event, msg->callbackID);
+}
+
+
+static void
+remoteDomainBuildEventResctrlTune(virNetClientProgramPtr prog G_GNUC_UNUSED,
+                                  virNetClientPtr client G_GNUC_UNUSED,
+                                  void *evdata, void *opaque)
+{
+    virConnectPtr conn = opaque;
+    remote_domain_event_resctrl_tune_msg *msg = evdata;
+    struct private_data *priv = conn->privateData;
+    virDomainPtr dom;
+    virObjectEventPtr event = NULL;
+
+    if (!(dom = get_nonnull_domain(conn, msg->dom)))
+        return;
+
+    event = virDomainEventResctrlTuneNewFromDom(dom, msg->resource, msg->vcpus,
+                                                msg->id, msg->value);
+
+    virObjectUnref(dom);
+
+    virObjectEventStateQueueRemote(priv->eventState, event, msg->callbackID);
+}
+
+
 static int
 remoteStreamSend(virStreamPtr st,
                  const char *data,
@@ -8098,6 +8162,91 @@ remoteDomainAuthorizedSSHKeysSet(virDomainPtr domain,
 }
 
 
+static int
+remoteDomainMoveNumaNodes(virDomainPtr dom,
+                          const char *nodeset,
+                          virTypedParameterPtr *params,
+                          int *nparams,
+                          unsigned int flags)
+{
+    int rv = -1;
+    struct private_data *priv = dom->conn->privateData;
+    remote_domain_move_numa_nodes_args args;
+    remote_domain_move_numa_nodes_ret ret;
+
+    remoteDriverLock(priv);
+
+    make_nonnull_domain(&args.dom, dom);
+    args.nodeset = (char *) nodeset;
+    args.flags = flags;
+
+    memset(&ret, 0, sizeof(ret));
+
+    if (call(dom->conn, priv, 0, REMOTE_PROC_DOMAIN_MOVE_NUMA_NODES,
+             (xdrproc_t)xdr_remote_domain_move_numa_nodes_args, (char *)&args,
+             (xdrproc_t)xdr_remote_domain_move_numa_nodes_ret, (char *)&ret) == -1)
+        goto done;
+
+    if (virTypedParamsDeserialize((virTypedParameterRemotePtr) ret.params.params_val,
+                                  ret.params.params_len,
+                                  REMOTE_DOMAIN_MOVE_NUMA_NODES_PARAMS_MAX,
+                                  params,
+                                  nparams) < 0)
+        goto cleanup;
+
+    rv = 0;
+
+ cleanup:
+    xdr_free((xdrproc_t)xdr_remote_domain_move_numa_nodes_ret,
+             (char *) &ret);
+
+ done:
+    remoteDriverUnlock(priv);
+    return rv;
+}
+
+
+static int
+remoteNodeGetAllStats(virConnectPtr conn,
+                      virTypedParameterPtr *params,
+                      int *nparams,
+                      unsigned int flags)
+{
+    int rv = -1;
+    struct private_data *priv = conn->privateData;
+    remote_node_get_all_stats_args args;
+    remote_node_get_all_stats_ret ret;
+
+    remoteDriverLock(priv);
+
+    args.flags = flags;
+
+    memset(&ret, 0, sizeof(ret));
+
+    if (call(conn, priv, 0, REMOTE_PROC_NODE_GET_ALL_STATS,
+             (xdrproc_t)xdr_remote_node_get_all_stats_args, (char *)&args,
+             (xdrproc_t)xdr_remote_node_get_all_stats_ret, (char *)&ret) == -1)
+        goto done;
+
+    if (virTypedParamsDeserialize((virTypedParameterRemotePtr) ret.params.params_val,
+                                  ret.params.params_len,
+                                  REMOTE_NODE_ALL_STATS_MAX,
+                                  params,
+                                  nparams) < 0)
+        goto cleanup;
+
+    rv = 0;
+
+ cleanup:
+    xdr_free((xdrproc_t)xdr_remote_node_get_all_stats_ret,
+             (char *) &ret);
+
+ done:
+    remoteDriverUnlock(priv);
+    return rv;
+}
+
+
 /* get_nonnull_domain and get_nonnull_network turn an on-wire
  * (name, uuid) pair into virDomainPtr or virNetworkPtr object.
  * These can return NULL if underlying memory allocations fail,
@@ -8531,6 +8680,8 @@ static virHypervisorDriver hypervisor_driver = {
     .domainBackupGetXMLDesc = remoteDomainBackupGetXMLDesc, /* 6.0.0 */
     .domainAuthorizedSSHKeysGet = remoteDomainAuthorizedSSHKeysGet, /* 6.10.0 */
     .domainAuthorizedSSHKeysSet = remoteDomainAuthorizedSSHKeysSet, /* 6.10.0 */
+    .domainMoveNumaNodes = remoteDomainMoveNumaNodes, /* 7.1.0 */
+    .nodeGetAllStats = remoteNodeGetAllStats, /* 7.1.0 */
 };
 
 static virNetworkDriver network_driver = {
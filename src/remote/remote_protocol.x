@@ -283,6 +283,12 @@ const REMOTE_NETWORK_PORT_PARAMETERS_MAX = 16;
 /* Upper limit on number of SSH keys */
 const REMOTE_DOMAIN_AUTHORIZED_SSH_KEYS_MAX = 2048;
 
+/* Upper limit on number of parameters describing a NUMA move */
+const REMOTE_DOMAIN_MOVE_NUMA_NODES_PARAMS_MAX = 16;
+
+/* Upper limit on number of node statistics returned at once */
+const REMOTE_NODE_ALL_STATS_MAX = 65536;
+
 
 /* UUID.  VIR_UUID_BUFLEN definition comes from libvirt.h */
 typedef opaque remote_uuid[VIR_UUID_BUFLEN];
@@ -3480,6 +3486,23 @@ struct remote_domain_event_memory_failure_msg {
     unsigned int flags;
 };
 
+struct remote_domain_event_pressure_msg {
+    int callbackID;
+    remote_nonnull_domain dom;
+    int resource;
+    unsigned hyper stall;
+    unsigned hyper window;
+};
+
+struct remote_domain_event_resctrl_tune_msg {
+    int callbackID;
+    remote_nonnull_domain dom;
+    int resource;
+    remote_nonnull_string vcpus;
+    unsigned int id;
+    unsigned hyper value;
+};
+
 struct remote_connect_secret_event_register_any_args {
     int eventID;
     remote_secret secret;
@@ -3799,6 +3822,24 @@ struct remote_domain_authorized_ssh_keys_set_args {
     unsigned int flags;
 };
 
+struct remote_domain_move_numa_nodes_args {
+    remote_nonnull_domain dom;
+    remote_nonnull_string nodeset;
+    unsigned int flags;
+};
+
+struct remote_domain_move_numa_nodes_ret {
+    remote_typed_param params<REMOTE_DOMAIN_MOVE_NUMA_NODES_PARAMS_MAX>;
+};
+
+struct remote_node_get_all_stats_args {
+    unsigned int flags;
+};
+
+struct remote_node_get_all_stats_ret {
+    remote_typed_param params<REMOTE_NODE_ALL_STATS_MAX>;
+};
+
 /*----- Protocol. -----*/
 
 /* Define the program number, protocol version and procedure numbers here. */
@@ -6714,5 +6755,30 @@ enum remote_procedure {
      * @generate: none
      * @acl: domain:write
      */
-    REMOTE_PROC_DOMAIN_AUTHORIZED_SSH_KEYS_SET = 425
+    REMOTE_PROC_DOMAIN_AUTHORIZED_SSH_KEYS_SET = 425,
+
+    /**
+     * @generate: both
+     * @acl: none
+     */
+    REMOTE_PROC_DOMAIN_EVENT_PRESSURE = 426,
+
+    /**
+     * @generate: none
+     * @acl: domain:write
+     */
+    REMOTE_PROC_DOMAIN_MOVE_NUMA_NODES = 427,
+
+    /**
+     * @generate: both
+     * @acl: none
+     */
+    REMOTE_PROC_DOMAIN_EVENT_RESCTRL_TUNE = 428,
+
+    /**
+     * @generate: none
+     * @priority: high
+     * @acl: connect:read
+     */
+    REMOTE_PROC_NODE_GET_ALL_STATS = 429
 };
@@ -81,6 +81,7 @@ struct _virSecurityDACChownItem {
     gid_t gid;
     bool remember; /* Whether owner remembering should be done for @path/@src */
     bool restore; /* Whether current operation is 'set' or 'restore' */
+    bool skip; /* Whether the item is redundant and shouldn't be processed */
 };
 
 typedef struct _virSecurityDACChownList virSecurityDACChownList;
@@ -200,6 +201,35 @@ static int virSecurityDACRestoreFileLabelInternal(virSecurityManagerPtr mgr,
                                                   const virStorageSource *src,
                                                   const char *path,
                                                   bool recall);
+
+
+static int
+virSecurityDACTransactionRunItem(size_t idx,
+                                 void *opaque)
+{
+    virSecurityDACChownListPtr list = opaque;
+    virSecurityDACChownItemPtr item = list->items[idx];
+    const bool remember = item->remember && list->lock;
+
+    if (item->skip)
+        return 0;
+
+    if (!item->restore) {
+        return virSecurityDACSetOwnership(list->manager,
+                                          item->src,
+                                          item->path,
+                                          item->uid,
+                                          item->gid,
+                                          remember);
+    }
+
+    return virSecurityDACRestoreFileLabelInternal(list->manager,
+                                                  item->src,
+                                                  item->path,
+                                                  remember);
+}
+
+
 /**
  * virSecurityDACTransactionRun:
  * @pid: process pid
@@ -208,7 +238,8 @@ static int virSecurityDACRestoreFileLabelInternal(virSecurityManagerPtr mgr,
  * This is the callback that runs in the same namespace as the domain we are
  * relabelling. For given transaction (@opaque) it relabels all the paths on
  * the list. Depending on security manager configuration it might lock paths
- * we will relabel.
+ * we will relabel. Unless some file is on the list more than once, the
+ * paths are relabelled in parallel.
  *
  * Returns: 0 on success
  *         -1 otherwise.
@@ -220,11 +251,53 @@ virSecurityDACTransactionRun(pid_t pid G_GNUC_UNUSED,
     virSecurityDACChownListPtr list = opaque;
     virSecurityManagerMetadataLockStatePtr state;
     const char **paths = NULL;
+    g_autofree const char **files = NULL;
+    g_autofree ssize_t *prev = NULL;
+    g_autofree bool *done = NULL;
     size_t npaths = 0;
+    size_t nskipped = 0;
+    bool sharedPaths = false;
     size_t i;
-    int rv = 0;
+    int rv;
     int ret = -1;
 
+    files = g_new0(const char *, list->nItems);
+    prev = g_new0(ssize_t, list->nItems);
+
+    for (i = 0; i < list->nItems; i++)
+        files[i] = list->items[i]->path;
+
+    virSecurityTransactionFindPrevious(files, list->nItems, prev);
+
+    /* Backing chains of different disks often share images. Setting the
+     * very same owner again is pointless, unless XATTRs are involved, as
+     * those are refcounted and must stay in balance. Items for the same
+     * file which differ must be processed in the original order, which
+     * rules out processing the transaction in parallel. */
+    for (i = 0; i < list->nItems; i++) {
+        virSecurityDACChownItemPtr item = list->items[i];
+        virSecurityDACChownItemPtr p;
+
+        if (prev[i] < 0)
+            continue;
+
+        p = list->items[prev[i]];
+
+        if (!item->remember && !p->remember &&
+            item->src == p->src &&
+            item->uid == p->uid &&
+            item->gid == p->gid &&
+            item->restore == p->restore) {
+            item->skip = true;
+            nskipped++;
+        } else {
+            sharedPaths = true;
+        }
+    }
+
+    VIR_DEBUG("Relabeling %zu paths, %zu redundant items skipped",
+              list->nItems - nskipped, nskipped);
+
     if (list->lock) {
         paths = g_new0(const char *, list->nItems);
 
@@ -254,32 +327,19 @@ virSecurityDACTransactionRun(pid_t pid G_GNUC_UNUSED,
         }
     }
 
-    for (i = 0; i < list->nItems; i++) {
-        virSecurityDACChownItemPtr item = list->items[i];
-        const bool remember = item->remember && list->lock;
-
-        if (!item->restore) {
-            rv = virSecurityDACSetOwnership(list->manager,
-                                            item->src,
-                                            item->path,
-                                            item->uid,
-                                            item->gid,
-                                            remember);
-        } else {
-            rv = virSecurityDACRestoreFileLabelInternal(list->manager,
-                                                        item->src,
-                                                        item->path,
-                                                        remember);
-        }
+    done = g_new0(bool, list->nItems);
 
-        if (rv < 0)
-            break;
-    }
+    rv = virSecurityTransactionRunItems(list->nItems, !sharedPaths,
+                                        virSecurityDACTransactionRunItem,
+                                        list, done);
 
-    for (; rv < 0 && i > 0; i--) {
+    for (i = list->nItems; rv < 0 && i > 0; i--) {
         virSecurityDACChownItemPtr item = list->items[i - 1];
         const bool remember = item->remember && list->lock;
 
+        if (!done[i - 1] || item->skip)
+            continue;
+
         if (!item->restore) {
             virSecurityDACRestoreFileLabelInternal(list->manager,
                                                    item->src,
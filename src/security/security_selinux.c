@@ -79,6 +79,7 @@ struct _virSecuritySELinuxContextItem {
     char *tcon;
     bool remember; /* Whether owner remembering should be done for @path/@src */
     bool restore; /* Whether current operation is 'set' or 'restore' */
+    bool skip; /* Whether the item is redundant and shouldn't be processed */
 };
 
 typedef struct _virSecuritySELinuxContextList virSecuritySELinuxContextList;
@@ -87,6 +88,7 @@ struct _virSecuritySELinuxContextList {
     virSecurityManagerPtr manager;
     virSecuritySELinuxContextItemPtr *items;
     size_t nItems;
+    bool restore; /* Whether some item restores a label */
     bool lock;
 };
 
@@ -123,6 +125,9 @@ virSecuritySELinuxContextListAppend(virSecuritySELinuxContextListPtr list,
     int ret = -1;
     virSecuritySELinuxContextItemPtr item = NULL;
 
+    if (restore)
+        list->restore = true;
+
     item = g_new0(virSecuritySELinuxContextItem, 1);
 
     item->path = g_strdup(path);
@@ -232,6 +237,30 @@ static int virSecuritySELinuxRestoreFileLabel(virSecurityManagerPtr mgr,
                                               bool recall);
 
 
+static int
+virSecuritySELinuxTransactionRunItem(size_t idx,
+                                     void *opaque)
+{
+    virSecuritySELinuxContextListPtr list = opaque;
+    virSecuritySELinuxContextItemPtr item = list->items[idx];
+    const bool remember = item->remember && list->lock;
+
+    if (item->skip)
+        return 0;
+
+    if (!item->restore) {
+        return virSecuritySELinuxSetFilecon(list->manager,
+                                            item->path,
+                                            item->tcon,
+                                            remember);
+    }
+
+    return virSecuritySELinuxRestoreFileLabel(list->manager,
+                                              item->path,
+                                              remember);
+}
+
+
 /**
  * virSecuritySELinuxTransactionRun:
  * @pid: process pid
@@ -239,7 +268,10 @@ static int virSecuritySELinuxRestoreFileLabel(virSecurityManagerPtr mgr,
  *
  * This is the callback that runs in the same namespace as the domain we are
  * relabelling. For given transaction (@opaque) it relabels all the paths on
- * the list.
+ * the list. Labels are set in parallel unless some file is on the list more
+ * than once. Restoring labels looks up the default context through the
+ * shared selabel handle which is not safe to use from multiple threads,
+ * therefore transactions restoring labels are processed sequentially.
  *
  * Returns: 0 on success
  *         -1 otherwise.
@@ -251,11 +283,47 @@ virSecuritySELinuxTransactionRun(pid_t pid G_GNUC_UNUSED,
     virSecuritySELinuxContextListPtr list = opaque;
     virSecurityManagerMetadataLockStatePtr state;
     const char **paths = NULL;
+    g_autofree const char **files = NULL;
+    g_autofree ssize_t *prev = NULL;
+    g_autofree bool *done = NULL;
     size_t npaths = 0;
+    size_t nskipped = 0;
+    bool sharedPaths = false;
     size_t i;
     int rv;
     int ret = -1;
 
+    files = g_new0(const char *, list->nItems);
+    prev = g_new0(ssize_t, list->nItems);
+
+    for (i = 0; i < list->nItems; i++)
+        files[i] = list->items[i]->path;
+
+    virSecurityTransactionFindPrevious(files, list->nItems, prev);
+
+    /* See virSecurityDACTransactionRun() for the rationale. */
+    for (i = 0; i < list->nItems; i++) {
+        virSecuritySELinuxContextItemPtr item = list->items[i];
+        virSecuritySELinuxContextItemPtr p;
+
+        if (prev[i] < 0)
+            continue;
+
+        p = list->items[prev[i]];
+
+        if (!item->remember && !p->remember &&
+            STREQ_NULLABLE(item->tcon, p->tcon) &&
+            item->restore == p->restore) {
+            item->skip = true;
+            nskipped++;
+        } else {
+            sharedPaths = true;
+        }
+    }
+
+    VIR_DEBUG("Relabeling %zu paths, %zu redundant items skipped",
+              list->nItems - nskipped, nskipped);
+
     if (list->lock) {
         paths = g_new0(const char *, list->nItems);
 
@@ -285,30 +353,20 @@ virSecuritySELinuxTransactionRun(pid_t pid G_GNUC_UNUSED,
         }
     }
 
-    rv = 0;
-    for (i = 0; i < list->nItems; i++) {
-        virSecuritySELinuxContextItemPtr item = list->items[i];
-        const bool remember = item->remember && list->lock;
+    done = g_new0(bool, list->nItems);
 
-        if (!item->restore) {
-            rv = virSecuritySELinuxSetFilecon(list->manager,
-                                              item->path,
-                                              item->tcon,
-                                              remember);
-        } else {
-            rv = virSecuritySELinuxRestoreFileLabel(list->manager,
-                                                    item->path,
-                                                    remember);
-        }
+    rv = virSecurityTransactionRunItems(list->nItems,
+                                        !sharedPaths && !list->restore,
+                                        virSecuritySELinuxTransactionRunItem,
+                                        list, done);
 
-        if (rv < 0)
-            break;
-    }
-
-    for (; rv < 0 && i > 0; i--) {
+    for (i = list->nItems; rv < 0 && i > 0; i--) {
         virSecuritySELinuxContextItemPtr item = list->items[i - 1];
         const bool remember = item->remember && list->lock;
 
+        if (!done[i - 1] || item->skip)
+            continue;
+
         if (!item->restore) {
             virSecuritySELinuxRestoreFileLabel(list->manager,
                                                item->path,
@@ -25,6 +25,8 @@
 #include "virlog.h"
 #include "viruuid.h"
 #include "virhostuptime.h"
+#include "virthread.h"
+#include "virtime.h"
 
 #include "security_util.h"
 
@@ -545,3 +547,194 @@ virSecurityMoveRememberedLabel(const char *name,
 
     return 0;
 }
+
+
+/**
+ * virSecurityTransactionFindPrevious:
+ * @paths: paths touched by the items of a transaction, may contain NULLs
+ * @npaths: number of items in @paths
+ * @prev: array of @npaths indexes to fill
+ *
+ * For each item of a relabel transaction finds the closest preceding item
+ * which touches the same file and stores its index into @prev, or -1 if
+ * there's none. Files are identified by their device and inode numbers so
+ * that different paths leading to the same file (symlinks, bind mounts)
+ * are recognized. Paths which can't be stat()-ed are compared by name.
+ * This has to be called from the namespace the transaction runs in.
+ */
+void
+virSecurityTransactionFindPrevious(const char **paths,
+                                   size_t npaths,
+                                   ssize_t *prev)
+{
+    g_autofree struct stat *sb = g_new0(struct stat, npaths);
+    g_autofree bool *valid = g_new0(bool, npaths);
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < npaths; i++) {
+        if (paths[i] && stat(paths[i], &sb[i]) == 0)
+            valid[i] = true;
+    }
+
+    for (i = 0; i < npaths; i++) {
+        prev[i] = -1;
+
+        if (!paths[i])
+            continue;
+
+        for (j = i; j > 0; j--) {
+            if (!paths[j - 1])
+                continue;
+
+            if (valid[i] && valid[j - 1]) {
+                if (sb[i].st_dev != sb[j - 1].st_dev ||
+                    sb[i].st_ino != sb[j - 1].st_ino)
+                    continue;
+            } else if (STRNEQ(paths[i], paths[j - 1])) {
+                continue;
+            }
+
+            prev[i] = j - 1;
+            break;
+        }
+    }
+}
+
+
+/* Don't bother spawning threads for short transactions */
+#define VIR_SECURITY_TRANSACTION_PARALLEL_MIN 8
+#define VIR_SECURITY_TRANSACTION_WORKERS 8
+
+typedef struct _virSecurityTransactionRunData virSecurityTransactionRunData;
+struct _virSecurityTransactionRunData {
+    virSecurityTransactionItemFunc func;
+    void *opaque;
+    size_t nitems;
+    bool *done;
+
+    int next; /* atomic, index of the next item to process */
+    int failed; /* atomic, set once any item failed */
+
+    virMutex lock;
+    virErrorPtr err; /* error of the first failed item */
+};
+
+
+static void
+virSecurityTransactionRunWorker(void *opaque)
+{
+    virSecurityTransactionRunData *data = opaque;
+    size_t i;
+
+    while (!g_atomic_int_get(&data->failed) &&
+           (i = g_atomic_int_add(&data->next, 1)) < data->nitems) {
+        if (data->func(i, data->opaque) < 0) {
+            /* errors are thread local, hand the first one over */
+            virMutexLock(&data->lock);
+            if (!data->err)
+                virErrorPreserveLast(&data->err);
+            virMutexUnlock(&data->lock);
+
+            g_atomic_int_set(&data->failed, 1);
+            continue;
+        }
+
+        data->done[i] = true;
+    }
+}
+
+
+/**
+ * virSecurityTransactionRunItems:
+ * @nitems: number of items in the transaction
+ * @parallel: whether items can be processed concurrently
+ * @func: callback processing one item
+ * @opaque: opaque data passed to @func
+ * @done: array of @nitems booleans
+ *
+ * Calls @func for each item of a relabel transaction and sets the
+ * corresponding member of @done for each item that was processed
+ * successfully. If @parallel is true, the items don't depend on each
+ * other and there's enough of them, they are spread over a few worker
+ * threads. No new items are started once an item fails, so that the
+ * caller can roll back the ones marked in @done.
+ *
+ * Returns: 0 on success,
+ *         -1 otherwise (with the error of the failed item reported).
+ */
+int
+virSecurityTransactionRunItems(size_t nitems,
+                               bool parallel,
+                               virSecurityTransactionItemFunc func,
+                               void *opaque,
+                               bool *done)
+{
+    virSecurityTransactionRunData data = { 0 };
+    virThread workers[VIR_SECURITY_TRANSACTION_WORKERS - 1];
+    size_t nworkers = 0;
+    size_t nthreads = 0;
+    unsigned long long start = 0;
+    unsigned long long end = 0;
+    size_t i;
+    int ret = -1;
+
+    ignore_value(virTimeMillisNow(&start));
+
+    if (parallel && nitems >= VIR_SECURITY_TRANSACTION_PARALLEL_MIN)
+        nworkers = MIN(nitems / (VIR_SECURITY_TRANSACTION_PARALLEL_MIN / 2),
+                       G_N_ELEMENTS(workers));
+
+    if (nworkers == 0) {
+        for (i = 0; i < nitems; i++) {
+            if (func(i, opaque) < 0)
+                goto cleanup;
+            done[i] = true;
+        }
+
+        ret = 0;
+        goto cleanup;
+    }
+
+    if (virMutexInit(&data.lock) < 0) {
+        virReportSystemError(errno, "%s", _("unable to init mutex"));
+        return -1;
+    }
+
+    data.func = func;
+    data.opaque = opaque;
+    data.nitems = nitems;
+    data.done = done;
+
+    for (i = 0; i < nworkers; i++) {
+        if (virThreadCreateFull(&workers[i], true,
+                                virSecurityTransactionRunWorker,
+                                "sec-relabel", false, &data) < 0) {
+            VIR_WARN("Failed to start relabel worker, continuing with %zu",
+                     nthreads + 1);
+            virResetLastError();
+            break;
+        }
+        nthreads++;
+    }
+
+    virSecurityTransactionRunWorker(&data);
+
+    for (i = 0; i < nthreads; i++)
+        virThreadJoin(&workers[i]);
+
+    virMutexDestroy(&data.lock);
+
+    if (data.failed) {
+        virErrorRestore(&data.err);
+        goto cleanup;
+    }
+
+    ret = 0;
+ cleanup:
+    ignore_value(virTimeMillisNow(&end));
+    VIR_DEBUG("Relabel transaction of %zu items using %zu threads "
+              "finished in %llu ms ret=%d",
+              nitems, nthreads + 1, end - start, ret);
+    return ret;
+}
@@ -35,3 +35,18 @@ virSecurityMoveRememberedLabel(const char *name,
 
 bool
 virSecurityXATTRNamespaceDefined(void);
+
+void
+virSecurityTransactionFindPrevious(const char **paths,
+                                   size_t npaths,
+                                   ssize_t *prev);
+
+typedef int (*virSecurityTransactionItemFunc)(size_t idx,
+                                              void *opaque);
+
+int
+virSecurityTransactionRunItems(size_t nitems,
+                               bool parallel,
+                               virSecurityTransactionItemFunc func,
+                               void *opaque,
+                               bool *done);
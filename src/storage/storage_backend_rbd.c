@@ -34,13 +34,21 @@
 #include "rados/librados.h"
 #include "rbd/librbd.h"
 #include "virsecret.h"
+#include "virthread.h"
+#include "virhash.h"
 #include "storage_util.h"
 
 #define VIR_FROM_THIS VIR_FROM_STORAGE
 
 VIR_LOG_INIT("storage.storage_backend_rbd");
 
+/* Number of threads, including the calling one, used to query
+ * volumes while refreshing a pool */
+#define VIR_STORAGE_BACKEND_RBD_REFRESH_WORKERS 8
+
 struct _virStorageBackendRBDState {
+    virObject parent;
+
     rados_t cluster;
     rados_ioctx_t ioctx;
     time_t starttime;
@@ -49,6 +57,31 @@ struct _virStorageBackendRBDState {
 typedef struct _virStorageBackendRBDState virStorageBackendRBDState;
 typedef virStorageBackendRBDState *virStorageBackendRBDStatePtr;
 
+static virClassPtr virStorageBackendRBDStateClass;
+
+/* Connections to the RADOS cluster are kept open for as long as the
+ * pool is active and shared by all operations on it, keyed by the
+ * pool UUID. Each user holds a reference for the duration of its
+ * operation, so a connection dropped when the pool is stopped is
+ * only shut down once the last in-flight operation is done. */
+static virMutex virStorageBackendRBDStatesLock = VIR_MUTEX_INITIALIZER;
+static GHashTable *virStorageBackendRBDStates;
+
+static void virStorageBackendRBDStateDispose(void *obj);
+
+static int
+virStorageBackendRBDOnceInit(void)
+{
+    if (!VIR_CLASS_NEW(virStorageBackendRBDState, virClassForObject()))
+        return -1;
+
+    virStorageBackendRBDStates = virHashNew(virObjectFreeHashData);
+
+    return 0;
+}
+
+VIR_ONCE_GLOBAL_INIT(virStorageBackendRBD);
+
 typedef struct _virStoragePoolRBDConfigOptionsDef virStoragePoolRBDConfigOptionsDef;
 typedef virStoragePoolRBDConfigOptionsDef *virStoragePoolRBDConfigOptionsDefPtr;
 struct _virStoragePoolRBDConfigOptionsDef {
@@ -365,14 +398,11 @@ virStorageBackendRBDCloseRADOSConn(virStorageBackendRBDStatePtr ptr)
 
 
 static void
-virStorageBackendRBDFreeState(virStorageBackendRBDStatePtr *ptr)
+virStorageBackendRBDStateDispose(void *obj)
 {
-    if (!*ptr)
-        return;
+    virStorageBackendRBDStatePtr ptr = obj;
 
-    virStorageBackendRBDCloseRADOSConn(*ptr);
-
-    VIR_FREE(*ptr);
+    virStorageBackendRBDCloseRADOSConn(ptr);
 }
 
 
@@ -382,7 +412,8 @@ virStorageBackendRBDNewState(virStoragePoolObjPtr pool)
     virStorageBackendRBDStatePtr ptr;
     virStoragePoolDefPtr def = virStoragePoolObjGetDef(pool);
 
-    ptr = g_new0(virStorageBackendRBDState, 1);
+    if (!(ptr = virObjectNew(virStorageBackendRBDStateClass)))
+        return NULL;
 
     if (virStorageBackendRBDOpenRADOSConn(ptr, def) < 0)
         goto error;
@@ -393,11 +424,76 @@ virStorageBackendRBDNewState(virStoragePoolObjPtr pool)
     return ptr;
 
  error:
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
     return NULL;
 }
 
 
+/**
+ * virStorageBackendRBDGetState:
+ * @pool: storage pool object
+ *
+ * Returns a referenced connection to the RADOS cluster of @pool,
+ * opening one only if there is none cached for the pool yet. The
+ * caller must release it with virObjectUnref.
+ */
+static virStorageBackendRBDStatePtr
+virStorageBackendRBDGetState(virStoragePoolObjPtr pool)
+{
+    virStoragePoolDefPtr def = virStoragePoolObjGetDef(pool);
+    virStorageBackendRBDStatePtr ptr;
+    virStorageBackendRBDStatePtr other;
+    char uuidstr[VIR_UUID_STRING_BUFLEN];
+
+    if (virStorageBackendRBDInitialize() < 0)
+        return NULL;
+
+    virUUIDFormat(def->uuid, uuidstr);
+
+    virMutexLock(&virStorageBackendRBDStatesLock);
+    ptr = virObjectRef(virHashLookup(virStorageBackendRBDStates, uuidstr));
+    virMutexUnlock(&virStorageBackendRBDStatesLock);
+
+    if (ptr)
+        return ptr;
+
+    /* Connecting may take as long as client_mount_timeout, so do it
+     * without blocking operations on other pools */
+    if (!(ptr = virStorageBackendRBDNewState(pool)))
+        return NULL;
+
+    virMutexLock(&virStorageBackendRBDStatesLock);
+    if ((other = virHashLookup(virStorageBackendRBDStates, uuidstr))) {
+        /* Somebody else was quicker */
+        virObjectUnref(ptr);
+        ptr = virObjectRef(other);
+    } else if (virHashAddEntry(virStorageBackendRBDStates, uuidstr,
+                               virObjectRef(ptr)) < 0) {
+        virObjectUnref(ptr);
+    }
+    virMutexUnlock(&virStorageBackendRBDStatesLock);
+
+    return ptr;
+}
+
+
+static void
+virStorageBackendRBDDropState(virStoragePoolObjPtr pool)
+{
+    virStoragePoolDefPtr def = virStoragePoolObjGetDef(pool);
+    char uuidstr[VIR_UUID_STRING_BUFLEN];
+
+    if (virStorageBackendRBDInitialize() < 0)
+        return;
+
+    virUUIDFormat(def->uuid, uuidstr);
+
+    virMutexLock(&virStorageBackendRBDStatesLock);
+    virHashRemoveEntry(virStorageBackendRBDStates, uuidstr);
+    virMutexUnlock(&virStorageBackendRBDStatesLock);
+}
+
+
 static int
 volStorageBackendRBDGetFeatures(rbd_image_t image,
                                 const char *volname,
@@ -657,18 +753,54 @@ virStorageBackendRBDGetVolNames(virStorageBackendRBDStatePtr ptr)
 #endif /* ! WITH_RBD_LIST2 */
 
 
+typedef struct _virStorageBackendRBDRefreshData virStorageBackendRBDRefreshData;
+struct _virStorageBackendRBDRefreshData {
+    virStoragePoolObjPtr pool;
+    virStorageBackendRBDStatePtr ptr;
+
+    size_t nvols;
+    virStorageVolDefPtr *vols;
+    int *rcs;
+    virErrorPtr *errs;
+
+    int next; /* index of the next volume to refresh, atomic */
+};
+
+
+static void
+virStorageBackendRBDRefreshWorker(void *opaque)
+{
+    virStorageBackendRBDRefreshData *data = opaque;
+    size_t i;
+
+    while ((i = g_atomic_int_add(&data->next, 1)) < data->nvols) {
+        data->rcs[i] = volStorageBackendRBDRefreshVolInfo(data->vols[i],
+                                                          data->pool,
+                                                          data->ptr);
+
+        /* errors are thread local, hand them over to the caller */
+        if (data->rcs[i] < 0)
+            virErrorPreserveLast(&data->errs[i]);
+    }
+}
+
+
 static int
 virStorageBackendRBDRefreshPool(virStoragePoolObjPtr pool)
 {
-    int rc, ret = -1;
+    int ret = -1;
     virStoragePoolDefPtr def = virStoragePoolObjGetDef(pool);
     virStorageBackendRBDStatePtr ptr = NULL;
     struct rados_cluster_stat_t clusterstat;
     struct rados_pool_stat_t poolstat;
     char **names = NULL;
+    virStorageBackendRBDRefreshData data = { 0 };
+    g_autofree virThread *workers = NULL;
+    size_t nworkers;
+    size_t nthreads = 0;
     size_t i;
 
-    if (!(ptr = virStorageBackendRBDNewState(pool)))
+    if (!(ptr = virStorageBackendRBDGetState(pool)))
         goto cleanup;
 
     if (rados_cluster_stat(ptr->cluster, &clusterstat) < 0) {
@@ -694,15 +826,43 @@ virStorageBackendRBDRefreshPool(virStoragePoolObjPtr pool)
     if (!(names = virStorageBackendRBDGetVolNames(ptr)))
         goto cleanup;
 
-    for (i = 0; names[i] != NULL; i++) {
-        g_autoptr(virStorageVolDef) vol = NULL;
+    data.pool = pool;
+    data.ptr = ptr;
+    data.nvols = g_strv_length(names);
+    data.vols = g_new0(virStorageVolDefPtr, data.nvols);
+    data.rcs = g_new0(int, data.nvols);
+    data.errs = g_new0(virErrorPtr, data.nvols);
 
-        vol = g_new0(virStorageVolDef, 1);
+    for (i = 0; i < data.nvols; i++) {
+        data.vols[i] = g_new0(virStorageVolDef, 1);
+        data.vols[i]->name = g_steal_pointer(&names[i]);
+    }
+
+    nworkers = MIN(data.nvols, VIR_STORAGE_BACKEND_RBD_REFRESH_WORKERS);
+    if (nworkers > 1)
+        workers = g_new0(virThread, nworkers - 1);
+
+    /* Opening an image costs a few round trips to the OSDs, so query
+     * the images from several threads with the calling thread being
+     * one of them */
+    for (i = 0; i + 1 < nworkers; i++) {
+        if (virThreadCreateFull(&workers[nthreads], true,
+                                virStorageBackendRBDRefreshWorker,
+                                "rbd-refresh", false, &data) < 0) {
+            VIR_WARN("Failed to start RBD refresh worker, continuing with %zu",
+                     nthreads + 1);
+            virResetLastError();
+            break;
+        }
+        nthreads++;
+    }
 
-        vol->name = g_steal_pointer(&names[i]);
+    virStorageBackendRBDRefreshWorker(&data);
 
-        rc = volStorageBackendRBDRefreshVolInfo(vol, pool, ptr);
+    for (i = 0; i < nthreads; i++)
+        virThreadJoin(&workers[i]);
 
+    for (i = 0; i < data.nvols; i++) {
         /* It could be that a volume has been deleted through a different route
          * then libvirt and that will cause a -ENOENT to be returned.
          *
@@ -712,16 +872,17 @@ virStorageBackendRBDRefreshPool(virStoragePoolObjPtr pool)
          *
          * Do not error out and simply ignore the volume
          */
-        if (rc < 0) {
-            if (rc == -ENOENT || rc == -ETIMEDOUT)
+        if (data.rcs[i] < 0) {
+            if (data.rcs[i] == -ENOENT || data.rcs[i] == -ETIMEDOUT)
                 continue;
 
+            virErrorRestore(&data.errs[i]);
             goto cleanup;
         }
 
-        if (virStoragePoolObjAddVol(pool, vol) < 0)
+        if (virStoragePoolObjAddVol(pool, data.vols[i]) < 0)
             goto cleanup;
-        vol = NULL;
+        data.vols[i] = NULL;
     }
 
     VIR_DEBUG("Found %zu images in RBD pool %s",
@@ -730,11 +891,26 @@ virStorageBackendRBDRefreshPool(virStoragePoolObjPtr pool)
     ret = 0;
 
  cleanup:
+    for (i = 0; i < data.nvols; i++) {
+        virStorageVolDefFree(data.vols[i]);
+        virFreeError(data.errs[i]);
+    }
+    g_free(data.vols);
+    g_free(data.rcs);
+    g_free(data.errs);
     g_strfreev(names);
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
     return ret;
 }
 
+static int
+virStorageBackendRBDStopPool(virStoragePoolObjPtr pool)
+{
+    virStorageBackendRBDDropState(pool);
+    return 0;
+}
+
+
 static int
 virStorageBackendRBDCleanupSnapshots(rados_ioctx_t ioctx,
                                      virStoragePoolSourcePtr source,
@@ -826,7 +1002,7 @@ virStorageBackendRBDDeleteVol(virStoragePoolObjPtr pool,
     if (flags & VIR_STORAGE_VOL_DELETE_ZEROED)
         VIR_WARN("%s", "This storage backend does not support zeroed removal of volumes");
 
-    if (!(ptr = virStorageBackendRBDNewState(pool)))
+    if (!(ptr = virStorageBackendRBDGetState(pool)))
         goto cleanup;
 
     if (flags & VIR_STORAGE_VOL_DELETE_WITH_SNAPSHOTS) {
@@ -847,7 +1023,7 @@ virStorageBackendRBDDeleteVol(virStoragePoolObjPtr pool,
     ret = 0;
 
  cleanup:
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
     return ret;
 }
 
@@ -914,7 +1090,7 @@ virStorageBackendRBDBuildVol(virStoragePoolObjPtr pool,
         goto cleanup;
     }
 
-    if (!(ptr = virStorageBackendRBDNewState(pool)))
+    if (!(ptr = virStorageBackendRBDGetState(pool)))
         goto cleanup;
 
     if (virStorageBackendRBDCreateImage(ptr->ioctx, vol->name,
@@ -927,7 +1103,7 @@ virStorageBackendRBDBuildVol(virStoragePoolObjPtr pool,
     ret = 0;
 
  cleanup:
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
     return ret;
 }
 
@@ -1222,7 +1398,7 @@ virStorageBackendRBDBuildVolFrom(virStoragePoolObjPtr pool,
 
     virCheckFlags(0, -1);
 
-    if (!(ptr = virStorageBackendRBDNewState(pool)))
+    if (!(ptr = virStorageBackendRBDGetState(pool)))
         goto cleanup;
 
     if ((virStorageBackendRBDCloneImage(ptr->ioctx, origvol->name,
@@ -1232,7 +1408,7 @@ virStorageBackendRBDBuildVolFrom(virStoragePoolObjPtr pool,
     ret = 0;
 
  cleanup:
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
     return ret;
 }
 
@@ -1243,7 +1419,7 @@ virStorageBackendRBDRefreshVol(virStoragePoolObjPtr pool,
     virStorageBackendRBDStatePtr ptr = NULL;
     int ret = -1;
 
-    if (!(ptr = virStorageBackendRBDNewState(pool)))
+    if (!(ptr = virStorageBackendRBDGetState(pool)))
         goto cleanup;
 
     if (volStorageBackendRBDRefreshVolInfo(vol, pool, ptr) < 0)
@@ -1252,7 +1428,7 @@ virStorageBackendRBDRefreshVol(virStoragePoolObjPtr pool,
     ret = 0;
 
  cleanup:
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
     return ret;
 }
 
@@ -1268,7 +1444,7 @@ virStorageBackendRBDResizeVol(virStoragePoolObjPtr pool,
 
     virCheckFlags(0, -1);
 
-    if (!(ptr = virStorageBackendRBDNewState(pool)))
+    if (!(ptr = virStorageBackendRBDGetState(pool)))
         goto cleanup;
 
     if (rbd_open(ptr->ioctx, vol->name, &image, NULL) < 0) {
@@ -1288,7 +1464,7 @@ virStorageBackendRBDResizeVol(virStoragePoolObjPtr pool,
  cleanup:
     if (image != NULL)
        rbd_close(image);
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
     return ret;
 }
 
@@ -1372,7 +1548,7 @@ virStorageBackendRBDVolWipe(virStoragePoolObjPtr pool,
     virObjectLock(pool);
     def = virStoragePoolObjGetDef(pool);
     VIR_DEBUG("Wiping RBD image %s/%s", def->source.name, vol->name);
-    ptr = virStorageBackendRBDNewState(pool);
+    ptr = virStorageBackendRBDGetState(pool);
     virObjectUnlock(pool);
 
     if (!ptr)
@@ -1434,7 +1610,7 @@ virStorageBackendRBDVolWipe(virStoragePoolObjPtr pool,
     if (image)
         rbd_close(image);
 
-    virStorageBackendRBDFreeState(&ptr);
+    virObjectUnref(ptr);
 
     return ret;
 }
@@ -1444,6 +1620,7 @@ virStorageBackend virStorageBackendRBD = {
     .type = VIR_STORAGE_POOL_RBD,
 
     .refreshPool = virStorageBackendRBDRefreshPool,
+    .stopPool = virStorageBackendRBDStopPool,
     .createVol = virStorageBackendRBDCreateVol,
     .buildVol = virStorageBackendRBDBuildVol,
     .buildVolFrom = virStorageBackendRBDBuildVolFrom,
@@ -50,6 +50,7 @@
 #include "viraccessapicheck.h"
 #include "storage_util.h"
 #include "virutil.h"
+#include "virtime.h"
 
 #define VIR_FROM_THIS VIR_FROM_STORAGE
 
@@ -57,6 +58,14 @@ VIR_LOG_INIT("storage.storage_driver");
 
 static virStorageDriverStatePtr driver;
 
+/* Maximum number of pools being checked or autostarted concurrently */
+#define STORAGE_POOL_START_WORKERS 8
+
+/* How long to wait for each pool to start before letting the daemon
+ * proceed */
+#define STORAGE_POOL_START_WAIT 30
+#define STORAGE_POOL_START_WAIT_MS (STORAGE_POOL_START_WAIT * 1000ull)
+
 static int storageStateCleanup(void);
 
 typedef struct _virStorageVolStreamInfo virStorageVolStreamInfo;
@@ -94,11 +103,24 @@ storagePoolRefreshFailCleanup(virStorageBackendPtr backend,
 }
 
 
+static int
+storagePoolInvalidateVolHeader(virStorageVolDefPtr voldef,
+                               const void *opaque G_GNUC_UNUSED)
+{
+    virStorageFileMetadataCacheInvalidate(voldef->target.path);
+    return 0;
+}
+
+
 static int
 storagePoolRefreshImpl(virStorageBackendPtr backend,
                        virStoragePoolObjPtr obj,
                        const char *stateFile)
 {
+    /* Volumes may have been modified outside of libvirt, make sure their
+     * headers are read from disk again. */
+    virStoragePoolObjForEachVolume(obj, storagePoolInvalidateVolHeader, NULL);
+
     virStoragePoolObjClearVols(obj);
     if (backend->refreshPool(obj) < 0) {
         storagePoolRefreshFailCleanup(backend, obj, stateFile);
@@ -178,15 +200,6 @@ storagePoolUpdateStateCallback(virStoragePoolObjPtr obj,
 }
 
 
-static void
-storagePoolUpdateAllState(void)
-{
-    virStoragePoolObjListForEach(driver->pools,
-                                 storagePoolUpdateStateCallback,
-                                 NULL);
-}
-
-
 static void
 storageDriverAutostartCallback(virStoragePoolObjPtr obj,
                                const void *opaque G_GNUC_UNUSED)
@@ -194,6 +207,7 @@ storageDriverAutostartCallback(virStoragePoolObjPtr obj,
     virStoragePoolDefPtr def = virStoragePoolObjGetDef(obj);
     virStorageBackendPtr backend;
     bool started = false;
+    virObjectEventPtr event = NULL;
 
     if (!(backend = virStorageBackendForType(def->type)))
         return;
@@ -224,6 +238,10 @@ storageDriverAutostartCallback(virStoragePoolObjPtr obj,
                            def->name, virGetLastErrorMessage());
         } else {
             virStoragePoolObjSetActive(obj, true);
+            event = virStoragePoolEventLifecycleNew(def->name,
+                                                    def->uuid,
+                                                    VIR_STORAGE_POOL_EVENT_STARTED,
+                                                    0);
         }
     }
 
@@ -233,15 +251,165 @@ storageDriverAutostartCallback(virStoragePoolObjPtr obj,
             virStoragePoolUpdateInactive(obj);
         virStoragePoolObjSetStarting(obj, false);
     }
+    virObjectEventStateQueue(driver->storageEventState, event);
+}
+
+
+typedef struct _virStoragePoolStartJob virStoragePoolStartJob;
+typedef virStoragePoolStartJob *virStoragePoolStartJobPtr;
+struct _virStoragePoolStartJob {
+    virStoragePoolObjPtr obj;
+    bool updateState;
+    bool autostart;
+};
+
+
+static void
+storagePoolStartJobRun(virStoragePoolObjPtr obj,
+                       const virStoragePoolStartJob *job)
+{
+    if (job->updateState)
+        storagePoolUpdateStateCallback(obj, NULL);
+
+    if (job->autostart)
+        storageDriverAutostartCallback(obj, NULL);
+}
+
+
+static void
+storagePoolStartWorker(void *jobdata,
+                       void *opaque G_GNUC_UNUSED)
+{
+    virStoragePoolStartJobPtr job = jobdata;
+    virStoragePoolObjPtr obj = job->obj;
+    unsigned long long now;
+    bool quit;
+
+    virMutexLock(&driver->poolStartLock);
+    quit = driver->poolStartQuit;
+    /* Give this pool its own STORAGE_POOL_START_WAIT seconds no matter
+     * how long it sat in the queue behind slower ones */
+    if (!quit && virTimeMillisNow(&now) == 0)
+        driver->poolStartDeadline = MAX(driver->poolStartDeadline,
+                                        now + STORAGE_POOL_START_WAIT_MS);
+    virMutexUnlock(&driver->poolStartLock);
+
+    if (quit) {
+        VIR_DEBUG("dropping start of storage pool '%s'",
+                  virStoragePoolObjGetDef(obj)->name);
+        virObjectUnref(obj);
+    } else {
+        virObjectLock(obj);
+        storagePoolStartJobRun(obj, job);
+        VIR_DEBUG("storage pool '%s' is %s",
+                  virStoragePoolObjGetDef(obj)->name,
+                  virStoragePoolObjIsActive(obj) ? "active" : "inactive");
+        virStoragePoolObjEndAPI(&obj);
+    }
+    g_free(job);
+
+    virMutexLock(&driver->poolStartLock);
+    driver->poolStartJobs--;
+    virCondBroadcast(&driver->poolStartCond);
+    virMutexUnlock(&driver->poolStartLock);
 }
 
 
+/**
+ * storageDriverStartPools:
+ * @updateState: re-check the state of pools which were active before
+ * @autostart: start inactive pools marked as autostart
+ *
+ * Hands every pool over to the driver's worker pool so that one slow or
+ * unreachable pool (a stuck NFS mount or iSCSI login) doesn't delay all
+ * the others. The caller must hold the driver lock and should call
+ * storageDriverWaitPools once it has released it.
+ */
 static void
-storageDriverAutostart(void)
+storageDriverStartPools(bool updateState,
+                        bool autostart)
 {
-    virStoragePoolObjListForEach(driver->pools,
-                                 storageDriverAutostartCallback,
-                                 NULL);
+    virStoragePoolObjPtr *objs = NULL;
+    size_t nobjs = 0;
+    size_t i;
+    unsigned long long now;
+
+    if (!updateState && !autostart)
+        return;
+
+    virStoragePoolObjListCollect(driver->pools, &objs, &nobjs);
+
+    virMutexLock(&driver->poolStartLock);
+    if (virTimeMillisNow(&now) == 0)
+        driver->poolStartDeadline = MAX(driver->poolStartDeadline,
+                                        now + STORAGE_POOL_START_WAIT_MS);
+    virMutexUnlock(&driver->poolStartLock);
+
+    for (i = 0; i < nobjs; i++) {
+        virStoragePoolStartJobPtr job = g_new0(virStoragePoolStartJob, 1);
+
+        job->obj = objs[i];
+        job->updateState = updateState;
+        job->autostart = autostart;
+
+        virMutexLock(&driver->poolStartLock);
+        driver->poolStartJobs++;
+        virMutexUnlock(&driver->poolStartLock);
+
+        if (virThreadPoolSendJob(driver->workerPool, 0, job) < 0) {
+            VIR_WARN("Unable to queue start of storage pool '%s', "
+                     "processing synchronously",
+                     virStoragePoolObjGetDef(job->obj)->name);
+            virMutexLock(&driver->poolStartLock);
+            driver->poolStartJobs--;
+            virMutexUnlock(&driver->poolStartLock);
+            virObjectLock(job->obj);
+            storagePoolStartJobRun(job->obj, job);
+            virStoragePoolObjEndAPI(&job->obj);
+            g_free(job);
+        }
+    }
+    g_free(objs);
+}
+
+
+/**
+ * storageDriverWaitPools:
+ *
+ * Waits for the pools handed over by storageDriverStartPools to settle.
+ * Every pool gets STORAGE_POOL_START_WAIT seconds from the moment a
+ * worker picks it up; once all the pools still in progress have used up
+ * theirs, the wait is over and they keep starting in the background,
+ * staying locked (and thus unavailable to other APIs) until they are
+ * done. Must be called without the driver lock held.
+ */
+static void
+storageDriverWaitPools(void)
+{
+    unsigned long long now;
+
+    virMutexLock(&driver->poolStartLock);
+    while (driver->poolStartJobs > 0) {
+        if (virCondWaitUntil(&driver->poolStartCond,
+                             &driver->poolStartLock,
+                             driver->poolStartDeadline) < 0) {
+            if (errno != ETIMEDOUT) {
+                VIR_WARN("Unable to wait for storage pools to start");
+                break;
+            }
+
+            /* A worker may have picked up another pool meanwhile */
+            if (virTimeMillisNow(&now) == 0 &&
+                now < driver->poolStartDeadline)
+                continue;
+
+            VIR_WARN("%zu storage pools did not finish starting within "
+                     "%d seconds, continuing in background",
+                     driver->poolStartJobs, STORAGE_POOL_START_WAIT);
+            break;
+        }
+    }
+    virMutexUnlock(&driver->poolStartLock);
 }
 
 /**
@@ -272,6 +440,17 @@ storageStateInitialize(bool privileged,
         VIR_FREE(driver);
         return VIR_DRV_STATE_INIT_ERROR;
     }
+    if (virMutexInit(&driver->poolStartLock) < 0) {
+        virMutexDestroy(&driver->lock);
+        VIR_FREE(driver);
+        return VIR_DRV_STATE_INIT_ERROR;
+    }
+    if (virCondInit(&driver->poolStartCond) < 0) {
+        virMutexDestroy(&driver->poolStartLock);
+        virMutexDestroy(&driver->lock);
+        VIR_FREE(driver);
+        return VIR_DRV_STATE_INIT_ERROR;
+    }
     storageDriverLock();
 
     if (!(driver->pools = virStoragePoolObjListNew()))
@@ -312,16 +491,19 @@ storageStateInitialize(bool privileged,
                                         driver->autostartDir) < 0)
         goto error;
 
-    storagePoolUpdateAllState();
-
     if (virDriverShouldAutostart(driver->stateDir, &autostart) < 0)
         goto error;
 
-    if (autostart)
-        storageDriverAutostart();
-
     driver->storageEventState = virObjectEventStateNew();
 
+    if (!(driver->workerPool = virThreadPoolNewFull(0, STORAGE_POOL_START_WORKERS,
+                                                    0, storagePoolStartWorker,
+                                                    "storage-pool-start",
+                                                    NULL)))
+        goto error;
+
+    storageDriverStartPools(true, autostart);
+
     /* Only one load of storage driver plus backends exists. Unlike
      * domains where new binaries could change the capabilities. A
      * new/changed backend requires a reinitialization. */
@@ -330,6 +512,8 @@ storageStateInitialize(bool privileged,
 
     storageDriverUnlock();
 
+    storageDriverWaitPools();
+
     return VIR_DRV_STATE_INIT_COMPLETE;
 
  error:
@@ -356,9 +540,11 @@ storageStateReload(void)
     virStoragePoolObjLoadAllConfigs(driver->pools,
                                     driver->configDir,
                                     driver->autostartDir);
-    storageDriverAutostart();
+    storageDriverStartPools(false, true);
     storageDriverUnlock();
 
+    storageDriverWaitPools();
+
     return 0;
 }
 
@@ -374,6 +560,23 @@ storageStateCleanup(void)
     if (!driver)
         return -1;
 
+    /* virThreadPoolFree would throw away the queued jobs together with
+     * the pool references they hold, let the workers drop them instead.
+     * Pools which are already being started are waited for anyway. */
+    if (driver->workerPool) {
+        virMutexLock(&driver->poolStartLock);
+        driver->poolStartQuit = true;
+        while (driver->poolStartJobs > 0) {
+            if (virCondWait(&driver->poolStartCond,
+                            &driver->poolStartLock) < 0) {
+                VIR_WARN("Unable to wait for storage pool workers");
+                break;
+            }
+        }
+        virMutexUnlock(&driver->poolStartLock);
+    }
+    virThreadPoolFree(driver->workerPool);
+
     storageDriverLock();
 
     virObjectUnref(driver->caps);
@@ -390,6 +593,8 @@ storageStateCleanup(void)
     VIR_FREE(driver->autostartDir);
     VIR_FREE(driver->stateDir);
     storageDriverUnlock();
+    virCondDestroy(&driver->poolStartCond);
+    virMutexDestroy(&driver->poolStartLock);
     virMutexDestroy(&driver->lock);
     VIR_FREE(driver);
 
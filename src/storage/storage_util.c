@@ -1322,6 +1322,112 @@ storageBackendCreateQemuImgSecretPath(virStoragePoolObjPtr pool,
 }
 
 
+/* storageBackendCreateQcow2:
+ *
+ * Creates plain qcow2 volumes, optionally on top of a backing store,
+ * directly rather than by running qemu-img. Anything involving
+ * encryption, conversion from another volume or preallocation is left
+ * to qemu-img.
+ *
+ * Returns 0 on success, -1 on failure with error set, 1 if the volume
+ * has to be created by qemu-img.
+ */
+static int
+storageBackendCreateQcow2(virStoragePoolObjPtr pool,
+                          virStorageVolDefPtr vol,
+                          virStorageVolDefPtr inputvol,
+                          unsigned int flags)
+{
+    virStoragePoolDefPtr def = virStoragePoolObjGetDef(pool);
+    struct _virStorageBackendQemuImgInfo info = {
+        .format = vol->target.format,
+        .path = vol->target.path,
+    };
+    const char *compat = vol->target.compat;
+    bool v3 = STREQ_NULLABLE(compat, "1.1");
+    bool lazyRefcounts = false;
+    unsigned long long capacity;
+    int operation_flags;
+    mode_t open_mode = VIR_STORAGE_DEFAULT_VOL_PERM_MODE;
+    VIR_AUTOCLOSE fd = -1;
+
+    if (vol->type != VIR_STORAGE_VOL_FILE ||
+        vol->target.format != VIR_STORAGE_FILE_QCOW2 ||
+        vol->target.encryption ||
+        inputvol ||
+        (flags & VIR_STORAGE_VOL_CREATE_PREALLOC_METADATA))
+        return 1;
+
+    if (compat && !v3 && STRNEQ(compat, "0.10"))
+        return 1;
+
+    if (vol->target.features)
+        lazyRefcounts = virBitmapIsBitSet(vol->target.features,
+                                          VIR_STORAGE_FILE_FEATURE_LAZY_REFCOUNTS);
+    if (lazyRefcounts && !v3)
+        return 1;
+
+    /* qemu-img takes the size of the backing store if none is given */
+    if (virStorageSourceHasBacking(&vol->target)) {
+        if (vol->target.capacity == 0 ||
+            vol->target.backingStore->format <= VIR_STORAGE_FILE_NONE)
+            return 1;
+
+        if (storageBackendCreateQemuImgSetBacking(pool, vol, NULL, &info) < 0)
+            return -1;
+    }
+
+    /* Round to KiB, as does the size argument passed to qemu-img */
+    capacity = VIR_DIV_UP(vol->target.capacity, 1024) * 1024;
+
+    operation_flags = VIR_FILE_OPEN_FORCE_MODE | VIR_FILE_OPEN_FORCE_OWNER;
+    if (def->type == VIR_STORAGE_POOL_NETFS)
+        operation_flags |= VIR_FILE_OPEN_FORK;
+
+    if (vol->target.perms->mode != (mode_t)-1)
+        open_mode = vol->target.perms->mode;
+
+    if ((fd = virFileOpenAs(vol->target.path,
+                            O_RDWR | O_CREAT | O_EXCL,
+                            open_mode,
+                            vol->target.perms->uid,
+                            vol->target.perms->gid,
+                            operation_flags)) < 0) {
+        /* qemu-img happily overwrites existing files */
+        if (fd == -EEXIST)
+            return 1;
+
+        virReportSystemError(-fd,
+                             _("Failed to create file '%s'"),
+                             vol->target.path);
+        return -1;
+    }
+
+    if (vol->target.nocow &&
+        virFileSetCOW(vol->target.path, VIR_TRISTATE_BOOL_NO) < 0)
+        goto error;
+
+    if (virStorageFileQcow2Create(fd, vol->target.path, capacity,
+                                  info.backingPath, info.backingFormat,
+                                  v3, lazyRefcounts) < 0)
+        goto error;
+
+    if (g_fsync(fd) < 0) {
+        virReportSystemError(errno, _("cannot sync data to file '%s'"),
+                             vol->target.path);
+        goto error;
+    }
+
+    return 0;
+
+ error:
+    virFileRemove(vol->target.path,
+                  vol->target.perms->uid,
+                  vol->target.perms->gid);
+    return -1;
+}
+
+
 static int
 storageBackendDoCreateQemuImg(virStoragePoolObjPtr pool,
                               virStorageVolDefPtr vol,
@@ -1359,6 +1465,10 @@ storageBackendCreateQemuImg(virStoragePoolObjPtr pool,
 
     virCheckFlags(VIR_STORAGE_VOL_CREATE_PREALLOC_METADATA, -1);
 
+    if ((ret = storageBackendCreateQcow2(pool, vol, inputvol, flags)) <= 0)
+        return ret;
+    ret = -1;
+
     create_tool = virFindFileInPath("qemu-img");
     if (!create_tool) {
         virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
@@ -2149,6 +2259,8 @@ storageBackendVolBuildLocal(virStoragePoolObjPtr pool,
 
     if (create_func(pool, vol, inputvol, flags) < 0)
         return -1;
+
+    virStorageFileMetadataCacheInvalidate(vol->target.path);
     return 0;
 }
 
@@ -2190,6 +2302,8 @@ virStorageBackendVolDeleteLocal(virStoragePoolObjPtr pool G_GNUC_UNUSED,
 {
     virCheckFlags(0, -1);
 
+    virStorageFileMetadataCacheInvalidate(vol->target.path);
+
     switch ((virStorageVolType)vol->type) {
     case VIR_STORAGE_VOL_FILE:
     case VIR_STORAGE_VOL_DIR:
@@ -2297,6 +2411,48 @@ virStorageBackendVolRefreshLocal(virStoragePoolObjPtr pool G_GNUC_UNUSED,
 }
 
 
+/* storageBackendResizeQcow2:
+ *
+ * Grows an unencrypted qcow2 volume by updating its header directly
+ * rather than by running qemu-img.
+ *
+ * Returns 0 on success, -1 on failure with error set, 1 if the volume
+ * has to be resized by qemu-img.
+ */
+static int
+storageBackendResizeQcow2(virStorageVolDefPtr vol,
+                          unsigned long long capacity)
+{
+    VIR_AUTOCLOSE fd = -1;
+    int rc;
+
+    if (vol->target.format != VIR_STORAGE_FILE_QCOW2 ||
+        vol->target.encryption ||
+        capacity < vol->target.capacity)
+        return 1;
+
+    if ((fd = open(vol->target.path, O_RDWR | O_CLOEXEC)) < 0)
+        return 1;
+
+    /* QEMU holds byte range locks in this area of any image it has
+     * open; leave such images to qemu-img which knows how to deal
+     * with them. */
+    if (virFileLock(fd, false, 100, 200, false) < 0)
+        return 1;
+
+    if ((rc = virStorageFileQcow2Grow(fd, vol->target.path, capacity)) != 0)
+        return rc;
+
+    if (g_fsync(fd) < 0) {
+        virReportSystemError(errno, _("cannot sync data to file '%s'"),
+                             vol->target.path);
+        return -1;
+    }
+
+    return 0;
+}
+
+
 static int
 storageBackendResizeQemuImg(virStoragePoolObjPtr pool,
                             virStorageVolDefPtr vol,
@@ -2319,6 +2475,10 @@ storageBackendResizeQemuImg(virStoragePoolObjPtr pool,
         return -1;
     }
 
+    if ((ret = storageBackendResizeQcow2(vol, VIR_ROUND_UP(capacity, 512))) <= 0)
+        return ret;
+    ret = -1;
+
     img_tool = virFindFileInPath("qemu-img");
     if (!img_tool) {
         virReportError(VIR_ERR_INTERNAL_ERROR,
@@ -2390,6 +2550,8 @@ virStorageBackendVolResizeLocal(virStoragePoolObjPtr pool,
     virCheckFlags(VIR_STORAGE_VOL_RESIZE_ALLOCATE |
                   VIR_STORAGE_VOL_RESIZE_SHRINK, -1);
 
+    virStorageFileMetadataCacheInvalidate(vol->target.path);
+
     if (vol->target.format == VIR_STORAGE_FILE_RAW && !vol->target.encryption) {
         return virFileResize(vol->target.path, capacity, pre_allocate);
     } else if (vol->target.format == VIR_STORAGE_FILE_RAW && vol->target.encryption) {
@@ -2484,6 +2646,8 @@ virStorageBackendVolUploadLocal(virStoragePoolObjPtr pool G_GNUC_UNUSED,
         target_path = path;
     }
 
+    virStorageFileMetadataCacheInvalidate(target_path);
+
     /* Not using O_CREAT because the file is required to already exist at
      * this point */
     return virFDStreamOpenBlockDevice(stream, target_path,
@@ -2764,6 +2928,8 @@ virStorageBackendVolWipeLocal(virStoragePoolObjPtr pool G_GNUC_UNUSED,
     VIR_DEBUG("Wiping volume with path '%s' and algorithm %u",
               vol->target.path, algorithm);
 
+    virStorageFileMetadataCacheInvalidate(vol->target.path);
+
     if (vol->target.format == VIR_STORAGE_FILE_PLOOP) {
         ret = storageBackendVolWipePloop(vol, algorithm);
     } else {
@@ -27,6 +27,7 @@
 
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 
 #include "virthread.h"
 #include "virfile.h"
@@ -42,31 +43,199 @@
 # define O_DIRECT 0
 #endif
 
+/* Size of a single buffer passed between the reader and the writer */
+#define IOHELPER_BUFLEN (1024 * 1024)
+
+/* Number of buffers the reader may fill ahead of the writer */
+#define IOHELPER_NBUFS 4
+
+/* Buffer alignment and the granularity of holes in sparse output */
+#define IOHELPER_ALIGN (64 * 1024)
+
+typedef struct _runIOBuf runIOBuf;
+struct _runIOBuf {
+    void *base; /* Location to be freed */
+    char *data; /* Aligned location within base */
+    ssize_t len;
+};
+
+typedef struct _runIOPipe runIOPipe;
+struct _runIOPipe {
+    virMutex lock;
+    virCond cond;
+
+    runIOBuf bufs[IOHELPER_NBUFS];
+    size_t head; /* first filled buffer */
+    size_t count; /* number of filled buffers */
+
+    bool eof; /* reader is done, successfully or not */
+    bool quit; /* writer failed, reader should stop */
+    int readErr; /* errno of a failed read */
+
+    int fdin;
+    bool directIn;
+};
+
+
+static int
+runIOBufAlloc(runIOBuf *buf)
+{
+    intptr_t alignMask = IOHELPER_ALIGN - 1;
+
+#if WITH_POSIX_MEMALIGN
+    if (posix_memalign(&buf->base, alignMask + 1, IOHELPER_BUFLEN)) {
+        virReportOOMError();
+        return -1;
+    }
+    buf->data = buf->base;
+#else
+    buf->base = g_new0(char, IOHELPER_BUFLEN + alignMask);
+    buf->data = (char *) (((intptr_t) buf->base + alignMask) & ~alignMask);
+#endif
+
+    return 0;
+}
+
+
+static ssize_t
+runIORead(runIOPipe *p, char *data)
+{
+    ssize_t got;
+
+    /* If we read with O_DIRECT from file we can't use saferead as
+     * it can lead to unaligned read after reading last bytes.
+     * If we write with O_DIRECT use should use saferead so that
+     * writes will be aligned.
+     * In other cases using saferead reduces number of syscalls.
+     */
+    if (p->directIn) {
+        while ((got = read(p->fdin, data, IOHELPER_BUFLEN)) < 0 &&
+               errno == EINTR)
+            ;
+    } else {
+        got = saferead(p->fdin, data, IOHELPER_BUFLEN);
+    }
+
+    return got;
+}
+
+
+/* Fills buffers from the input for as long as the writer keeps
+ * draining them, so that reading the next chunk overlaps with
+ * writing the previous one. */
+static void
+runIOReader(void *opaque)
+{
+    runIOPipe *p = opaque;
+
+    virMutexLock(&p->lock);
+    while (!p->quit) {
+        runIOBuf *buf;
+        ssize_t got;
+
+        if (p->count == IOHELPER_NBUFS) {
+            ignore_value(virCondWait(&p->cond, &p->lock));
+            continue;
+        }
+
+        buf = &p->bufs[(p->head + p->count) % IOHELPER_NBUFS];
+        virMutexUnlock(&p->lock);
+
+        got = runIORead(p, buf->data);
+
+        virMutexLock(&p->lock);
+        if (got <= 0) {
+            if (got < 0)
+                p->readErr = errno;
+            break;
+        }
+
+        buf->len = got;
+        p->count++;
+        virCondSignal(&p->cond);
+
+        /* a short read is only ever returned at the end of input */
+        if (got < IOHELPER_BUFLEN && !p->directIn)
+            break;
+    }
+
+    p->eof = true;
+    virCondSignal(&p->cond);
+    virMutexUnlock(&p->lock);
+}
+
+
+static bool
+runIOIsZero(const char *data, size_t len)
+{
+    return data[0] == '\0' && memcmp(data, data + 1, len - 1) == 0;
+}
+
+
+/* Writes @len bytes of @data to @fd, seeking over aligned blocks that
+ * contain only zeros rather than writing them out. The caller has to
+ * make sure the file is extended to its final size afterwards. */
+static int
+runIOWriteSparse(int fd, const char *data, size_t len)
+{
+    size_t off = 0;
+
+    while (off < len) {
+        size_t start = off;
+
+        while (off < len &&
+               len - off >= IOHELPER_ALIGN &&
+               runIOIsZero(data + off, IOHELPER_ALIGN))
+            off += IOHELPER_ALIGN;
+
+        if (off > start &&
+            lseek(fd, off - start, SEEK_CUR) < 0)
+            return -1;
+
+        start = off;
+        while (off < len &&
+               (len - off < IOHELPER_ALIGN ||
+                !runIOIsZero(data + off, IOHELPER_ALIGN)))
+            off += MIN(IOHELPER_ALIGN, len - off);
+
+        if (off > start &&
+            safewrite(fd, data + start, off - start) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
 static int
 runIO(const char *path, int fd, int oflags)
 {
-    g_autofree void *base = NULL; /* Location to be freed */
-    char *buf = NULL; /* Aligned location within base */
-    size_t buflen = 1024*1024;
-    intptr_t alignMask = 64*1024 - 1;
+    runIOPipe p = { 0 };
+    virThread reader;
+    bool readerRunning = false;
+    intptr_t alignMask = IOHELPER_ALIGN - 1;
     int ret = -1;
     int fdin, fdout;
     const char *fdinname, *fdoutname;
     unsigned long long total = 0;
     bool direct = O_DIRECT && ((oflags & O_DIRECT) != 0);
+    bool sparse = false;
+    off_t start = 0;
     off_t end = 0;
+    struct stat sb;
+    size_t i;
+
+    if (virMutexInit(&p.lock) < 0 ||
+        virCondInit(&p.cond) < 0) {
+        virReportSystemError(errno, "%s", _("Unable to initialize mutex"));
+        VIR_FORCE_CLOSE(fd);
+        return -1;
+    }
 
-#if WITH_POSIX_MEMALIGN
-    if (posix_memalign(&base, alignMask + 1, buflen)) {
-        virReportOOMError();
-        goto cleanup;
+    for (i = 0; i < IOHELPER_NBUFS; i++) {
+        if (runIOBufAlloc(&p.bufs[i]) < 0)
+            goto cleanup;
     }
-    buf = base;
-#else
-    buf = g_new0(char, buflen + alignMask);
-    base = buf;
-    buf = (char *) (((intptr_t) base + alignMask) & ~alignMask);
-#endif
 
     switch (oflags & O_ACCMODE) {
     case O_RDONLY:
@@ -94,6 +263,12 @@ runIO(const char *path, int fd, int oflags)
                                  _("O_DIRECT write needs empty seekable file"));
             goto cleanup;
         }
+
+        /* Zero blocks can be left as holes only if we are appending
+         * to a regular file, where nothing can be hiding under them */
+        if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) &&
+            (start = lseek(fd, 0, SEEK_CUR)) == sb.st_size)
+            sparse = true;
         break;
 
     case O_RDWR:
@@ -104,55 +279,77 @@ runIO(const char *path, int fd, int oflags)
         goto cleanup;
     }
 
+    p.fdin = fdin;
+    p.directIn = direct && fdin == fd;
+
+    if (virThreadCreateFull(&reader, true, runIOReader,
+                            "iohelper-read", false, &p) < 0) {
+        virReportSystemError(errno, "%s", _("Unable to create reader thread"));
+        goto cleanup;
+    }
+    readerRunning = true;
+
+    virMutexLock(&p.lock);
     while (1) {
+        runIOBuf *buf;
         ssize_t got;
+        int rc;
 
-        /* If we read with O_DIRECT from file we can't use saferead as
-         * it can lead to unaligned read after reading last bytes.
-         * If we write with O_DIRECT use should use saferead so that
-         * writes will be aligned.
-         * In other cases using saferead reduces number of syscalls.
-         */
-        if (fdin == fd && direct) {
-            if ((got = read(fdin, buf, buflen)) < 0 &&
-                errno == EINTR)
-                continue;
-        } else {
-            got = saferead(fdin, buf, buflen);
+        if (p.count == 0) {
+            if (p.eof)
+                break;
+            ignore_value(virCondWait(&p.cond, &p.lock));
+            continue;
         }
 
-        if (got < 0) {
-            virReportSystemError(errno, _("Unable to read %s"), fdinname);
-            goto cleanup;
-        }
-        if (got == 0)
-            break;
+        buf = &p.bufs[p.head];
+        got = buf->len;
+        virMutexUnlock(&p.lock);
 
         total += got;
 
         /* handle last write size align in direct case */
-        if (got < buflen && direct && fdout == fd) {
+        if (got < IOHELPER_BUFLEN && direct && fdout == fd) {
             ssize_t aligned_got = (got + alignMask) & ~alignMask;
 
-            memset(buf + got, 0, aligned_got - got);
-
-            if (safewrite(fdout, buf, aligned_got) < 0) {
-                virReportSystemError(errno, _("Unable to write %s"), fdoutname);
-                goto cleanup;
-            }
-
-            if (ftruncate(fd, total) < 0) {
-                virReportSystemError(errno, _("Unable to truncate %s"), fdoutname);
-                goto cleanup;
-            }
-
-            break;
+            memset(buf->data + got, 0, aligned_got - got);
+            got = aligned_got;
         }
 
-        if (safewrite(fdout, buf, got) < 0) {
+        if (sparse)
+            rc = runIOWriteSparse(fdout, buf->data, got);
+        else
+            rc = safewrite(fdout, buf->data, got);
+
+        virMutexLock(&p.lock);
+        if (rc < 0) {
             virReportSystemError(errno, _("Unable to write %s"), fdoutname);
+            p.quit = true;
+            virCondSignal(&p.cond);
+            virMutexUnlock(&p.lock);
             goto cleanup;
         }
+
+        p.head = (p.head + 1) % IOHELPER_NBUFS;
+        p.count--;
+        virCondSignal(&p.cond);
+    }
+    virMutexUnlock(&p.lock);
+
+    virThreadJoin(&reader);
+    readerRunning = false;
+
+    if (p.readErr) {
+        virReportSystemError(p.readErr, _("Unable to read %s"), fdinname);
+        goto cleanup;
+    }
+
+    /* Trailing holes and padding of the last direct write are both
+     * taken care of by setting the final size */
+    if ((sparse || direct) && fdout == fd &&
+        ftruncate(fd, start + total) < 0) {
+        virReportSystemError(errno, _("Unable to truncate %s"), fdoutname);
+        goto cleanup;
     }
 
     /* Ensure all data is written */
@@ -167,6 +364,14 @@ runIO(const char *path, int fd, int oflags)
     ret = 0;
 
  cleanup:
+    /* If writing failed, the reader may be stuck reading the input.
+     * The process is about to exit anyway, so don't wait for it. */
+    if (!readerRunning) {
+        for (i = 0; i < IOHELPER_NBUFS; i++)
+            g_free(p.bufs[i].base);
+        virCondDestroy(&p.cond);
+        virMutexDestroy(&p.lock);
+    }
     if (VIR_CLOSE(fd) < 0 &&
         ret == 0) {
         virReportSystemError(errno, _("Unable to close %s"), path);
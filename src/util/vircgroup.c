@@ -62,6 +62,11 @@ VIR_ENUM_IMPL(virCgroupController,
               "name=systemd",
 );
 
+VIR_ENUM_IMPL(virCgroupPressureResource,
+              VIR_CGROUP_PRESSURE_LAST,
+              "cpu", "memory", "io",
+);
+
 
 /**
  * virCgroupGetDevicePermsString:
@@ -547,6 +552,216 @@ virCgroupSetValueStr(virCgroupPtr group,
 }
 
 
+/* Statistics files which are polled over and over again by the stats APIs.
+ * Their descriptors are kept open for the lifetime of the group so that
+ * every read is a single pread() instead of open() + read() + close().
+ * The number of descriptors cached by all groups together is capped so that
+ * a host with many domains doesn't run out of descriptors, once the limit
+ * is reached the files are read the usual way. */
+static const char *virCgroupStatFiles[] = {
+    "cpu.stat",
+    "cpuacct.stat",
+    "cpuacct.usage",
+    "cpuacct.usage_percpu",
+    "memory.current",
+    "memory.stat",
+    "memory.usage_in_bytes",
+    "io.stat",
+    "blkio.throttle.io_service_bytes",
+    "blkio.throttle.io_serviced",
+    "cpu.pressure",
+    "memory.pressure",
+    "io.pressure",
+};
+
+#define VIR_CGROUP_STAT_FILES_MAX 1024
+
+/* Number of descriptors currently held in statFiles of all groups */
+static int virCgroupStatFilesCount;
+
+
+static bool
+virCgroupIsStatFile(const char *key)
+{
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS(virCgroupStatFiles); i++) {
+        if (STREQ(key, virCgroupStatFiles[i]))
+            return true;
+    }
+
+    return false;
+}
+
+
+static void
+virCgroupStatFileClose(void *opaque)
+{
+    int fd = GPOINTER_TO_INT(opaque);
+
+    g_atomic_int_add(&virCgroupStatFilesCount, -1);
+    VIR_FORCE_CLOSE(fd);
+}
+
+
+/**
+ * virCgroupStatFileTake:
+ * @group: the cgroup
+ * @path: path of the statistics file
+ *
+ * Removes the cached descriptor of @path from @group so that the caller
+ * can read from it without holding the lock.
+ *
+ * Returns the descriptor or -1 if there's none.
+ */
+static int
+virCgroupStatFileTake(virCgroupPtr group,
+                      const char *path)
+{
+    gpointer key;
+    gpointer fdptr;
+    int fd = -1;
+
+    virMutexLock(&group->statFilesLock);
+
+    if (group->statFiles &&
+        g_hash_table_lookup_extended(group->statFiles, path, &key, &fdptr)) {
+        g_hash_table_steal(group->statFiles, path);
+        g_atomic_int_add(&virCgroupStatFilesCount, -1);
+        g_free(key);
+        fd = GPOINTER_TO_INT(fdptr);
+    }
+
+    virMutexUnlock(&group->statFilesLock);
+    return fd;
+}
+
+
+/**
+ * virCgroupStatFileGive:
+ * @group: the cgroup
+ * @path: path of the statistics file
+ * @fd: descriptor of @path
+ *
+ * Stores @fd into the cache of @group unless the cache already has one for
+ * @path or the global limit on cached descriptors was reached, in which
+ * case @fd is closed.
+ */
+static void
+virCgroupStatFileGive(virCgroupPtr group,
+                      const char *path,
+                      int fd)
+{
+    virMutexLock(&group->statFilesLock);
+
+    if (!group->statFiles)
+        group->statFiles = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                 g_free,
+                                                 virCgroupStatFileClose);
+
+    if (!g_hash_table_contains(group->statFiles, path)) {
+        if (g_atomic_int_add(&virCgroupStatFilesCount, 1) < VIR_CGROUP_STAT_FILES_MAX) {
+            g_hash_table_insert(group->statFiles, g_strdup(path),
+                                GINT_TO_POINTER(fd));
+            fd = -1;
+        } else {
+            g_atomic_int_add(&virCgroupStatFilesCount, -1);
+        }
+    }
+
+    virMutexUnlock(&group->statFilesLock);
+    VIR_FORCE_CLOSE(fd);
+}
+
+
+/**
+ * virCgroupStatFilesFlush:
+ * @group: the cgroup
+ *
+ * Close all cached statistics file descriptors of @group.
+ */
+static void
+virCgroupStatFilesFlush(virCgroupPtr group)
+{
+    virMutexLock(&group->statFilesLock);
+    g_clear_pointer(&group->statFiles, g_hash_table_unref);
+    virMutexUnlock(&group->statFilesLock);
+}
+
+
+static int
+virCgroupReadStatFile(int fd,
+                      char **value)
+{
+    size_t maxlen = 1024 * 1024;
+    size_t alloc = 4096;
+    size_t len = 0;
+    g_autofree char *buf = g_new0(char, alloc + 1);
+    ssize_t rc;
+
+    /* cgroupfs regenerates the content whenever it's read from offset 0 */
+    while ((rc = pread(fd, buf + len, alloc - len, len)) != 0) {
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+
+        len += rc;
+        if (len == alloc) {
+            if (alloc >= maxlen) {
+                errno = EINVAL;
+                return -1;
+            }
+            alloc *= 2;
+            buf = g_renew(char, buf, alloc + 1);
+        }
+    }
+
+    buf[len] = '\0';
+
+    if (len > 0 && buf[len - 1] == '\n')
+        buf[len - 1] = '\0';
+
+    *value = g_steal_pointer(&buf);
+    return 0;
+}
+
+
+static int
+virCgroupGetStatValue(virCgroupPtr group,
+                      const char *path,
+                      char **value)
+{
+    int fd;
+
+    *value = NULL;
+
+    VIR_DEBUG("Get value %s", path);
+
+    if ((fd = virCgroupStatFileTake(group, path)) >= 0) {
+        if (virCgroupReadStatFile(fd, value) == 0) {
+            virCgroupStatFileGive(group, path, fd);
+            return 0;
+        }
+
+        /* The file may have gone away under us, e.g. because the group
+         * was removed and created again. Retry with a fresh descriptor. */
+        VIR_FORCE_CLOSE(fd);
+    }
+
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0 ||
+        virCgroupReadStatFile(fd, value) < 0) {
+        virReportSystemError(errno, _("Unable to read from '%s'"), path);
+        VIR_FORCE_CLOSE(fd);
+        return -1;
+    }
+
+    virCgroupStatFileGive(group, path, fd);
+    return 0;
+}
+
+
 int
 virCgroupGetValueStr(virCgroupPtr group,
                      int controller,
@@ -558,6 +773,9 @@ virCgroupGetValueStr(virCgroupPtr group,
     if (virCgroupPathOfController(group, controller, key, &keypath) < 0)
         return -1;
 
+    if (virCgroupIsStatFile(key))
+        return virCgroupGetStatValue(group, keypath, value);
+
     return virCgroupGetValueRaw(keypath, value);
 }
 
@@ -699,6 +917,10 @@ virCgroupNew(const char *path,
 
     *group = NULL;
     newGroup = g_new0(virCgroup, 1);
+    if (virMutexInit(&newGroup->statFilesLock) < 0) {
+        virReportSystemError(errno, "%s", _("Unable to initialize mutex"));
+        return -1;
+    }
 
     if (virCgroupSetBackends(newGroup) < 0)
         return -1;
@@ -853,6 +1075,11 @@ virCgroupNewFromParent(virCgroupPtr parent,
     VIR_DEBUG("parent=%p path=%s controllers=%d group=%p",
               parent, path, controllers, group);
 
+    if (virMutexInit(&new->statFilesLock) < 0) {
+        virReportSystemError(errno, "%s", _("Unable to initialize mutex"));
+        return -1;
+    }
+
     if (virCgroupSetBackends(new) < 0)
         return -1;
 
@@ -1076,6 +1303,11 @@ virCgroupNewDetect(pid_t pid,
     VIR_DEBUG("pid=%lld controllers=%d group=%p",
               (long long) pid, controllers, group);
 
+    if (virMutexInit(&new->statFilesLock) < 0) {
+        virReportSystemError(errno, "%s", _("Unable to initialize mutex"));
+        return -1;
+    }
+
     if (virCgroupSetBackends(new) < 0)
         return -1;
 
@@ -2448,6 +2680,8 @@ virCgroupRemove(virCgroupPtr group)
 {
     size_t i;
 
+    virCgroupStatFilesFlush(group);
+
     for (i = 0; i < VIR_CGROUP_BACKEND_TYPE_LAST; i++) {
         if (group->backends[i]) {
             int rc = group->backends[i]->remove(group);
@@ -2707,6 +2941,143 @@ virCgroupGetCpuacctStat(virCgroupPtr group, unsigned long long *user,
 }
 
 
+/**
+ * virCgroupGetCpuacctTimes:
+ * @group: the cgroup to query
+ * @usage: filled with the total CPU time in nanoseconds
+ * @user: filled with the user CPU time in nanoseconds
+ * @sys: filled with the system CPU time in nanoseconds
+ *
+ * Same as calling virCgroupGetCpuacctUsage and virCgroupGetCpuacctStat,
+ * but on the unified hierarchy cpu.stat is read only once.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virCgroupGetCpuacctTimes(virCgroupPtr group,
+                         unsigned long long *usage,
+                         unsigned long long *user,
+                         unsigned long long *sys)
+{
+    VIR_CGROUP_BACKEND_CALL(group, VIR_CGROUP_CONTROLLER_CPUACCT,
+                            getCpuacctTimes, -1, usage, user, sys);
+}
+
+
+int
+virCgroupPressureResourceToController(virCgroupPressureResource resource)
+{
+    switch (resource) {
+    case VIR_CGROUP_PRESSURE_CPU:
+        return VIR_CGROUP_CONTROLLER_CPU;
+    case VIR_CGROUP_PRESSURE_MEMORY:
+        return VIR_CGROUP_CONTROLLER_MEMORY;
+    case VIR_CGROUP_PRESSURE_IO:
+        return VIR_CGROUP_CONTROLLER_BLKIO;
+    case VIR_CGROUP_PRESSURE_LAST:
+        break;
+    }
+
+    return -1;
+}
+
+
+static bool virCgroupPressureAvailable;
+static virOnceControl virCgroupPressureOnce = VIR_ONCE_CONTROL_INITIALIZER;
+
+static void
+virCgroupPressureOnceInit(void)
+{
+    g_autofree char *buf = NULL;
+
+    /* /proc/pressure doesn't exist if the kernel was built without PSI,
+     * reading it fails if PSI was disabled on the kernel command line */
+    if (virFileReadAllQuiet("/proc/pressure/cpu", 1024, &buf) < 0) {
+        VIR_DEBUG("Pressure stall information is not available");
+        return;
+    }
+
+    virCgroupPressureAvailable = true;
+}
+
+
+/**
+ * virCgroupSupportsPressure:
+ * @group: the cgroup
+ * @resource: which resource to check
+ *
+ * Quietly checks whether pressure stall information on @resource can be
+ * obtained for @group. Whether the host kernel provides it at all is
+ * detected only once.
+ *
+ * Returns true if virCgroupGetPressure() can be used, false otherwise.
+ */
+bool
+virCgroupSupportsPressure(virCgroupPtr group,
+                          virCgroupPressureResource resource)
+{
+    int controller = virCgroupPressureResourceToController(resource);
+    size_t i;
+
+    if (virOnce(&virCgroupPressureOnce, virCgroupPressureOnceInit) < 0 ||
+        !virCgroupPressureAvailable)
+        return false;
+
+    for (i = 0; i < VIR_CGROUP_BACKEND_TYPE_LAST; i++) {
+        if (group->backends[i] &&
+            group->backends[i]->hasController(group, controller))
+            return !!group->backends[i]->getPressure;
+    }
+
+    return false;
+}
+
+
+/**
+ * virCgroupGetPressure:
+ * @group: the cgroup
+ * @resource: which resource to report stalls for
+ * @pressure: filled with the pressure stall information
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virCgroupGetPressure(virCgroupPtr group,
+                     virCgroupPressureResource resource,
+                     virCgroupPressurePtr pressure)
+{
+    VIR_CGROUP_BACKEND_CALL(group,
+                            virCgroupPressureResourceToController(resource),
+                            getPressure, -1, resource, pressure);
+}
+
+
+/**
+ * virCgroupOpenPressureTrigger:
+ * @group: the cgroup
+ * @resource: which resource to watch
+ * @stall: stall threshold in microseconds
+ * @window: time window in microseconds
+ *
+ * Arms a kernel pressure stall trigger which fires whenever tasks in
+ * @group were stalled on @resource for at least @stall microseconds
+ * within @window. The trigger lives as long as the returned file
+ * descriptor is open, polling it for POLLPRI reports the events.
+ *
+ * Returns the file descriptor on success, -1 on error.
+ */
+int
+virCgroupOpenPressureTrigger(virCgroupPtr group,
+                             virCgroupPressureResource resource,
+                             unsigned long long stall,
+                             unsigned long long window)
+{
+    VIR_CGROUP_BACKEND_CALL(group,
+                            virCgroupPressureResourceToController(resource),
+                            openPressureTrigger, -1, resource, stall, window);
+}
+
+
 int
 virCgroupSetFreezerState(virCgroupPtr group, const char *state)
 {
@@ -3474,6 +3845,50 @@ virCgroupGetCpuacctStat(virCgroupPtr group G_GNUC_UNUSED,
 }
 
 
+int
+virCgroupGetCpuacctTimes(virCgroupPtr group G_GNUC_UNUSED,
+                         unsigned long long *usage G_GNUC_UNUSED,
+                         unsigned long long *user G_GNUC_UNUSED,
+                         unsigned long long *sys G_GNUC_UNUSED)
+{
+    virReportSystemError(ENOSYS, "%s",
+                         _("Control groups not supported on this platform"));
+    return -1;
+}
+
+
+bool
+virCgroupSupportsPressure(virCgroupPtr group G_GNUC_UNUSED,
+                          virCgroupPressureResource resource G_GNUC_UNUSED)
+{
+    VIR_DEBUG("Control groups not supported on this platform");
+    return false;
+}
+
+
+int
+virCgroupGetPressure(virCgroupPtr group G_GNUC_UNUSED,
+                     virCgroupPressureResource resource G_GNUC_UNUSED,
+                     virCgroupPressurePtr pressure G_GNUC_UNUSED)
+{
+    virReportSystemError(ENOSYS, "%s",
+                         _("Control groups not supported on this platform"));
+    return -1;
+}
+
+
+int
+virCgroupOpenPressureTrigger(virCgroupPtr group G_GNUC_UNUSED,
+                             virCgroupPressureResource resource G_GNUC_UNUSED,
+                             unsigned long long stall G_GNUC_UNUSED,
+                             unsigned long long window G_GNUC_UNUSED)
+{
+    virReportSystemError(ENOSYS, "%s",
+                         _("Control groups not supported on this platform"));
+    return -1;
+}
+
+
 int
 virCgroupGetDomainTotalCpuStats(virCgroupPtr group G_GNUC_UNUSED,
                                 virTypedParameterPtr params G_GNUC_UNUSED,
@@ -3588,6 +4003,10 @@ virCgroupFree(virCgroupPtr group)
     VIR_FREE(group->unified.mountPoint);
     VIR_FREE(group->unified.placement);
 
+    if (group->statFiles)
+        g_hash_table_unref(group->statFiles);
+    virMutexDestroy(&group->statFilesLock);
+
     VIR_FREE(group);
 }
 
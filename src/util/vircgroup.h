@@ -251,6 +251,47 @@ int virCgroupGetCpuacctUsage(virCgroupPtr group, unsigned long long *usage);
 int virCgroupGetCpuacctPercpuUsage(virCgroupPtr group, char **usage);
 int virCgroupGetCpuacctStat(virCgroupPtr group, unsigned long long *user,
                             unsigned long long *sys);
+int virCgroupGetCpuacctTimes(virCgroupPtr group, unsigned long long *usage,
+                             unsigned long long *user,
+                             unsigned long long *sys);
+
+typedef enum {
+    VIR_CGROUP_PRESSURE_CPU,
+    VIR_CGROUP_PRESSURE_MEMORY,
+    VIR_CGROUP_PRESSURE_IO,
+
+    VIR_CGROUP_PRESSURE_LAST
+} virCgroupPressureResource;
+
+VIR_ENUM_DECL(virCgroupPressureResource);
+
+typedef struct _virCgroupPressureStat virCgroupPressureStat;
+typedef virCgroupPressureStat *virCgroupPressureStatPtr;
+struct _virCgroupPressureStat {
+    /* share of wall time stalled in the last 10, 60 and 300 seconds, in % */
+    double avg10;
+    double avg60;
+    double avg300;
+    unsigned long long total; /* total stall time in microseconds */
+};
+
+typedef struct _virCgroupPressure virCgroupPressure;
+typedef virCgroupPressure *virCgroupPressurePtr;
+struct _virCgroupPressure {
+    virCgroupPressureStat some; /* at least one task was stalled */
+    virCgroupPressureStat full; /* all non-idle tasks were stalled */
+    bool hasFull; /* 'full' is not reported for CPU by older kernels */
+};
+
+bool virCgroupSupportsPressure(virCgroupPtr group,
+                               virCgroupPressureResource resource);
+int virCgroupGetPressure(virCgroupPtr group,
+                         virCgroupPressureResource resource,
+                         virCgroupPressurePtr pressure);
+int virCgroupOpenPressureTrigger(virCgroupPtr group,
+                                 virCgroupPressureResource resource,
+                                 unsigned long long stall,
+                                 unsigned long long window);
 
 int virCgroupSetFreezerState(virCgroupPtr group, const char *state);
 int virCgroupGetFreezerState(virCgroupPtr group, char **state);
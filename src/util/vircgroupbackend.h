@@ -331,6 +331,23 @@ typedef int
                              unsigned long long *user,
                              unsigned long long *sys);
 
+typedef int
+(*virCgroupGetCpuacctTimesCB)(virCgroupPtr group,
+                              unsigned long long *usage,
+                              unsigned long long *user,
+                              unsigned long long *sys);
+
+typedef int
+(*virCgroupGetPressureCB)(virCgroupPtr group,
+                          virCgroupPressureResource resource,
+                          virCgroupPressurePtr pressure);
+
+typedef int
+(*virCgroupOpenPressureTriggerCB)(virCgroupPtr group,
+                                  virCgroupPressureResource resource,
+                                  unsigned long long stall,
+                                  unsigned long long window);
+
 typedef int
 (*virCgroupSetFreezerStateCB)(virCgroupPtr group,
                               const char *state);
@@ -431,6 +448,10 @@ struct _virCgroupBackend {
     virCgroupGetCpuacctUsageCB getCpuacctUsage;
     virCgroupGetCpuacctPercpuUsageCB getCpuacctPercpuUsage;
     virCgroupGetCpuacctStatCB getCpuacctStat;
+    virCgroupGetCpuacctTimesCB getCpuacctTimes;
+
+    virCgroupGetPressureCB getPressure;
+    virCgroupOpenPressureTriggerCB openPressureTrigger;
 
     virCgroupSetFreezerStateCB setFreezerState;
     virCgroupGetFreezerStateCB getFreezerState;
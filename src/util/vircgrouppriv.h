@@ -27,6 +27,7 @@
 
 #include "vircgroup.h"
 #include "vircgroupbackend.h"
+#include "virthread.h"
 
 struct _virCgroupV1Controller {
     int type;
@@ -64,8 +65,15 @@ struct _virCgroup {
 
     virCgroupV1Controller legacy[VIR_CGROUP_CONTROLLER_LAST];
     virCgroupV2Controller unified;
+
+    /* path -> open descriptor of polled statistics files, guarded by
+     * @statFilesLock which is never held while reading the files */
+    virMutex statFilesLock;
+    GHashTable *statFiles;
 };
 
+int virCgroupPressureResourceToController(virCgroupPressureResource resource);
+
 int virCgroupSetValueRaw(const char *path,
                          const char *value);
 
@@ -2022,6 +2022,19 @@ virCgroupV1GetCpuacctStat(virCgroupPtr group,
 }
 
 
+static int
+virCgroupV1GetCpuacctTimes(virCgroupPtr group,
+                           unsigned long long *usage,
+                           unsigned long long *user,
+                           unsigned long long *sys)
+{
+    if (virCgroupV1GetCpuacctUsage(group, usage) < 0)
+        return -1;
+
+    return virCgroupV1GetCpuacctStat(group, user, sys);
+}
+
+
 static int
 virCgroupV1SetFreezerState(virCgroupPtr group,
                            const char *state)
@@ -2177,6 +2190,7 @@ virCgroupBackend virCgroupV1Backend = {
     .getCpuacctUsage = virCgroupV1GetCpuacctUsage,
     .getCpuacctPercpuUsage = virCgroupV1GetCpuacctPercpuUsage,
     .getCpuacctStat = virCgroupV1GetCpuacctStat,
+    .getCpuacctTimes = virCgroupV1GetCpuacctTimes,
 
     .setFreezerState = virCgroupV1SetFreezerState,
     .getFreezerState = virCgroupV1GetFreezerState,
@@ -21,6 +21,7 @@
 
 #include <unistd.h>
 #ifdef __linux__
+# include <fcntl.h>
 # include <mntent.h>
 # include <sys/mount.h>
 #endif /* __linux__ */
@@ -1608,32 +1609,93 @@ virCgroupV2SupportsCpuBW(virCgroupPtr cgroup)
 }
 
 
+typedef struct _virCgroupV2CpuStat virCgroupV2CpuStat;
+struct _virCgroupV2CpuStat {
+    unsigned long long usage; /* in nanoseconds */
+    unsigned long long user; /* in nanoseconds */
+    unsigned long long sys; /* in nanoseconds */
+};
+
+
+/**
+ * virCgroupV2GetCpuStat:
+ * @group: the cgroup
+ * @stat: filled with the parsed values
+ *
+ * Reads 'cpu.stat' and parses all the values we're interested in in a
+ * single pass.
+ *
+ * Returns 0 on success, -1 on error.
+ */
 static int
-virCgroupV2GetCpuacctUsage(virCgroupPtr group,
-                           unsigned long long *usage)
+virCgroupV2GetCpuStat(virCgroupPtr group,
+                      virCgroupV2CpuStat *stat)
 {
     g_autofree char *str = NULL;
-    char *tmp;
+    char *line;
+    bool haveUsage = false;
+    bool haveUser = false;
+    bool haveSys = false;
 
     if (virCgroupGetValueStr(group, VIR_CGROUP_CONTROLLER_CPUACCT,
                              "cpu.stat", &str) < 0) {
         return -1;
     }
 
-    if (!(tmp = strstr(str, "usage_usec "))) {
-        virReportError(VIR_ERR_INTERNAL_ERROR,
-                       _("cannot parse cpu usage stat '%s'"), str);
-        return -1;
+    line = str;
+    while (line && *line) {
+        char *newLine = strchr(line, '\n');
+        char *valueStr = strchr(line, ' ');
+        unsigned long long value;
+
+        if (newLine)
+            *newLine = '\0';
+
+        if (valueStr) {
+            *valueStr = '\0';
+
+            if (virStrToLong_ull(valueStr + 1, NULL, 10, &value) < 0) {
+                virReportError(VIR_ERR_INTERNAL_ERROR,
+                               _("Failed to parse value '%s' as number."),
+                               valueStr + 1);
+                return -1;
+            }
+
+            if (STREQ(line, "usage_usec")) {
+                stat->usage = value * 1000;
+                haveUsage = true;
+            } else if (STREQ(line, "user_usec")) {
+                stat->user = value * 1000;
+                haveUser = true;
+            } else if (STREQ(line, "system_usec")) {
+                stat->sys = value * 1000;
+                haveSys = true;
+            }
+        }
+
+        line = newLine ? newLine + 1 : NULL;
     }
-    tmp += strlen("usage_usec ");
 
-    if (virStrToLong_ull(tmp, &tmp, 10, usage) < 0) {
-        virReportError(VIR_ERR_INTERNAL_ERROR,
-                       _("Failed to parse value '%s' as number."), tmp);
+    if (!haveUsage || !haveUser || !haveSys) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       _("cannot parse cgroup 'cpu.stat' file"));
         return -1;
     }
 
-    *usage *= 1000;
+    return 0;
+}
+
+
+static int
+virCgroupV2GetCpuacctUsage(virCgroupPtr group,
+                           unsigned long long *usage)
+{
+    virCgroupV2CpuStat stat;
+
+    if (virCgroupV2GetCpuStat(group, &stat) < 0)
+        return -1;
+
+    *usage = stat.usage;
 
     return 0;
 }
@@ -1644,46 +1706,148 @@ virCgroupV2GetCpuacctStat(virCgroupPtr group,
                           unsigned long long *user,
                           unsigned long long *sys)
 {
-    g_autofree char *str = NULL;
-    char *tmp;
-    unsigned long long userVal = 0;
-    unsigned long long sysVal = 0;
+    virCgroupV2CpuStat stat;
 
-    if (virCgroupGetValueStr(group, VIR_CGROUP_CONTROLLER_CPUACCT,
-                             "cpu.stat", &str) < 0) {
+    if (virCgroupV2GetCpuStat(group, &stat) < 0)
         return -1;
-    }
 
-    if (!(tmp = strstr(str, "user_usec "))) {
-        virReportError(VIR_ERR_INTERNAL_ERROR,
-                       _("cannot parse cpu user stat '%s'"), str);
+    *user = stat.user;
+    *sys = stat.sys;
+
+    return 0;
+}
+
+
+static int
+virCgroupV2GetCpuacctTimes(virCgroupPtr group,
+                           unsigned long long *usage,
+                           unsigned long long *user,
+                           unsigned long long *sys)
+{
+    virCgroupV2CpuStat stat;
+
+    if (virCgroupV2GetCpuStat(group, &stat) < 0)
         return -1;
+
+    *usage = stat.usage;
+    *user = stat.user;
+    *sys = stat.sys;
+
+    return 0;
+}
+
+
+static int
+virCgroupV2ParsePressureLine(char *line,
+                             virCgroupPressureStatPtr stat)
+{
+    g_auto(GStrv) fields = g_strsplit(line, " ", 0);
+    size_t i;
+
+    for (i = 0; fields[i]; i++) {
+        char *value = strchr(fields[i], '=');
+        int rc = 0;
+
+        if (!value)
+            continue;
+        *value++ = '\0';
+
+        if (STREQ(fields[i], "avg10"))
+            rc = virStrToDouble(value, NULL, &stat->avg10);
+        else if (STREQ(fields[i], "avg60"))
+            rc = virStrToDouble(value, NULL, &stat->avg60);
+        else if (STREQ(fields[i], "avg300"))
+            rc = virStrToDouble(value, NULL, &stat->avg300);
+        else if (STREQ(fields[i], "total"))
+            rc = virStrToLong_ull(value, NULL, 10, &stat->total);
+
+        if (rc < 0) {
+            virReportError(VIR_ERR_INTERNAL_ERROR,
+                           _("Unable to parse pressure value '%s'"), value);
+            return -1;
+        }
     }
-    tmp += strlen("user_usec ");
 
-    if (virStrToLong_ull(tmp, &tmp, 10, &userVal) < 0) {
-        virReportError(VIR_ERR_INTERNAL_ERROR,
-                       _("Failed to parse value '%s' as number."), tmp);
+    return 0;
+}
+
+
+static int
+virCgroupV2GetPressure(virCgroupPtr group,
+                       virCgroupPressureResource resource,
+                       virCgroupPressurePtr pressure)
+{
+    g_autofree char *file = NULL;
+    g_autofree char *str = NULL;
+    g_auto(GStrv) lines = NULL;
+    size_t i;
+
+    file = g_strdup_printf("%s.pressure",
+                           virCgroupPressureResourceTypeToString(resource));
+
+    if (virCgroupGetValueStr(group,
+                             virCgroupPressureResourceToController(resource),
+                             file, &str) < 0)
         return -1;
+
+    memset(pressure, 0, sizeof(*pressure));
+
+    lines = g_strsplit(str, "\n", 0);
+    for (i = 0; lines[i]; i++) {
+        char *line = lines[i];
+
+        if (STRPREFIX(line, "some ")) {
+            if (virCgroupV2ParsePressureLine(line + 5, &pressure->some) < 0)
+                return -1;
+        } else if (STRPREFIX(line, "full ")) {
+            if (virCgroupV2ParsePressureLine(line + 5, &pressure->full) < 0)
+                return -1;
+            pressure->hasFull = true;
+        }
     }
 
-    if (!(tmp = strstr(str, "system_usec "))) {
-        virReportError(VIR_ERR_INTERNAL_ERROR,
-                       _("cannot parse cpu sys stat '%s'"), str);
+    return 0;
+}
+
+
+static int
+virCgroupV2OpenPressureTrigger(virCgroupPtr group,
+                               virCgroupPressureResource resource,
+                               unsigned long long stall,
+                               unsigned long long window)
+{
+    g_autofree char *file = NULL;
+    g_autofree char *path = NULL;
+    g_autofree char *trigger = NULL;
+    int fd;
+
+    file = g_strdup_printf("%s.pressure",
+                           virCgroupPressureResourceTypeToString(resource));
+
+    if (virCgroupPathOfController(group,
+                                  virCgroupPressureResourceToController(resource),
+                                  file, &path) < 0)
         return -1;
-    }
-    tmp += strlen("system_usec ");
 
-    if (virStrToLong_ull(tmp, &tmp, 10, &sysVal) < 0) {
-        virReportError(VIR_ERR_INTERNAL_ERROR,
-                       _("Failed to parse value '%s' as number."), tmp);
+    trigger = g_strdup_printf("some %llu %llu", stall, window);
+
+    VIR_DEBUG("Arming pressure trigger '%s' on %s", trigger, path);
+
+    if ((fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC)) < 0) {
+        virReportSystemError(errno, _("Unable to open '%s'"), path);
         return -1;
     }
 
-    *user = userVal * 1000;
-    *sys = sysVal * 1000;
+    /* The kernel expects the trigger including the terminating NUL */
+    if (safewrite(fd, trigger, strlen(trigger) + 1) < 0) {
+        virReportSystemError(errno,
+                             _("Unable to set pressure trigger '%s' on '%s'"),
+                             trigger, path);
+        VIR_FORCE_CLOSE(fd);
+        return -1;
+    }
 
-    return 0;
+    return fd;
 }
 
 
@@ -1910,6 +2074,10 @@ virCgroupBackend virCgroupV2Backend = {
 
     .getCpuacctUsage = virCgroupV2GetCpuacctUsage,
     .getCpuacctStat = virCgroupV2GetCpuacctStat,
+    .getCpuacctTimes = virCgroupV2GetCpuacctTimes,
+
+    .getPressure = virCgroupV2GetPressure,
+    .openPressureTrigger = virCgroupV2OpenPressureTrigger,
 
     .setCpusetMems = virCgroupV2SetCpusetMems,
     .getCpusetMems = virCgroupV2GetCpusetMems,
@@ -112,3 +112,59 @@
 #define virReadBufInt16LE(buf) \
     ((uint16_t)(uint8_t)((buf)[0]) | \
      ((uint16_t)(uint8_t)((buf)[1]) << 8))
+
+/**
+ * virWriteBufInt64BE:
+ * @buf: byte to start writing at (can be 'char*' or 'unsigned char*');
+ *       evaluating buf must not have any side effects
+ * @val: value to write
+ *
+ * Write @val as a big-endian 64-bit number into 8 bytes at BUF.  Caller
+ * is responsible to avoid writing beyond array bounds.
+ */
+#define virWriteBufInt64BE(buf, val) \
+    do { \
+        uint64_t _val = (val); \
+        (buf)[0] = (uint8_t)(_val >> 56); \
+        (buf)[1] = (uint8_t)(_val >> 48); \
+        (buf)[2] = (uint8_t)(_val >> 40); \
+        (buf)[3] = (uint8_t)(_val >> 32); \
+        (buf)[4] = (uint8_t)(_val >> 24); \
+        (buf)[5] = (uint8_t)(_val >> 16); \
+        (buf)[6] = (uint8_t)(_val >> 8); \
+        (buf)[7] = (uint8_t)_val; \
+    } while (0)
+
+/**
+ * virWriteBufInt32BE:
+ * @buf: byte to start writing at (can be 'char*' or 'unsigned char*');
+ *       evaluating buf must not have any side effects
+ * @val: value to write
+ *
+ * Write @val as a big-endian 32-bit number into 4 bytes at BUF.  Caller
+ * is responsible to avoid writing beyond array bounds.
+ */
+#define virWriteBufInt32BE(buf, val) \
+    do { \
+        uint32_t _val = (val); \
+        (buf)[0] = (uint8_t)(_val >> 24); \
+        (buf)[1] = (uint8_t)(_val >> 16); \
+        (buf)[2] = (uint8_t)(_val >> 8); \
+        (buf)[3] = (uint8_t)_val; \
+    } while (0)
+
+/**
+ * virWriteBufInt16BE:
+ * @buf: byte to start writing at (can be 'char*' or 'unsigned char*');
+ *       evaluating buf must not have any side effects
+ * @val: value to write
+ *
+ * Write @val as a big-endian 16-bit number into 2 bytes at BUF.  Caller
+ * is responsible to avoid writing beyond array bounds.
+ */
+#define virWriteBufInt16BE(buf, val) \
+    do { \
+        uint16_t _val = (val); \
+        (buf)[0] = (uint8_t)(_val >> 8); \
+        (buf)[1] = (uint8_t)_val; \
+    } while (0)
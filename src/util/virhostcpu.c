@@ -42,6 +42,7 @@
 #include "viralloc.h"
 #define LIBVIRT_VIRHOSTCPUPRIV_H_ALLOW
 #include "virhostcpupriv.h"
+#include "virhoststats.h"
 #include "virerror.h"
 #include "virarch.h"
 #include "virfile.h"
@@ -784,10 +785,9 @@ virHostCPUGetStatsLinux(FILE *procstat,
                         virNodeCPUStatsPtr params,
                         int *nparams)
 {
-    char line[1024];
-    unsigned long long usr, ni, sys, idle, iowait;
-    unsigned long long irq, softirq, steal, guest, guest_nice;
-    char cpu_header[4 + VIR_INT64_STR_BUFLEN];
+    g_autoptr(virHostStats) stats = NULL;
+    virHostStatsCPUPtr cpu = NULL;
+    size_t i;
 
     if ((*nparams) == 0) {
         /* Current number of cpu stats supported by linux */
@@ -802,49 +802,42 @@ virHostCPUGetStatsLinux(FILE *procstat,
         return -1;
     }
 
-    if (cpuNum == VIR_NODE_CPU_STATS_ALL_CPUS) {
-        strcpy(cpu_header, "cpu ");
-    } else {
-        g_snprintf(cpu_header, sizeof(cpu_header), "cpu%d ", cpuNum);
-    }
+    stats = g_new0(virHostStats, 1);
 
-    while (fgets(line, sizeof(line), procstat) != NULL) {
-        char *buf = line;
+    if (virHostStatsParseCPU(procstat, TICK_TO_NSEC, stats) < 0)
+        return -1;
 
-        if (STRPREFIX(buf, cpu_header)) { /* aka logical CPU time */
-            if (sscanf(buf,
-                       "%*s %llu %llu %llu %llu %llu" /* user ~ iowait */
-                       "%llu %llu %llu %llu %llu",    /* irq  ~ guest_nice */
-                       &usr, &ni, &sys, &idle, &iowait,
-                       &irq, &softirq, &steal, &guest, &guest_nice) < 4) {
-                continue;
+    if (cpuNum == VIR_NODE_CPU_STATS_ALL_CPUS) {
+        /* id stays 0 if the summary line was missing */
+        if (stats->cpu.id == -1)
+            cpu = &stats->cpu;
+    } else {
+        for (i = 0; i < stats->ncpus; i++) {
+            if (stats->cpus[i].id == cpuNum) {
+                cpu = &stats->cpus[i];
+                break;
             }
-
-            if (virHostCPUStatsAssign(&params[0], VIR_NODE_CPU_STATS_KERNEL,
-                                      (sys + irq + softirq) * TICK_TO_NSEC) < 0)
-                return -1;
-
-            if (virHostCPUStatsAssign(&params[1], VIR_NODE_CPU_STATS_USER,
-                                      (usr + ni) * TICK_TO_NSEC) < 0)
-                return -1;
-
-            if (virHostCPUStatsAssign(&params[2], VIR_NODE_CPU_STATS_IDLE,
-                                      idle * TICK_TO_NSEC) < 0)
-                return -1;
-
-            if (virHostCPUStatsAssign(&params[3], VIR_NODE_CPU_STATS_IOWAIT,
-                                      iowait * TICK_TO_NSEC) < 0)
-                return -1;
-
-            return 0;
         }
     }
 
-    virReportInvalidArg(cpuNum,
-                        _("Invalid cpuNum in %s"),
-                        __FUNCTION__);
+    if (!cpu) {
+        virReportInvalidArg(cpuNum,
+                            _("Invalid cpuNum in %s"),
+                            __FUNCTION__);
+        return -1;
+    }
+
+    if (virHostCPUStatsAssign(&params[0], VIR_NODE_CPU_STATS_KERNEL,
+                              cpu->kernel) < 0 ||
+        virHostCPUStatsAssign(&params[1], VIR_NODE_CPU_STATS_USER,
+                              cpu->user) < 0 ||
+        virHostCPUStatsAssign(&params[2], VIR_NODE_CPU_STATS_IDLE,
+                              cpu->idle) < 0 ||
+        virHostCPUStatsAssign(&params[3], VIR_NODE_CPU_STATS_IOWAIT,
+                              cpu->iowait) < 0)
+        return -1;
 
-    return -1;
+    return 0;
 }
 
 
@@ -38,6 +38,7 @@
 
 #include "viralloc.h"
 #include "virhostmem.h"
+#include "virhoststats.h"
 #include "virerror.h"
 #include "virarch.h"
 #include "virfile.h"
@@ -144,21 +145,17 @@ virHostMemGetStatsLinux(FILE *meminfo,
                         virNodeMemoryStatsPtr params,
                         int *nparams)
 {
-    size_t i = 0, j = 0, k = 0;
-    int found = 0;
+    virHostStatsMemory memory = { 0 };
+    size_t i;
     int nr_param;
-    char line[1024];
-    char meminfo_hdr[VIR_NODE_MEMORY_STATS_FIELD_LENGTH + 1];
-    unsigned long val;
     struct field_conv {
-        const char *meminfo_hdr;  /* meminfo header */
-        const char *field;        /* MemoryStats field name */
+        const char *field;              /* MemoryStats field name */
+        unsigned long long *value;      /* parsed value */
     } field_conv[] = {
-        {"MemTotal:", VIR_NODE_MEMORY_STATS_TOTAL},
-        {"MemFree:",  VIR_NODE_MEMORY_STATS_FREE},
-        {"Buffers:",  VIR_NODE_MEMORY_STATS_BUFFERS},
-        {"Cached:",   VIR_NODE_MEMORY_STATS_CACHED},
-        {NULL,        NULL}
+        {VIR_NODE_MEMORY_STATS_TOTAL,   &memory.total},
+        {VIR_NODE_MEMORY_STATS_FREE,    &memory.free},
+        {VIR_NODE_MEMORY_STATS_BUFFERS, &memory.buffers},
+        {VIR_NODE_MEMORY_STATS_CACHED,  &memory.cached},
     };
 
     if (cellNum == VIR_NODE_MEMORY_STATS_ALL_CELLS) {
@@ -180,62 +177,18 @@ virHostMemGetStatsLinux(FILE *meminfo,
         return -1;
     }
 
-    while (fgets(line, sizeof(line), meminfo) != NULL) {
-        char *buf = line;
-
-        if (STRPREFIX(buf, "Node ")) {
-            /*
-             * /sys/devices/system/node/nodeX/meminfo format is below.
-             * So, skip prefix "Node XX ".
-             *
-             * Node 0 MemTotal:        8386980 kB
-             * Node 0 MemFree:         5300920 kB
-             *         :
-             */
-            char *p;
-
-            p = buf;
-            for (i = 0; i < 2; i++) {
-                p = strchr(p, ' ');
-                if (p == NULL) {
-                    virReportError(VIR_ERR_INTERNAL_ERROR,
-                                   "%s", _("no prefix found"));
-                    return -1;
-                }
-                p++;
-            }
-            buf = p;
-        }
+    if (virHostStatsParseMemory(meminfo, &memory) < 0)
+        return -1;
 
-# define MEM_MAX_LEN G_STRINGIFY(VIR_NODE_MEMORY_STATS_FIELD_LENGTH)
-        if (sscanf(buf, "%" MEM_MAX_LEN "s %lu kB", meminfo_hdr, &val) < 2)
-            continue;
-# undef MEM_MAX_LEN
-
-        for (j = 0; field_conv[j].meminfo_hdr != NULL; j++) {
-            struct field_conv *convp = &field_conv[j];
-
-            if (STREQ(meminfo_hdr, convp->meminfo_hdr)) {
-                virNodeMemoryStatsPtr param = &params[k++];
-
-                if (virStrcpyStatic(param->field, convp->field) < 0) {
-                    virReportError(VIR_ERR_INTERNAL_ERROR,
-                                   "%s", _("Field kernel memory too long for destination"));
-                    return -1;
-                }
-                param->value = val;
-                found++;
-                break;
-            }
-        }
-        if (found >= nr_param)
-            break;
-    }
+    for (i = 0; i < nr_param; i++) {
+        virNodeMemoryStatsPtr param = &params[i];
 
-    if (found == 0) {
-        virReportError(VIR_ERR_INTERNAL_ERROR,
-                       "%s", _("no available memory line found"));
-        return -1;
+        if (virStrcpyStatic(param->field, field_conv[i].field) < 0) {
+            virReportError(VIR_ERR_INTERNAL_ERROR,
+                           "%s", _("Field kernel memory too long for destination"));
+            return -1;
+        }
+        param->value = *field_conv[i].value;
     }
 
     return 0;
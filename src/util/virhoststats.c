@@ -0,0 +1,371 @@
+/*
+ * virhoststats.c: snapshot of host CPU and memory statistics
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <unistd.h>
+
+#include "virhoststats.h"
+#include "viralloc.h"
+#include "virerror.h"
+#include "virfile.h"
+#include "virlog.h"
+#include "virnuma.h"
+#include "virstring.h"
+
+#define VIR_FROM_THIS VIR_FROM_NONE
+
+VIR_LOG_INIT("util.hoststats");
+
+#define PROCSTAT_PATH "/proc/stat"
+#define MEMINFO_PATH "/proc/meminfo"
+#define SYSFS_SYSTEM_PATH "/sys/devices/system"
+
+
+void
+virHostStatsFree(virHostStatsPtr stats)
+{
+    size_t i;
+
+    if (!stats)
+        return;
+
+    for (i = 0; i < stats->ncells; i++) {
+        g_free(stats->cells[i].pageSizes);
+        g_free(stats->cells[i].pagesTotal);
+        g_free(stats->cells[i].pagesFree);
+    }
+
+    g_free(stats->cells);
+    g_free(stats->cpus);
+    g_free(stats);
+}
+
+
+/**
+ * virHostStatsParseCPU:
+ * @procstat: opened /proc/stat
+ * @tick_nsec: length of a clock tick in nanoseconds
+ * @stats: snapshot to fill
+ *
+ * Parses the summary line and the lines of all online host CPUs from
+ * @procstat in one pass and stores them into @stats. Times are
+ * converted from clock ticks to nanoseconds.
+ *
+ * Returns 0 on success, -1 otherwise (with error reported).
+ */
+int
+virHostStatsParseCPU(FILE *procstat,
+                     unsigned long long tick_nsec,
+                     virHostStatsPtr stats)
+{
+    char line[1024];
+    bool found = false;
+
+    while (fgets(line, sizeof(line), procstat) != NULL) {
+        unsigned long long usr, ni, sys, idle, iowait;
+        unsigned long long irq = 0, softirq = 0;
+        virHostStatsCPU cpu = { 0 };
+        char *tmp;
+
+        if (!STRPREFIX(line, "cpu")) {
+            /* The CPU lines are always first, no need to read the rest. */
+            if (found)
+                break;
+            continue;
+        }
+
+        if (line[3] == ' ') {
+            cpu.id = -1;
+        } else if (virStrToLong_i(line + 3, &tmp, 10, &cpu.id) < 0 ||
+                   cpu.id < 0 || *tmp != ' ') {
+            continue;
+        }
+
+        if (sscanf(line,
+                   "%*s %llu %llu %llu %llu %llu" /* user ~ iowait */
+                   "%llu %llu",                   /* irq, softirq */
+                   &usr, &ni, &sys, &idle, &iowait,
+                   &irq, &softirq) < 4)
+            continue;
+
+        cpu.kernel = (sys + irq + softirq) * tick_nsec;
+        cpu.user = (usr + ni) * tick_nsec;
+        cpu.idle = idle * tick_nsec;
+        cpu.iowait = iowait * tick_nsec;
+
+        if (cpu.id == -1)
+            stats->cpu = cpu;
+        else
+            ignore_value(VIR_APPEND_ELEMENT(stats->cpus, stats->ncpus, cpu));
+
+        found = true;
+    }
+
+    if (!found) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       _("no CPU statistics found"));
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * virHostStatsParseMemory:
+ * @meminfo: opened /proc/meminfo or per node meminfo file
+ * @memory: statistics to fill
+ *
+ * Parses the fields libvirt reports out of @meminfo. The "Node N "
+ * prefix of per node files is skipped. Fields missing from @meminfo,
+ * e.g. "Buffers:" in per node files, are left untouched.
+ *
+ * Returns 0 on success, -1 otherwise (with error reported).
+ */
+int
+virHostStatsParseMemory(FILE *meminfo,
+                        virHostStatsMemoryPtr memory)
+{
+    char line[1024];
+    size_t found = 0;
+
+    while (fgets(line, sizeof(line), meminfo) != NULL) {
+        char *buf = line;
+        char hdr[32];
+        unsigned long long val;
+
+        if (STRPREFIX(buf, "Node ")) {
+            /* Node 0 MemTotal:        8386980 kB */
+            size_t i;
+
+            for (i = 0; i < 2; i++) {
+                if (!(buf = strchr(buf, ' '))) {
+                    virReportError(VIR_ERR_INTERNAL_ERROR,
+                                   "%s", _("no prefix found"));
+                    return -1;
+                }
+                buf++;
+            }
+        }
+
+        if (sscanf(buf, "%31s %llu kB", hdr, &val) < 2)
+            continue;
+
+        if (STREQ(hdr, "MemTotal:"))
+            memory->total = val;
+        else if (STREQ(hdr, "MemFree:"))
+            memory->free = val;
+        else if (STREQ(hdr, "Buffers:"))
+            memory->buffers = val;
+        else if (STREQ(hdr, "Cached:"))
+            memory->cached = val;
+        else
+            continue;
+
+        if (++found == 4)
+            break;
+    }
+
+    if (found == 0) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       _("no memory statistics found"));
+        return -1;
+    }
+
+    return 0;
+}
+
+
+#ifdef __linux__
+static FILE *
+virHostStatsOpen(const char *path)
+{
+    FILE *fp;
+
+    if (!(fp = fopen(path, "r")))
+        virReportSystemError(errno, _("cannot open %s"), path);
+
+    return fp;
+}
+
+
+static int
+virHostStatsCollectCell(virHostStatsPtr stats,
+                        int node)
+{
+    virHostStatsCell cell = { .id = node };
+    g_autofree char *path = NULL;
+    g_autoptr(FILE) meminfo = NULL;
+
+    if (node < 0) {
+        /* Without NUMA the whole host is reported as cell 0 */
+        cell.id = 0;
+        cell.memory.total = stats->memory.total;
+        cell.memory.free = stats->memory.free;
+    } else {
+        path = g_strdup_printf(SYSFS_SYSTEM_PATH "/node/node%d/meminfo", node);
+
+        if (!(meminfo = virHostStatsOpen(path)) ||
+            virHostStatsParseMemory(meminfo, &cell.memory) < 0)
+            return -1;
+
+        /* buffers and cached are not reported per node */
+        cell.memory.buffers = 0;
+        cell.memory.cached = 0;
+    }
+
+    if (virNumaGetHugePages(node, &cell.pageSizes, &cell.pagesTotal,
+                            &cell.pagesFree, &cell.npages) < 0)
+        return -1;
+
+    ignore_value(VIR_APPEND_ELEMENT(stats->cells, stats->ncells, cell));
+    return 0;
+}
+#endif /* __linux__ */
+
+
+/**
+ * virHostStatsNew:
+ *
+ * Takes a snapshot of the host CPU and memory statistics. Each source,
+ * i.e. /proc/stat, /proc/meminfo, meminfo of every NUMA node and the
+ * huge page pools of every node, is read exactly once so that the
+ * cost of the snapshot does not grow with the number of CPUs or cells
+ * queried from it.
+ *
+ * Returns the snapshot on success, NULL otherwise (with error
+ * reported).
+ */
+virHostStatsPtr
+virHostStatsNew(void)
+{
+#ifdef __linux__
+    g_autoptr(virHostStats) stats = g_new0(virHostStats, 1);
+    g_autoptr(FILE) procstat = NULL;
+    g_autoptr(FILE) meminfo = NULL;
+    unsigned long long tick_nsec = 1000ull * 1000ull * 1000ull /
+                                   sysconf(_SC_CLK_TCK);
+
+    if (!(procstat = virHostStatsOpen(PROCSTAT_PATH)) ||
+        virHostStatsParseCPU(procstat, tick_nsec, stats) < 0)
+        return NULL;
+
+    if (!(meminfo = virHostStatsOpen(MEMINFO_PATH)) ||
+        virHostStatsParseMemory(meminfo, &stats->memory) < 0)
+        return NULL;
+
+    if (virNumaIsAvailable()) {
+        int max_node;
+        int node;
+
+        if ((max_node = virNumaGetMaxNode()) < 0)
+            return NULL;
+
+        for (node = 0; node <= max_node; node++) {
+            if (!virNumaNodeIsAvailable(node))
+                continue;
+
+            if (virHostStatsCollectCell(stats, node) < 0)
+                return NULL;
+        }
+    } else {
+        if (virHostStatsCollectCell(stats, -1) < 0)
+            return NULL;
+    }
+
+    return g_steal_pointer(&stats);
+#else
+    virReportError(VIR_ERR_NO_SUPPORT, "%s",
+                   _("node stats not implemented on this platform"));
+    return NULL;
+#endif
+}
+
+
+/**
+ * virHostStatsFormatParams:
+ * @stats: snapshot
+ * @params: returned array of typed parameters
+ * @nparams: returned size of @params
+ *
+ * Converts @stats into the typed parameters returned by
+ * virNodeGetAllStats().
+ *
+ * Returns 0 on success, -1 otherwise (with error reported).
+ */
+int
+virHostStatsFormatParams(virHostStatsPtr stats,
+                         virTypedParameterPtr *params,
+                         int *nparams)
+{
+    g_autoptr(virTypedParamList) list = g_new0(virTypedParamList, 1);
+    size_t i;
+    size_t j;
+
+    if (virTypedParamListAddULLong(list, stats->cpu.kernel, "cpu.kernel") < 0 ||
+        virTypedParamListAddULLong(list, stats->cpu.user, "cpu.user") < 0 ||
+        virTypedParamListAddULLong(list, stats->cpu.idle, "cpu.idle") < 0 ||
+        virTypedParamListAddULLong(list, stats->cpu.iowait, "cpu.iowait") < 0 ||
+        virTypedParamListAddUInt(list, stats->ncpus, "cpu.count") < 0)
+        return -1;
+
+    for (i = 0; i < stats->ncpus; i++) {
+        virHostStatsCPUPtr cpu = stats->cpus + i;
+
+        if (virTypedParamListAddUInt(list, cpu->id, "cpu.%zu.id", i) < 0 ||
+            virTypedParamListAddULLong(list, cpu->kernel, "cpu.%zu.kernel", i) < 0 ||
+            virTypedParamListAddULLong(list, cpu->user, "cpu.%zu.user", i) < 0 ||
+            virTypedParamListAddULLong(list, cpu->idle, "cpu.%zu.idle", i) < 0 ||
+            virTypedParamListAddULLong(list, cpu->iowait, "cpu.%zu.iowait", i) < 0)
+            return -1;
+    }
+
+    if (virTypedParamListAddULLong(list, stats->memory.total, "memory.total") < 0 ||
+        virTypedParamListAddULLong(list, stats->memory.free, "memory.free") < 0 ||
+        virTypedParamListAddULLong(list, stats->memory.buffers, "memory.buffers") < 0 ||
+        virTypedParamListAddULLong(list, stats->memory.cached, "memory.cached") < 0 ||
+        virTypedParamListAddUInt(list, stats->ncells, "cell.count") < 0)
+        return -1;
+
+    for (i = 0; i < stats->ncells; i++) {
+        virHostStatsCellPtr cell = stats->cells + i;
+
+        if (virTypedParamListAddUInt(list, cell->id, "cell.%zu.id", i) < 0 ||
+            virTypedParamListAddULLong(list, cell->memory.total,
+                                       "cell.%zu.memory.total", i) < 0 ||
+            virTypedParamListAddULLong(list, cell->memory.free,
+                                       "cell.%zu.memory.free", i) < 0 ||
+            virTypedParamListAddUInt(list, cell->npages,
+                                     "cell.%zu.hugepage.count", i) < 0)
+            return -1;
+
+        for (j = 0; j < cell->npages; j++) {
+            if (virTypedParamListAddUInt(list, cell->pageSizes[j],
+                                         "cell.%zu.hugepage.%zu.size", i, j) < 0 ||
+                virTypedParamListAddULLong(list, cell->pagesTotal[j],
+                                           "cell.%zu.hugepage.%zu.total", i, j) < 0 ||
+                virTypedParamListAddULLong(list, cell->pagesFree[j],
+                                           "cell.%zu.hugepage.%zu.free", i, j) < 0)
+                return -1;
+        }
+    }
+
+    *nparams = virTypedParamListStealParams(list, params);
+    return 0;
+}
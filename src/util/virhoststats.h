@@ -0,0 +1,86 @@
+/*
+ * virhoststats.h: snapshot of host CPU and memory statistics
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "internal.h"
+#include "virtypedparam.h"
+
+typedef struct _virHostStatsCPU virHostStatsCPU;
+typedef virHostStatsCPU *virHostStatsCPUPtr;
+struct _virHostStatsCPU {
+    int id; /* -1 for the sum of all CPUs */
+
+    /* all in nanoseconds */
+    unsigned long long kernel;
+    unsigned long long user;
+    unsigned long long idle;
+    unsigned long long iowait;
+};
+
+typedef struct _virHostStatsMemory virHostStatsMemory;
+typedef virHostStatsMemory *virHostStatsMemoryPtr;
+struct _virHostStatsMemory {
+    /* all in KiB */
+    unsigned long long total;
+    unsigned long long free;
+    unsigned long long buffers;
+    unsigned long long cached;
+};
+
+typedef struct _virHostStatsCell virHostStatsCell;
+typedef virHostStatsCell *virHostStatsCellPtr;
+struct _virHostStatsCell {
+    int id;
+    virHostStatsMemory memory; /* only total and free are filled */
+
+    size_t npages;
+    unsigned int *pageSizes;        /* huge page sizes in KiB */
+    unsigned long long *pagesTotal; /* size of the pool */
+    unsigned long long *pagesFree;  /* free pages in the pool */
+};
+
+typedef struct _virHostStats virHostStats;
+typedef virHostStats *virHostStatsPtr;
+struct _virHostStats {
+    virHostStatsCPU cpu;
+
+    size_t ncpus;
+    virHostStatsCPUPtr cpus;
+
+    virHostStatsMemory memory;
+
+    size_t ncells;
+    virHostStatsCellPtr cells;
+};
+
+void virHostStatsFree(virHostStatsPtr stats);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(virHostStats, virHostStatsFree);
+
+int virHostStatsParseCPU(FILE *procstat,
+                         unsigned long long tick_nsec,
+                         virHostStatsPtr stats);
+
+int virHostStatsParseMemory(FILE *meminfo,
+                            virHostStatsMemoryPtr memory);
+
+virHostStatsPtr virHostStatsNew(void);
+
+int virHostStatsFormatParams(virHostStatsPtr stats,
+                             virTypedParameterPtr *params,
+                             int *nparams);
@@ -0,0 +1,210 @@
+/*
+ * virkvmstats.c: statistics exported by KVM through debugfs
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <dirent.h>
+
+#include "virkvmstats.h"
+#define LIBVIRT_VIRKVMSTATSPRIV_H_ALLOW
+#include "virkvmstatspriv.h"
+#include "viralloc.h"
+#include "virerror.h"
+#include "virfile.h"
+#include "virlog.h"
+#include "virstring.h"
+
+#define VIR_FROM_THIS VIR_FROM_NONE
+
+VIR_LOG_INIT("util.kvmstats");
+
+#define KVM_DEBUGFS_PATH "/sys/kernel/debug/kvm"
+
+struct _virKVMStats {
+    char *debugfs;      /* debugfs directory of the VM */
+
+    size_t nvmstats;
+    char **vmstats;     /* statistics found in @debugfs */
+};
+
+
+void
+virKVMStatsFree(virKVMStatsPtr stats)
+{
+    size_t i;
+
+    if (!stats)
+        return;
+
+    for (i = 0; i < stats->nvmstats; i++)
+        g_free(stats->vmstats[i]);
+
+    g_free(stats->vmstats);
+    g_free(stats->debugfs);
+    g_free(stats);
+}
+
+
+/**
+ * virKVMStatsNewDebugfs:
+ * @debugfs: debugfs directory of a VM
+ *
+ * Lists the statistics in @debugfs. The per vcpu subdirectories are
+ * skipped. Nothing is read yet.
+ *
+ * Returns the new object or NULL on error (with error reported).
+ */
+virKVMStatsPtr
+virKVMStatsNewDebugfs(const char *debugfs)
+{
+    g_autoptr(virKVMStats) stats = g_new0(virKVMStats, 1);
+    g_autoptr(DIR) dir = NULL;
+    struct dirent *ent;
+    int rc;
+
+    stats->debugfs = g_strdup(debugfs);
+
+    if (virDirOpen(&dir, stats->debugfs) < 0)
+        return NULL;
+
+    while ((rc = virDirRead(dir, &ent, stats->debugfs)) > 0) {
+        char *name;
+
+        if (ent->d_type != DT_REG)
+            continue;
+
+        name = g_strdup(ent->d_name);
+        ignore_value(VIR_APPEND_ELEMENT(stats->vmstats, stats->nvmstats, name));
+    }
+
+    if (rc < 0)
+        return NULL;
+
+    if (stats->nvmstats == 0) {
+        virReportError(VIR_ERR_OPERATION_UNSUPPORTED,
+                       _("no KVM statistics found in '%s'"), debugfs);
+        return NULL;
+    }
+
+    return g_steal_pointer(&stats);
+}
+
+
+/**
+ * virKVMStatsNew:
+ * @pid: process id of QEMU
+ *
+ * Looks up the KVM VM created by @pid and the statistics debugfs
+ * exports for it. These are the vcpu statistics summed up over all
+ * vcpus of the VM plus the statistics of the VM itself. Nothing is read
+ * yet.
+ *
+ * Returns the new object or NULL on error (with error reported).
+ */
+virKVMStatsPtr
+virKVMStatsNew(pid_t pid)
+{
+    g_autofree char *fddir = g_strdup_printf("/proc/%lld/fd", (long long)pid);
+    g_autofree char *debugfs = NULL;
+    g_autoptr(DIR) dir = NULL;
+    struct dirent *ent;
+    int vmfd = -1;
+    int rc;
+
+    if (virDirOpen(&dir, fddir) < 0)
+        return NULL;
+
+    /* The directory is named after the VM descriptor within QEMU */
+    while ((rc = virDirRead(dir, &ent, fddir)) > 0) {
+        g_autofree char *path = g_strdup_printf("%s/%s", fddir, ent->d_name);
+        g_autofree char *target = NULL;
+
+        if (!(target = g_file_read_link(path, NULL)) ||
+            STRNEQ(target, "anon_inode:kvm-vm") ||
+            virStrToLong_i(ent->d_name, NULL, 10, &vmfd) < 0)
+            continue;
+
+        break;
+    }
+
+    if (rc < 0)
+        return NULL;
+
+    if (vmfd < 0) {
+        virReportError(VIR_ERR_OPERATION_UNSUPPORTED,
+                       _("no KVM VM found for process %lld"),
+                       (long long)pid);
+        return NULL;
+    }
+
+    debugfs = g_strdup_printf(KVM_DEBUGFS_PATH "/%lld-%d", (long long)pid, vmfd);
+
+    if (!virFileIsDir(debugfs)) {
+        virReportError(VIR_ERR_OPERATION_UNSUPPORTED,
+                       _("no KVM statistics found for process %lld"),
+                       (long long)pid);
+        return NULL;
+    }
+
+    return virKVMStatsNewDebugfs(debugfs);
+}
+
+
+/**
+ * virKVMStatsReadVM:
+ * @stats: KVM statistics of a VM
+ * @values: filled with an array of the statistics
+ * @nvalues: filled with the size of @values
+ *
+ * Reads the statistics of the whole VM from debugfs. These include the
+ * vcpu statistics summed up over all vcpus. Files that don't hold a
+ * single counter are skipped. The names in @values are owned by @stats.
+ *
+ * Returns 0 on success, -1 on error (with error reported).
+ */
+int
+virKVMStatsReadVM(virKVMStatsPtr stats,
+                  virKVMStatsValuePtr *values,
+                  size_t *nvalues)
+{
+    size_t i;
+
+    *values = g_new0(virKVMStatsValue, stats->nvmstats);
+    *nvalues = 0;
+
+    for (i = 0; i < stats->nvmstats; i++) {
+        g_autofree char *path = NULL;
+        g_autofree char *buf = NULL;
+        virKVMStatsValuePtr value = *values + *nvalues;
+
+        path = g_strdup_printf("%s/%s", stats->debugfs, stats->vmstats[i]);
+
+        if (virFileReadAllQuiet(path, VIR_INT64_STR_BUFLEN, &buf) < 0)
+            continue;
+
+        virStringTrimOptionalNewline(buf);
+
+        if (virStrToLong_ullp(buf, NULL, 10, &value->value) < 0)
+            continue;
+
+        value->name = stats->vmstats[i];
+        (*nvalues)++;
+    }
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * virkvmstats.h: statistics exported by KVM through debugfs
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "internal.h"
+
+typedef struct _virKVMStats virKVMStats;
+typedef virKVMStats *virKVMStatsPtr;
+
+typedef struct _virKVMStatsValue virKVMStatsValue;
+typedef virKVMStatsValue *virKVMStatsValuePtr;
+struct _virKVMStatsValue {
+    const char *name; /* owned by virKVMStats */
+    unsigned long long value;
+};
+
+virKVMStatsPtr
+virKVMStatsNew(pid_t pid);
+
+void
+virKVMStatsFree(virKVMStatsPtr stats);
+
+int
+virKVMStatsReadVM(virKVMStatsPtr stats,
+                  virKVMStatsValuePtr *values,
+                  size_t *nvalues);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(virKVMStats, virKVMStatsFree);
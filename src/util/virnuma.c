@@ -26,6 +26,7 @@
 #if WITH_NUMACTL
 # define NUMA_VERSION1_COMPATIBILITY 1
 # include <numa.h>
+# include <numaif.h>
 
 # if LIBNUMA_API_VERSION > 1
 #  undef NUMA_MAX_N_CPUS
@@ -339,6 +340,47 @@ virNumaNodesetToCPUset(virBitmapPtr nodeset,
     return 0;
 }
 
+
+/**
+ * virNumaBindMemory:
+ * @addr: start of a mapping
+ * @len: length of the mapping
+ * @node: NUMA node id
+ *
+ * Binds pages of the mapping not faulted in yet to @node.
+ *
+ * Returns 0 on success, -1 otherwise (with error reported).
+ */
+int
+virNumaBindMemory(void *addr,
+                  size_t len,
+                  int node)
+{
+    const size_t bits = sizeof(unsigned long) * CHAR_BIT;
+    size_t nmask;
+    g_autofree unsigned long *mask = NULL;
+
+    if (numa_available() < 0 || node < 0 || node > numa_max_node()) {
+        virReportError(VIR_ERR_OPERATION_FAILED,
+                       _("NUMA node %d is not available"), node);
+        return -1;
+    }
+
+    /* Unlike numa_tonode_memory(), mbind() tells us when it failed. The
+     * kernel ignores the last bit of @maxnode, leave room for it. */
+    nmask = (node + 1) / bits + 1;
+    mask = g_new0(unsigned long, nmask);
+    mask[node / bits] |= 1UL << (node % bits);
+
+    if (mbind(addr, len, MPOL_BIND, mask, nmask * bits, 0) < 0) {
+        virReportSystemError(errno,
+                             _("Unable to bind memory to NUMA node %d"), node);
+        return -1;
+    }
+
+    return 0;
+}
+
 #else /* !WITH_NUMACTL */
 
 int
@@ -405,6 +447,16 @@ virNumaNodesetToCPUset(virBitmapPtr nodeset G_GNUC_UNUSED,
     return -1;
 }
 
+int
+virNumaBindMemory(void *addr G_GNUC_UNUSED,
+                  size_t len G_GNUC_UNUSED,
+                  int node G_GNUC_UNUSED)
+{
+    virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                   _("NUMA isn't available on this host"));
+    return -1;
+}
+
 #endif /* !WITH_NUMACTL */
 
 /**
@@ -711,21 +763,45 @@ virNumaGetPageInfo(int node,
 }
 
 
+static void
+virNumaSortPages(unsigned int *pages_size,
+                 unsigned long long *pages_avail,
+                 unsigned long long *pages_free,
+                 size_t npages)
+{
+    size_t i;
+    bool exchange;
+
+    if (npages < 2)
+        return;
+
+    /* Just to produce nice output, sort the arrays by increasing page size */
+    do {
+        exchange = false;
+        for (i = 0; i < npages - 1; i++) {
+            if (pages_size[i] > pages_size[i + 1]) {
+                exchange = true;
+                SWAP(pages_size[i], pages_size[i + 1]);
+                SWAP(pages_avail[i], pages_avail[i + 1]);
+                SWAP(pages_free[i], pages_free[i + 1]);
+            }
+        }
+    } while (exchange);
+}
+
+
 /**
- * virNumaGetPages:
+ * virNumaGetHugePages:
  * @node: NUMA node id
- * @pages_size: list of pages supported on @node
+ * @pages_size: list of huge pages supported on @node
  * @pages_avail: list of the pool sizes on @node
  * @pages_free: list of free pages on @node
  * @npages: the lists size
  *
- * For given NUMA node fetch info on pages. The size of pages
- * (e.g.  4K, 2M, 1G) is stored into @pages_size, the size of the
- * pool is then stored into @pages_avail and the number of free
- * pages in the pool is stored into @pages_free.
- *
- * If you're interested only in some lists, pass NULL to the
- * other ones.
+ * Like virNumaGetPages(), but only huge pages are reported. Unlike
+ * the ordinary system pages, whose counts have to be derived from
+ * meminfo, all the information is read from the hugepages
+ * directory of @node. All three lists are mandatory.
  *
  * As a special case, if @node == -1, overall info is fetched
  * from the system.
@@ -733,34 +809,21 @@ virNumaGetPageInfo(int node,
  * Returns 0 on success, -1 otherwise.
  */
 int
-virNumaGetPages(int node,
-                unsigned int **pages_size,
-                unsigned long long **pages_avail,
-                unsigned long long **pages_free,
-                size_t *npages)
+virNumaGetHugePages(int node,
+                    unsigned int **pages_size,
+                    unsigned long long **pages_avail,
+                    unsigned long long **pages_free,
+                    size_t *npages)
 {
     g_autoptr(DIR) dir = NULL;
     int direrr = 0;
     struct dirent *entry;
-    unsigned int ntmp = 0;
-    size_t i;
-    bool exchange;
-    long system_page_size;
-    unsigned long long huge_page_sum = 0;
+    size_t ntmp = 0;
     g_autofree char *path = NULL;
     g_autofree unsigned int *tmp_size = NULL;
     g_autofree unsigned long long *tmp_avail = NULL;
     g_autofree unsigned long long *tmp_free = NULL;
 
-    /* sysconf() returns page size in bytes,
-     * but we are storing the page size in kibibytes. */
-    system_page_size = virGetSystemPageSizeKB();
-
-    /* Query huge pages at first.
-     * On Linux systems, the huge pages pool cuts off the available memory and
-     * is always shown as used memory. Here, however, we want to report
-     * slightly different information. So we take the total memory on a node
-     * and subtract memory taken by the huge pages. */
     if (virNumaGetHugePageInfoDir(&path, node) < 0)
         return -1;
 
@@ -804,15 +867,74 @@ virNumaGetPages(int node,
         tmp_avail[ntmp] = page_avail;
         tmp_free[ntmp] = page_free;
         ntmp++;
-
-        /* page_size is in kibibytes while we want huge_page_sum
-         * in just bytes. */
-        huge_page_sum += 1024 * page_size * page_avail;
     }
 
     if (direrr < 0)
         return -1;
 
+    virNumaSortPages(tmp_size, tmp_avail, tmp_free, ntmp);
+
+    *pages_size = g_steal_pointer(&tmp_size);
+    *pages_avail = g_steal_pointer(&tmp_avail);
+    *pages_free = g_steal_pointer(&tmp_free);
+    *npages = ntmp;
+    return 0;
+}
+
+
+/**
+ * virNumaGetPages:
+ * @node: NUMA node id
+ * @pages_size: list of pages supported on @node
+ * @pages_avail: list of the pool sizes on @node
+ * @pages_free: list of free pages on @node
+ * @npages: the lists size
+ *
+ * For given NUMA node fetch info on pages. The size of pages
+ * (e.g.  4K, 2M, 1G) is stored into @pages_size, the size of the
+ * pool is then stored into @pages_avail and the number of free
+ * pages in the pool is stored into @pages_free.
+ *
+ * If you're interested only in some lists, pass NULL to the
+ * other ones.
+ *
+ * As a special case, if @node == -1, overall info is fetched
+ * from the system.
+ *
+ * Returns 0 on success, -1 otherwise.
+ */
+int
+virNumaGetPages(int node,
+                unsigned int **pages_size,
+                unsigned long long **pages_avail,
+                unsigned long long **pages_free,
+                size_t *npages)
+{
+    size_t ntmp = 0;
+    size_t i;
+    long system_page_size;
+    unsigned long long huge_page_sum = 0;
+    g_autofree unsigned int *tmp_size = NULL;
+    g_autofree unsigned long long *tmp_avail = NULL;
+    g_autofree unsigned long long *tmp_free = NULL;
+
+    /* sysconf() returns page size in bytes,
+     * but we are storing the page size in kibibytes. */
+    system_page_size = virGetSystemPageSizeKB();
+
+    /* Query huge pages at first.
+     * On Linux systems, the huge pages pool cuts off the available memory and
+     * is always shown as used memory. Here, however, we want to report
+     * slightly different information. So we take the total memory on a node
+     * and subtract memory taken by the huge pages. */
+    if (virNumaGetHugePages(node, &tmp_size, &tmp_avail, &tmp_free, &ntmp) < 0)
+        return -1;
+
+    /* page_size is in kibibytes while we want huge_page_sum
+     * in just bytes. */
+    for (i = 0; i < ntmp; i++)
+        huge_page_sum += 1024 * tmp_size[i] * tmp_avail[i];
+
     /* Now append the ordinary system pages */
     if (VIR_REALLOC_N(tmp_size, ntmp + 1) < 0 ||
         VIR_REALLOC_N(tmp_avail, ntmp + 1) < 0 ||
@@ -825,31 +947,14 @@ virNumaGetPages(int node,
     tmp_size[ntmp] = system_page_size;
     ntmp++;
 
-    /* Just to produce nice output, sort the arrays by increasing page size */
-    do {
-        exchange = false;
-        for (i = 0; i < ntmp -1; i++) {
-            if (tmp_size[i] > tmp_size[i + 1]) {
-                exchange = true;
-                SWAP(tmp_size[i], tmp_size[i + 1]);
-                SWAP(tmp_avail[i], tmp_avail[i + 1]);
-                SWAP(tmp_free[i], tmp_free[i + 1]);
-            }
-        }
-    } while (exchange);
+    virNumaSortPages(tmp_size, tmp_avail, tmp_free, ntmp);
 
-    if (pages_size) {
-        *pages_size = tmp_size;
-        tmp_size = NULL;
-    }
-    if (pages_avail) {
-        *pages_avail = tmp_avail;
-        tmp_avail = NULL;
-    }
-    if (pages_free) {
-        *pages_free = tmp_free;
-        tmp_free = NULL;
-    }
+    if (pages_size)
+        *pages_size = g_steal_pointer(&tmp_size);
+    if (pages_avail)
+        *pages_avail = g_steal_pointer(&tmp_avail);
+    if (pages_free)
+        *pages_free = g_steal_pointer(&tmp_free);
     *npages = ntmp;
     return 0;
 }
@@ -958,6 +1063,19 @@ virNumaGetPageInfo(int node G_GNUC_UNUSED,
 }
 
 
+int
+virNumaGetHugePages(int node G_GNUC_UNUSED,
+                    unsigned int **pages_size G_GNUC_UNUSED,
+                    unsigned long long **pages_avail G_GNUC_UNUSED,
+                    unsigned long long **pages_free G_GNUC_UNUSED,
+                    size_t *npages G_GNUC_UNUSED)
+{
+    virReportError(VIR_ERR_OPERATION_UNSUPPORTED, "%s",
+                   _("page info is not supported on this platform"));
+    return -1;
+}
+
+
 int
 virNumaGetPages(int node G_GNUC_UNUSED,
                 unsigned int **pages_size G_GNUC_UNUSED,
@@ -1032,3 +1150,140 @@ virNumaGetHostMemoryNodeset(void)
 
     return nodeset;
 }
+
+
+/**
+ * virNumaGetProcessNodeMemory:
+ * @pid: process to inspect
+ * @memory: filled with amount of memory in bytes, indexed by node
+ * @nmemory: filled with the number of items in @memory
+ *
+ * Sum up how much memory of process @pid resides on each host NUMA
+ * node, as reported in /proc/@pid/numa_maps.
+ *
+ * Returns 0 on success, -1 on error with error reported.
+ */
+int
+virNumaGetProcessNodeMemory(pid_t pid,
+                            unsigned long long **memory,
+                            size_t *nmemory)
+{
+    g_autofree char *path = NULL;
+    g_autofree char *line = NULL;
+    g_autofree unsigned long long *mem = NULL;
+    size_t nmem = 0;
+    size_t linelen = 0;
+    FILE *fp;
+
+    path = g_strdup_printf("/proc/%lld/numa_maps", (long long) pid);
+
+    if (!(fp = fopen(path, "r"))) {
+        virReportSystemError(errno, _("Unable to open '%s'"), path);
+        return -1;
+    }
+
+    while (getline(&line, &linelen, fp) > 0) {
+        g_auto(GStrv) tokens = g_strsplit(g_strchomp(line), " ", 0);
+        unsigned long long pagesize = virGetSystemPageSizeKB();
+        GStrv tok;
+
+        for (tok = tokens; *tok; tok++) {
+            const char *val;
+
+            if ((val = STRSKIP(*tok, "kernelpagesize_kB=")))
+                ignore_value(virStrToLong_ull(val, NULL, 10, &pagesize));
+        }
+
+        /* Per node page counts look like "N<node>=<pages>" */
+        for (tok = tokens; *tok; tok++) {
+            unsigned long long pages;
+            unsigned int node;
+            char *end;
+
+            if ((*tok)[0] != 'N' || !g_ascii_isdigit((*tok)[1]))
+                continue;
+
+            if (virStrToLong_ui(*tok + 1, &end, 10, &node) < 0 ||
+                *end != '=' ||
+                virStrToLong_ull(end + 1, NULL, 10, &pages) < 0)
+                continue;
+
+            if (node >= nmem)
+                ignore_value(VIR_EXPAND_N(mem, nmem, node + 1 - nmem));
+
+            mem[node] += pages * pagesize * 1024;
+        }
+    }
+
+    VIR_FORCE_FCLOSE(fp);
+
+    *memory = g_steal_pointer(&mem);
+    *nmemory = nmem;
+    return 0;
+}
+
+
+#if WITH_NUMACTL && LIBNUMA_API_VERSION > 1
+/**
+ * virNumaMigratePages:
+ * @pid: process whose memory to move
+ * @from: nodes to move the memory from
+ * @to: nodes to move the memory to
+ *
+ * Move the pages of process @pid which reside on nodes in @from
+ * to nodes in @to.
+ *
+ * Returns the number of pages that could not be moved on success,
+ * -1 on error with error reported.
+ */
+int
+virNumaMigratePages(pid_t pid,
+                    virBitmapPtr from,
+                    virBitmapPtr to)
+{
+    struct bitmask *fromMask = numa_allocate_nodemask();
+    struct bitmask *toMask = numa_allocate_nodemask();
+    ssize_t bit = -1;
+    int ret = -1;
+
+    while ((bit = virBitmapNextSetBit(from, bit)) >= 0) {
+        if (bit >= fromMask->size)
+            goto range;
+        numa_bitmask_setbit(fromMask, bit);
+    }
+
+    while ((bit = virBitmapNextSetBit(to, bit)) >= 0) {
+        if (bit >= toMask->size)
+            goto range;
+        numa_bitmask_setbit(toMask, bit);
+    }
+
+    if ((ret = numa_migrate_pages(pid, fromMask, toMask)) < 0)
+        virReportSystemError(errno,
+                             _("Unable to move memory of process %lld"),
+                             (long long) pid);
+    goto cleanup;
+
+ range:
+    virReportError(VIR_ERR_INTERNAL_ERROR,
+                   _("NUMA node %zd is out of range"), bit);
+
+ cleanup:
+    numa_bitmask_free(fromMask);
+    numa_bitmask_free(toMask);
+    return ret;
+}
+
+#else /* !(WITH_NUMACTL && LIBNUMA_API_VERSION > 1) */
+
+int
+virNumaMigratePages(pid_t pid G_GNUC_UNUSED,
+                    virBitmapPtr from G_GNUC_UNUSED,
+                    virBitmapPtr to G_GNUC_UNUSED)
+{
+    virReportError(VIR_ERR_OPERATION_UNSUPPORTED, "%s",
+                   _("moving memory between NUMA nodes is not supported "
+                     "on this host"));
+    return -1;
+}
+#endif /* !(WITH_NUMACTL && LIBNUMA_API_VERSION > 1) */
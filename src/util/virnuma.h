@@ -54,6 +54,13 @@ int virNumaGetPageInfo(int node,
                        unsigned long long huge_page_sum,
                        unsigned long long *page_avail,
                        unsigned long long *page_free);
+int virNumaGetHugePages(int node,
+                        unsigned int **pages_size,
+                        unsigned long long **pages_avail,
+                        unsigned long long **pages_free,
+                        size_t *npages)
+    ATTRIBUTE_NONNULL(2) ATTRIBUTE_NONNULL(3)
+    ATTRIBUTE_NONNULL(4) ATTRIBUTE_NONNULL(5);
 int virNumaGetPages(int node,
                     unsigned int **pages_size,
                     unsigned long long **pages_avail,
@@ -64,3 +71,13 @@ int virNumaSetPagePoolSize(int node,
                            unsigned int page_size,
                            unsigned long long page_count,
                            bool add);
+
+int virNumaGetProcessNodeMemory(pid_t pid,
+                                unsigned long long **memory,
+                                size_t *nmemory);
+int virNumaBindMemory(void *addr,
+                      size_t len,
+                      int node);
+int virNumaMigratePages(pid_t pid,
+                        virBitmapPtr from,
+                        virBitmapPtr to);
@@ -26,6 +26,8 @@
 #endif
 
 #include "virperf.h"
+#define LIBVIRT_VIRPERFPRIV_H_ALLOW
+#include "virperfpriv.h"
 #include "virerror.h"
 #include "virlog.h"
 #include "virfile.h"
@@ -63,10 +65,239 @@ struct virPerfEvent {
 };
 typedef struct virPerfEvent *virPerfEventPtr;
 
+/* The hardware counters of a vCPU thread are split into groups of at most
+ * this many events. A group is only ever scheduled onto the PMU as a
+ * whole, so it must not need more counters than the CPU has. Most CPUs
+ * have at least four general purpose counters per hardware thread. */
+#define VIR_PERF_VCPU_GROUP_HW_MAX 4
+
+/* A group of counters opened on a single vCPU thread. All the values of
+ * a group are read with one syscall. */
+struct virPerfVcpuGroup {
+    size_t nfds;
+    int fds[VIR_PERF_EVENT_LAST];   /* group leader comes first */
+    virPerfEventType types[VIR_PERF_EVENT_LAST];
+};
+typedef struct virPerfVcpuGroup *virPerfVcpuGroupPtr;
+
+struct virPerfVcpu {
+    pid_t tid;                  /* 0 if the counters aren't opened */
+    unsigned long long mask;    /* bitmap of virPerfEventType requested */
+    size_t ngroups;
+    struct virPerfVcpuGroup groups[VIR_PERF_EVENT_LAST];
+    bool hasSample;
+    virPerfVcpuSample last;
+};
+typedef struct virPerfVcpu *virPerfVcpuPtr;
+
+G_STATIC_ASSERT(VIR_PERF_EVENT_LAST <= 64);
+
 struct _virPerf {
     struct virPerfEvent events[VIR_PERF_EVENT_LAST];
+
+    struct virPerfVcpu *vcpus;
+    size_t nvcpus;
 };
 
+
+static void
+virPerfVcpuGroupClose(virPerfVcpuGroupPtr group)
+{
+    size_t i;
+
+    /* Members first, the leader goes last */
+    for (i = group->nfds; i > 0; i--)
+        VIR_FORCE_CLOSE(group->fds[i - 1]);
+
+    group->nfds = 0;
+}
+
+
+static void
+virPerfVcpuClose(virPerfVcpuPtr vcpu)
+{
+    size_t i;
+
+    for (i = 0; i < vcpu->ngroups; i++)
+        virPerfVcpuGroupClose(&vcpu->groups[i]);
+
+    vcpu->ngroups = 0;
+    vcpu->mask = 0;
+    vcpu->tid = 0;
+    vcpu->hasSample = false;
+}
+
+
+static bool
+virPerfEventIsHardware(virPerfEventType type)
+{
+    return type >= VIR_PERF_EVENT_CPU_CYCLES &&
+           type <= VIR_PERF_EVENT_REF_CPU_CYCLES;
+}
+
+
+/**
+ * virPerfVcpuGroupsSplit:
+ * @mask: bitmap of virPerfEventType to count on a vCPU thread
+ * @groups: filled with the bitmaps of the groups, VIR_PERF_EVENT_LAST long
+ *
+ * Splits the events of @mask into groups that can be counted at once.
+ * The hardware events are put into groups of at most
+ * VIR_PERF_VCPU_GROUP_HW_MAX events in the order of virPerfEventType, so
+ * that the pairs the rates are computed from, cpu_cycles with
+ * instructions and cache_references with cache_misses, always end up in
+ * the same group. The software events don't occupy a PMU counter and
+ * form one group of their own.
+ *
+ * Returns the number of groups.
+ */
+size_t
+virPerfVcpuGroupsSplit(unsigned long long mask,
+                       unsigned long long *groups)
+{
+    unsigned long long software = 0;
+    size_t ngroups = 0;
+    size_t nhardware = 0;
+    size_t i;
+
+    for (i = 0; i < VIR_PERF_EVENT_LAST; i++) {
+        if (!(mask & (1ULL << i)))
+            continue;
+
+        if (!virPerfEventIsHardware(i)) {
+            software |= 1ULL << i;
+            continue;
+        }
+
+        if (nhardware++ % VIR_PERF_VCPU_GROUP_HW_MAX == 0)
+            groups[ngroups++] = 0;
+
+        groups[ngroups - 1] |= 1ULL << i;
+    }
+
+    if (software)
+        groups[ngroups++] = software;
+
+    return ngroups;
+}
+
+
+/**
+ * virPerfVcpuGroupParse:
+ * @buf: data read from the leader of a group
+ * @nbuf: number of items in @buf
+ * @types: events of the group in the order they were opened
+ * @ntypes: number of items in @types
+ * @sample: sample to store the values to
+ * @enabled: filled with the time the group was enabled
+ * @running: filled with the time the group was counting
+ *
+ * Parses the PERF_FORMAT_GROUP data of one group, that is
+ * { nr, time_enabled, time_running, values[nr] }, into @sample. If the
+ * group was not on the PMU for the whole time it was enabled, the
+ * values are scaled up the way 'perf stat' does.
+ *
+ * Returns 0 on success, -1 if @buf doesn't match @types.
+ */
+int
+virPerfVcpuGroupParse(const uint64_t *buf,
+                      size_t nbuf,
+                      const virPerfEventType *types,
+                      size_t ntypes,
+                      virPerfVcpuSamplePtr sample,
+                      unsigned long long *enabled,
+                      unsigned long long *running)
+{
+    size_t i;
+
+    if (nbuf < 3 || buf[0] != ntypes || nbuf < 3 + ntypes) {
+        virReportError(VIR_ERR_INTERNAL_ERROR,
+                       _("unexpected number of perf events in group, expected %zu"),
+                       ntypes);
+        return -1;
+    }
+
+    *enabled = buf[1];
+    *running = buf[2];
+
+    for (i = 0; i < ntypes; i++) {
+        uint64_t value = buf[3 + i];
+
+        if (*running == 0)
+            value = 0;
+        else if (*running < *enabled)
+            value = (double)value * *enabled / *running;
+
+        sample->present[types[i]] = true;
+        sample->values[types[i]] = value;
+    }
+
+    return 0;
+}
+
+
+/* Difference of an event between two samples. Scaled estimates may go
+ * backwards, there is no meaningful difference then. */
+static bool
+virPerfVcpuDelta(const virPerfVcpuSample *cur,
+                 const virPerfVcpuSample *prev,
+                 virPerfEventType type,
+                 uint64_t *delta)
+{
+    if (!cur->present[type] || !prev->present[type] ||
+        cur->values[type] < prev->values[type])
+        return false;
+
+    *delta = cur->values[type] - prev->values[type];
+    return true;
+}
+
+
+/**
+ * virPerfVcpuComputeRates:
+ * @cur: current sample
+ * @prev: previous sample of the same vCPU
+ * @rates: filled with the rates
+ *
+ * Computes the rates derived from the events counted between @prev and
+ * @cur. A rate is only set if all the events it needs were counted in
+ * both samples and its divisor is not zero.
+ */
+void
+virPerfVcpuComputeRates(const virPerfVcpuSample *cur,
+                        const virPerfVcpuSample *prev,
+                        virPerfVcpuRatesPtr rates)
+{
+    uint64_t cycles;
+    uint64_t insns;
+    uint64_t misses;
+    uint64_t refs;
+
+    memset(rates, 0, sizeof(*rates));
+
+    if (virPerfVcpuDelta(cur, prev, VIR_PERF_EVENT_CPU_CYCLES, &cycles) &&
+        virPerfVcpuDelta(cur, prev, VIR_PERF_EVENT_INSTRUCTIONS, &insns) &&
+        cycles > 0) {
+        rates->ipc = (double)insns / cycles;
+        rates->hasIpc = true;
+    }
+
+    if (!virPerfVcpuDelta(cur, prev, VIR_PERF_EVENT_CACHE_MISSES, &misses))
+        return;
+
+    if (cur->timestamp > prev->timestamp) {
+        rates->cacheMissesRate = misses * 1000000.0 /
+                                 (cur->timestamp - prev->timestamp);
+        rates->hasCacheMissesRate = true;
+    }
+
+    if (virPerfVcpuDelta(cur, prev, VIR_PERF_EVENT_CACHE_REFERENCES, &refs) &&
+        refs > 0) {
+        rates->cacheMissRatio = (double)misses / refs;
+        rates->hasCacheMissRatio = true;
+    }
+}
+
 #if defined(__linux__) && defined(WITH_SYS_SYSCALL_H)
 
 # include <linux/perf_event.h>
@@ -316,6 +547,205 @@ virPerfReadEvent(virPerfPtr perf,
     return 0;
 }
 
+
+/* The RDT events are counted by a separate PMU and cannot be put into
+ * one group with the core events. They are reported per domain only. */
+static unsigned long long
+virPerfVcpuGroupMask(virPerfPtr perf)
+{
+    unsigned long long mask = 0;
+    size_t i;
+
+    for (i = 0; i < VIR_PERF_EVENT_LAST; i++) {
+        if (i == VIR_PERF_EVENT_CMT ||
+            i == VIR_PERF_EVENT_MBMT ||
+            i == VIR_PERF_EVENT_MBML)
+            continue;
+
+        if (perf->events[i].enabled)
+            mask |= 1ULL << i;
+    }
+
+    return mask;
+}
+
+
+static int
+virPerfVcpuGroupOpen(virPerfVcpuGroupPtr group,
+                     unsigned long long mask,
+                     pid_t tid)
+{
+    size_t i;
+
+    for (i = 0; i < VIR_PERF_EVENT_LAST; i++) {
+        struct perf_event_attr attr;
+        int leader = group->nfds ? group->fds[0] : -1;
+        int fd;
+
+        if (!(mask & (1ULL << i)))
+            continue;
+
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = attrs[i].attrType;
+        attr.config = attrs[i].attrConfig;
+        attr.read_format = PERF_FORMAT_GROUP |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        /* Only the leader is disabled, enabling it starts the whole group */
+        attr.disabled = leader < 0;
+
+        fd = syscall(__NR_perf_event_open, &attr, tid, -1, leader, 0);
+        if (fd < 0) {
+            virReportSystemError(errno,
+                                 _("unable to open perf event for %s of thread %lld"),
+                                 virPerfEventTypeToString(i), (long long)tid);
+            goto error;
+        }
+
+        group->types[group->nfds] = i;
+        group->fds[group->nfds++] = fd;
+    }
+
+    if (ioctl(group->fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+        virReportSystemError(errno,
+                             _("unable to enable perf events of thread %lld"),
+                             (long long)tid);
+        goto error;
+    }
+
+    return 0;
+
+ error:
+    virPerfVcpuGroupClose(group);
+    return -1;
+}
+
+
+/* Opens the groups of @mask on @tid. A group that fails to open is
+ * dropped with a warning, its events are then missing from the samples.
+ * The outcome is kept until @tid or @mask changes, so that a thread or a
+ * PMU that cannot count some events isn't asked again on every read. */
+static void
+virPerfVcpuOpen(virPerfVcpuPtr vcpu,
+                unsigned long long mask,
+                pid_t tid)
+{
+    unsigned long long groups[VIR_PERF_EVENT_LAST];
+    size_t ngroups = virPerfVcpuGroupsSplit(mask, groups);
+    size_t i;
+
+    for (i = 0; i < ngroups; i++) {
+        virPerfVcpuGroupPtr group = &vcpu->groups[vcpu->ngroups];
+
+        if (virPerfVcpuGroupOpen(group, groups[i], tid) < 0) {
+            VIR_WARN("Dropping perf event group 0x%llx of thread %lld: %s",
+                     groups[i], (long long)tid, virGetLastErrorMessage());
+            virResetLastError();
+            continue;
+        }
+
+        vcpu->ngroups++;
+    }
+
+    vcpu->tid = tid;
+    vcpu->mask = mask;
+}
+
+
+/**
+ * virPerfReadVcpu:
+ * @perf: perf events of the domain
+ * @vcpu: vCPU id
+ * @tid: thread id of @vcpu
+ * @sample: filled with the current values
+ * @prev: filled with the values of the previous call
+ *
+ * Reads all enabled core and software events of the @vcpu thread. The
+ * counters are opened on the first call as a few groups: the hardware
+ * events in groups small enough to fit on the PMU at once and the
+ * software events in one group of their own. Every later call costs one
+ * read() per group. The counters are reopened whenever @tid or the set
+ * of enabled events changes. Groups that the kernel had to multiplex
+ * with other groups are scaled by the ratio of enabled and running time.
+ *
+ * Returns 1 if both @sample and @prev are filled, 0 if only @sample is
+ * valid because the counters were just opened or if there is no sample
+ * at all (@sample->timestamp is 0) because none of them can be opened,
+ * -1 on error.
+ */
+int
+virPerfReadVcpu(virPerfPtr perf,
+                unsigned int vcpu,
+                pid_t tid,
+                virPerfVcpuSamplePtr sample,
+                virPerfVcpuSamplePtr prev)
+{
+    unsigned long long mask = virPerfVcpuGroupMask(perf);
+    virPerfVcpuPtr cpu;
+    size_t i;
+
+    memset(sample, 0, sizeof(*sample));
+
+    if (vcpu >= perf->nvcpus &&
+        VIR_EXPAND_N(perf->vcpus, perf->nvcpus, vcpu + 1 - perf->nvcpus) < 0)
+        return -1;
+
+    cpu = &perf->vcpus[vcpu];
+
+    if (cpu->tid != 0 && (cpu->tid != tid || cpu->mask != mask))
+        virPerfVcpuClose(cpu);
+
+    if (mask == 0)
+        return 0;
+
+    if (cpu->tid == 0)
+        virPerfVcpuOpen(cpu, mask, tid);
+
+    if (cpu->ngroups == 0)
+        return 0;
+
+    for (i = 0; i < cpu->ngroups; i++) {
+        virPerfVcpuGroupPtr group = &cpu->groups[i];
+        uint64_t buf[3 + VIR_PERF_EVENT_LAST] = { 0 };
+        unsigned long long enabled;
+        unsigned long long running;
+        ssize_t len;
+
+        /* { nr, time_enabled, time_running, values[nr] } */
+        if ((len = saferead(group->fds[0], buf,
+                            sizeof(uint64_t) * (3 + group->nfds))) < 0) {
+            virReportSystemError(errno,
+                                 _("unable to read perf events of thread %lld"),
+                                 (long long)tid);
+            return -1;
+        }
+
+        if (virPerfVcpuGroupParse(buf, len / sizeof(uint64_t),
+                                  group->types, group->nfds,
+                                  sample, &enabled, &running) < 0)
+            return -1;
+
+        /* Report the worst coverage of all the groups */
+        if (i == 0 || enabled > sample->timeEnabled)
+            sample->timeEnabled = enabled;
+        if (i == 0 || running < sample->timeRunning)
+            sample->timeRunning = running;
+    }
+
+    sample->timestamp = g_get_monotonic_time();
+
+    if (!cpu->hasSample) {
+        cpu->last = *sample;
+        cpu->hasSample = true;
+        return 0;
+    }
+
+    *prev = cpu->last;
+    cpu->last = *sample;
+    return 1;
+}
+
 #else
 static int
 virPerfRdtAttrInit(void)
@@ -360,6 +790,18 @@ virPerfReadEvent(virPerfPtr perf G_GNUC_UNUSED,
     return -1;
 }
 
+int
+virPerfReadVcpu(virPerfPtr perf G_GNUC_UNUSED,
+                unsigned int vcpu G_GNUC_UNUSED,
+                pid_t tid G_GNUC_UNUSED,
+                virPerfVcpuSamplePtr sample G_GNUC_UNUSED,
+                virPerfVcpuSamplePtr prev G_GNUC_UNUSED)
+{
+    virReportSystemError(ENXIO, "%s",
+                         _("Perf not supported on this platform"));
+    return -1;
+}
+
 #endif
 
 virPerfPtr
@@ -394,5 +836,9 @@ virPerfFree(virPerfPtr perf)
             virPerfEventDisable(perf, i);
     }
 
+    for (i = 0; i < perf->nvcpus; i++)
+        virPerfVcpuClose(&perf->vcpus[i]);
+
+    g_free(perf->vcpus);
     VIR_FREE(perf);
 }
@@ -80,4 +80,35 @@ int virPerfReadEvent(virPerfPtr perf,
                      virPerfEventType type,
                      uint64_t *value);
 
+typedef struct _virPerfVcpuSample virPerfVcpuSample;
+typedef virPerfVcpuSample *virPerfVcpuSamplePtr;
+struct _virPerfVcpuSample {
+    unsigned long long timestamp;   /* monotonic time of the read in us */
+    unsigned long long timeEnabled; /* ns the counters were enabled */
+    unsigned long long timeRunning; /* ns the counters were on the PMU */
+    bool present[VIR_PERF_EVENT_LAST];
+    uint64_t values[VIR_PERF_EVENT_LAST];
+};
+
+int virPerfReadVcpu(virPerfPtr perf,
+                    unsigned int vcpu,
+                    pid_t tid,
+                    virPerfVcpuSamplePtr sample,
+                    virPerfVcpuSamplePtr prev);
+
+typedef struct _virPerfVcpuRates virPerfVcpuRates;
+typedef virPerfVcpuRates *virPerfVcpuRatesPtr;
+struct _virPerfVcpuRates {
+    bool hasIpc;
+    double ipc;                 /* instructions per cpu cycle */
+    bool hasCacheMissesRate;
+    double cacheMissesRate;     /* cache misses per second */
+    bool hasCacheMissRatio;
+    double cacheMissRatio;      /* cache misses per cache reference */
+};
+
+void virPerfVcpuComputeRates(const virPerfVcpuSample *cur,
+                             const virPerfVcpuSample *prev,
+                             virPerfVcpuRatesPtr rates);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(virPerf, virPerfFree);
@@ -0,0 +1,37 @@
+/*
+ * virperfpriv.h: helper APIs for managing perf events
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LIBVIRT_VIRPERFPRIV_H_ALLOW
+# error "virperfpriv.h may only be included by virperf.c or test suites"
+#endif /* LIBVIRT_VIRPERFPRIV_H_ALLOW */
+
+#pragma once
+
+#include "virperf.h"
+
+size_t virPerfVcpuGroupsSplit(unsigned long long mask,
+                              unsigned long long *groups);
+
+int virPerfVcpuGroupParse(const uint64_t *buf,
+                          size_t nbuf,
+                          const virPerfEventType *types,
+                          size_t ntypes,
+                          virPerfVcpuSamplePtr sample,
+                          unsigned long long *enabled,
+                          unsigned long long *running);
@@ -1247,6 +1247,37 @@ virResctrlAllocSetCacheSize(virResctrlAllocPtr alloc,
 }
 
 
+/* virResctrlAllocGetCacheSize
+ * @alloc: Pointer to an allocation
+ * @level: Cache level
+ * @type: Cache type
+ * @cache: Cache id
+ * @size: Filled with the size of the allocation in bytes
+ *
+ * Returns true if @alloc allocates a part of the given cache, false
+ * otherwise.
+ */
+bool
+virResctrlAllocGetCacheSize(virResctrlAllocPtr alloc,
+                            unsigned int level,
+                            virCacheType type,
+                            unsigned int cache,
+                            unsigned long long *size)
+{
+    virResctrlAllocPerTypePtr a_type = NULL;
+
+    if (!alloc || level >= alloc->nlevels || !alloc->levels[level])
+        return false;
+
+    a_type = alloc->levels[level]->types[type];
+    if (!a_type || cache >= a_type->nsizes || !a_type->sizes[cache])
+        return false;
+
+    *size = *(a_type->sizes[cache]);
+    return true;
+}
+
+
 int
 virResctrlAllocForeachCache(virResctrlAllocPtr alloc,
                             virResctrlAllocForeachCacheCallback cb,
@@ -1334,6 +1365,32 @@ virResctrlAllocSetMemoryBandwidth(virResctrlAllocPtr alloc,
 }
 
 
+/* virResctrlAllocGetMemoryBandwidth
+ * @alloc: Pointer to an allocation
+ * @id: Memory bandwidth controller (node) id
+ * @memory_bandwidth: Filled with the allocated bandwidth in percent
+ *
+ * Returns true if @alloc limits the bandwidth of the given node, false
+ * otherwise.
+ */
+bool
+virResctrlAllocGetMemoryBandwidth(virResctrlAllocPtr alloc,
+                                  unsigned int id,
+                                  unsigned int *memory_bandwidth)
+{
+    virResctrlAllocMemBWPtr mem_bw = NULL;
+
+    if (!alloc || !(mem_bw = alloc->mem_bw))
+        return false;
+
+    if (id >= mem_bw->nbandwidths || !mem_bw->bandwidths[id])
+        return false;
+
+    *memory_bandwidth = *(mem_bw->bandwidths[id]);
+    return true;
+}
+
+
 /* virResctrlAllocForeachMemory
  * @alloc: Pointer to an active allocation
  * @cb: Callback function
@@ -2348,6 +2405,30 @@ virResctrlCreateGroupPath(const char *path)
 }
 
 
+static int
+virResctrlAllocWriteSchemata(virResctrlAllocPtr alloc)
+{
+    g_autofree char *schemata_path = NULL;
+    g_autofree char *alloc_str = NULL;
+
+    alloc_str = virResctrlAllocFormat(alloc);
+    if (!alloc_str)
+        return -1;
+
+    schemata_path = g_strdup_printf("%s/schemata", alloc->path);
+
+    VIR_DEBUG("Writing resctrl schemata '%s' into '%s'", alloc_str, schemata_path);
+    if (virFileWriteStr(schemata_path, alloc_str, 0) < 0) {
+        virReportSystemError(errno,
+                             _("Cannot write into schemata file '%s'"),
+                             schemata_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+
 /* This checks if the directory for the alloc exists.  If not it tries to create
  * it and apply appropriate alloc settings. */
 int
@@ -2355,8 +2436,6 @@ virResctrlAllocCreate(virResctrlInfoPtr resctrl,
                       virResctrlAllocPtr alloc,
                       const char *machinename)
 {
-    char *schemata_path = NULL;
-    char *alloc_str = NULL;
     int ret = -1;
     int lockfd = -1;
 
@@ -2386,26 +2465,14 @@ virResctrlAllocCreate(virResctrlInfoPtr resctrl,
     if (virResctrlCreateGroupPath(alloc->path) < 0)
         goto cleanup;
 
-    alloc_str = virResctrlAllocFormat(alloc);
-    if (!alloc_str)
-        goto cleanup;
-
-    schemata_path = g_strdup_printf("%s/schemata", alloc->path);
-
-    VIR_DEBUG("Writing resctrl schemata '%s' into '%s'", alloc_str, schemata_path);
-    if (virFileWriteStr(schemata_path, alloc_str, 0) < 0) {
+    if (virResctrlAllocWriteSchemata(alloc) < 0) {
         rmdir(alloc->path);
-        virReportSystemError(errno,
-                             _("Cannot write into schemata file '%s'"),
-                             schemata_path);
         goto cleanup;
     }
 
     ret = 0;
  cleanup:
     virResctrlUnlock(lockfd);
-    VIR_FREE(alloc_str);
-    VIR_FREE(schemata_path);
     return ret;
 }
 
@@ -2478,6 +2545,435 @@ virResctrlAllocRemove(virResctrlAllocPtr alloc)
 }
 
 
+/* Resizing allocations of running domains */
+
+static virResctrlInfoPerTypePtr
+virResctrlInfoGetType(virResctrlInfoPtr resctrl,
+                      unsigned int level,
+                      virCacheType type)
+{
+    if (level >= resctrl->nlevels || !resctrl->levels[level] ||
+        !resctrl->levels[level]->types[type]) {
+        virReportError(VIR_ERR_CONFIG_UNSUPPORTED,
+                       _("Cache level %u does not support tuning for "
+                         "scope type '%s'"),
+                       level, virCacheTypeToString(type));
+        return NULL;
+    }
+
+    return resctrl->levels[level]->types[type];
+}
+
+
+static bool
+virResctrlAllocIsCreated(virResctrlAllocPtr alloc)
+{
+    if (!alloc->path || STREQ(alloc->path, SYSFS_RESCTRL_PATH)) {
+        virReportError(VIR_ERR_OPERATION_INVALID, "%s",
+                       _("Resctrl allocation has no group of its own"));
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+ * virResctrlAllocGetUnusedCacheSize
+ * @resctrl: Resctrl information of the host
+ * @level: Cache level
+ * @type: Cache type
+ * @cache: Cache id
+ * @size: Filled with the number of bytes of the cache not allocated to
+ *        any group
+ *
+ * The free bytes don't have to be contiguous, so an allocation growing by
+ * that much is not guaranteed to fit.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virResctrlAllocGetUnusedCacheSize(virResctrlInfoPtr resctrl,
+                                  unsigned int level,
+                                  virCacheType type,
+                                  unsigned int cache,
+                                  unsigned long long *size)
+{
+    g_autoptr(virResctrlAlloc) alloc_free = NULL;
+    virResctrlInfoPerTypePtr i_type = NULL;
+    virResctrlAllocPerTypePtr f_type = NULL;
+    int lockfd = -1;
+
+    *size = 0;
+
+    if (!(i_type = virResctrlInfoGetType(resctrl, level, type)))
+        return -1;
+
+    lockfd = virResctrlLock();
+    if (lockfd < 0)
+        return -1;
+
+    alloc_free = virResctrlAllocGetUnused(resctrl);
+    virResctrlUnlock(lockfd);
+
+    if (!alloc_free)
+        return -1;
+
+    if (level < alloc_free->nlevels && alloc_free->levels[level])
+        f_type = alloc_free->levels[level]->types[type];
+
+    if (f_type && cache < f_type->nmasks && f_type->masks[cache])
+        *size = virBitmapCountBits(f_type->masks[cache]) * i_type->control.granularity;
+
+    return 0;
+}
+
+
+/*
+ * Finds a new mask covering @size bytes for the cache allocation of @alloc
+ * for @level, @type and @cache, which must already exist.  The bits @alloc
+ * holds right now are considered free, so that it can grow or shrink in
+ * place.  Nothing is written to the host.  On failure @alloc is left
+ * untouched.
+ */
+int
+virResctrlAllocResizeCacheMask(virResctrlInfoPtr resctrl,
+                               virResctrlAllocPtr alloc,
+                               unsigned int level,
+                               virCacheType type,
+                               unsigned int cache,
+                               unsigned long long size)
+{
+    g_autoptr(virResctrlAlloc) alloc_free = NULL;
+    virResctrlInfoPerTypePtr i_type = NULL;
+    virResctrlAllocPerTypePtr a_type = NULL;
+    virResctrlAllocPerTypePtr f_type = NULL;
+    virBitmapPtr old_mask = NULL;
+    unsigned long long old_size = 0;
+
+    if (!virResctrlAllocGetCacheSize(alloc, level, type, cache, &old_size)) {
+        virReportError(VIR_ERR_INTERNAL_ERROR,
+                       _("No allocation for cache level '%u' id '%u', "
+                         "type '%s' to resize"),
+                       level, cache, virCacheTypeToString(type));
+        return -1;
+    }
+
+    if (!(i_type = virResctrlInfoGetType(resctrl, level, type)))
+        return -1;
+
+    alloc_free = virResctrlAllocGetUnused(resctrl);
+    if (!alloc_free)
+        return -1;
+
+    if (level < alloc_free->nlevels && alloc_free->levels[level])
+        f_type = alloc_free->levels[level]->types[type];
+
+    if (!f_type) {
+        virReportError(VIR_ERR_CONFIG_UNSUPPORTED,
+                       _("Cache level %u does not support tuning for "
+                         "scope type '%s'"),
+                       level, virCacheTypeToString(type));
+        return -1;
+    }
+
+    a_type = alloc->levels[level]->types[type];
+
+    if (cache < a_type->nmasks && a_type->masks[cache]) {
+        old_mask = g_steal_pointer(&a_type->masks[cache]);
+
+        if (cache < f_type->nmasks && f_type->masks[cache] &&
+            virBitmapUnion(f_type->masks[cache], old_mask) < 0) {
+            a_type->masks[cache] = old_mask;
+            return -1;
+        }
+    }
+
+    *(a_type->sizes[cache]) = size;
+
+    if (virResctrlAllocFindUnused(alloc, i_type, f_type, level, type, cache) < 0) {
+        *(a_type->sizes[cache]) = old_size;
+        if (old_mask) {
+            virBitmapFree(a_type->masks[cache]);
+            a_type->masks[cache] = old_mask;
+        }
+        return -1;
+    }
+
+    virBitmapFree(old_mask);
+    return 0;
+}
+
+
+/*
+ * virResctrlAllocResizeCache
+ * @resctrl: Resctrl information of the host
+ * @alloc: Allocation created by virResctrlAllocCreate()
+ * @level: Cache level
+ * @type: Cache type
+ * @cache: Cache id
+ * @size: New size of the allocation in bytes
+ *
+ * Changes the size of an existing cache allocation of @alloc and applies
+ * it to the host.  On failure neither @alloc nor the host are changed.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virResctrlAllocResizeCache(virResctrlInfoPtr resctrl,
+                           virResctrlAllocPtr alloc,
+                           unsigned int level,
+                           virCacheType type,
+                           unsigned int cache,
+                           unsigned long long size)
+{
+    virResctrlAllocPerTypePtr a_type = NULL;
+    g_autoptr(virBitmap) old_mask = NULL;
+    unsigned long long old_size = 0;
+    int lockfd = -1;
+    int ret = -1;
+
+    if (!virResctrlAllocIsCreated(alloc))
+        return -1;
+
+    lockfd = virResctrlLock();
+    if (lockfd < 0)
+        return -1;
+
+    if (virResctrlAllocGetCacheSize(alloc, level, type, cache, &old_size)) {
+        a_type = alloc->levels[level]->types[type];
+        if (cache < a_type->nmasks && a_type->masks[cache])
+            old_mask = virBitmapNewCopy(a_type->masks[cache]);
+    }
+
+    if (virResctrlAllocResizeCacheMask(resctrl, alloc, level, type, cache, size) < 0)
+        goto cleanup;
+
+    if (virResctrlAllocWriteSchemata(alloc) < 0) {
+        *(a_type->sizes[cache]) = old_size;
+        virBitmapFree(a_type->masks[cache]);
+        a_type->masks[cache] = g_steal_pointer(&old_mask);
+        goto cleanup;
+    }
+
+    ret = 0;
+ cleanup:
+    virResctrlUnlock(lockfd);
+    return ret;
+}
+
+
+/*
+ * virResctrlAllocResizeMemoryBandwidth
+ * @resctrl: Resctrl information of the host
+ * @alloc: Allocation created by virResctrlAllocCreate()
+ * @id: Memory bandwidth controller (node) id
+ * @memory_bandwidth: New bandwidth limit in percent
+ *
+ * Changes an existing memory bandwidth allocation of @alloc and applies it
+ * to the host.  On failure neither @alloc nor the host are changed.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virResctrlAllocResizeMemoryBandwidth(virResctrlInfoPtr resctrl,
+                                     virResctrlAllocPtr alloc,
+                                     unsigned int id,
+                                     unsigned int memory_bandwidth)
+{
+    unsigned int old_bandwidth = 0;
+    int lockfd = -1;
+    int ret = -1;
+
+    if (!virResctrlAllocIsCreated(alloc))
+        return -1;
+
+    if (!virResctrlAllocGetMemoryBandwidth(alloc, id, &old_bandwidth)) {
+        virReportError(VIR_ERR_INTERNAL_ERROR,
+                       _("No memory bandwidth allocation for node %u "
+                         "to resize"), id);
+        return -1;
+    }
+
+    if (memory_bandwidth > 100) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       _("Memory Bandwidth value exceeding 100 is invalid."));
+        return -1;
+    }
+
+    lockfd = virResctrlLock();
+    if (lockfd < 0)
+        return -1;
+
+    *(alloc->mem_bw->bandwidths[id]) = memory_bandwidth;
+
+    if (virResctrlAllocMemoryBandwidth(resctrl, alloc) < 0 ||
+        virResctrlAllocWriteSchemata(alloc) < 0) {
+        *(alloc->mem_bw->bandwidths[id]) = old_bandwidth;
+        goto cleanup;
+    }
+
+    ret = 0;
+ cleanup:
+    virResctrlUnlock(lockfd);
+    return ret;
+}
+
+
+/* Auto-tuning of allocations
+ *
+ * The functions below only decide on new sizes of allocations sharing one
+ * cache or one memory bandwidth controller, based on how much of it each
+ * of them uses.  Applying the decision is up to the caller.
+ */
+
+/* An allocation using at least this percentage of its size is starved */
+#define VIR_RESCTRL_TUNE_HIGH 90
+/* An allocation using less than this percentage of its size is oversized */
+#define VIR_RESCTRL_TUNE_LOW 50
+
+
+static void
+virResctrlTuneInit(virResctrlTuneEntryPtr entries,
+                   size_t nentries)
+{
+    size_t i;
+
+    for (i = 0; i < nentries; i++) {
+        virResctrlTuneEntryPtr entry = &entries[i];
+
+        entry->target = MIN(MAX(entry->size, entry->min), entry->max);
+    }
+}
+
+
+/*
+ * virResctrlTuneCache
+ * @entries: Allocations sharing one cache
+ * @nentries: Number of @entries
+ * @avail: Bytes of the cache not allocated to anyone
+ * @step: Granularity of the cache allocations in bytes
+ *
+ * Allocations using less than half of their size give one @step back.
+ * Starved allocations grow by one @step, taken from the unallocated part
+ * of the cache if possible.  Once there is none left, the step is taken
+ * from the largest allocation which is at least two steps bigger, so
+ * that contending domains converge to equal shares instead of the
+ * noisiest one keeping most of the cache.  All targets stay within the
+ * min and max bounds of each entry, which must be multiples of @step.
+ */
+void
+virResctrlTuneCache(virResctrlTuneEntryPtr entries,
+                    size_t nentries,
+                    unsigned long long avail,
+                    unsigned long long step)
+{
+    size_t i;
+    size_t j;
+
+    virResctrlTuneInit(entries, nentries);
+
+    for (i = 0; i < nentries; i++) {
+        virResctrlTuneEntryPtr entry = &entries[i];
+
+        if (entry->usage * 100 < entry->target * VIR_RESCTRL_TUNE_LOW &&
+            entry->target >= entry->min + step) {
+            entry->target -= step;
+            avail += step;
+        }
+    }
+
+    for (i = 0; i < nentries; i++) {
+        virResctrlTuneEntryPtr entry = &entries[i];
+        virResctrlTuneEntryPtr donor = NULL;
+
+        if (entry->usage * 100 < entry->size * VIR_RESCTRL_TUNE_HIGH ||
+            entry->target + step > entry->max)
+            continue;
+
+        if (avail >= step) {
+            entry->target += step;
+            avail -= step;
+            continue;
+        }
+
+        for (j = 0; j < nentries; j++) {
+            virResctrlTuneEntryPtr tmp = &entries[j];
+
+            if (j == i ||
+                tmp->target < tmp->min + step ||
+                tmp->target <= entry->target + step)
+                continue;
+
+            if (!donor || tmp->target > donor->target)
+                donor = tmp;
+        }
+
+        if (donor) {
+            donor->target -= step;
+            entry->target += step;
+        }
+    }
+}
+
+
+/*
+ * virResctrlTuneMemoryBandwidth
+ * @entries: Allocations sharing one memory bandwidth controller, with the
+ *           usage in bytes per second and sizes in percent
+ * @nentries: Number of @entries
+ * @peak: Highest total bandwidth seen on the controller in bytes per second
+ * @step: Granularity of the bandwidth allocations in percent
+ *
+ * When the total bandwidth gets close to @peak, the controller is
+ * considered saturated and the allocation using the most bandwidth, if it
+ * uses more than an average share, is throttled by one @step.  When the
+ * total drops below half of @peak, all allocations are relaxed by one
+ * @step.  All targets stay within the min and max bounds of each entry.
+ */
+void
+virResctrlTuneMemoryBandwidth(virResctrlTuneEntryPtr entries,
+                              size_t nentries,
+                              unsigned long long peak,
+                              unsigned long long step)
+{
+    virResctrlTuneEntryPtr noisy = NULL;
+    unsigned long long total = 0;
+    size_t i;
+
+    virResctrlTuneInit(entries, nentries);
+
+    if (!nentries || !peak)
+        return;
+
+    for (i = 0; i < nentries; i++)
+        total += entries[i].usage;
+
+    if (total * 100 >= peak * VIR_RESCTRL_TUNE_HIGH) {
+        for (i = 0; i < nentries; i++) {
+            virResctrlTuneEntryPtr entry = &entries[i];
+
+            if (entry->target < entry->min + step ||
+                entry->usage * nentries <= total)
+                continue;
+
+            if (!noisy || entry->usage > noisy->usage)
+                noisy = entry;
+        }
+
+        if (noisy)
+            noisy->target -= step;
+    } else if (total * 100 < peak * VIR_RESCTRL_TUNE_LOW) {
+        for (i = 0; i < nentries; i++) {
+            virResctrlTuneEntryPtr entry = &entries[i];
+
+            if (entry->target + step <= entry->max)
+                entry->target += step;
+        }
+    }
+}
+
+
 /* virResctrlMonitor-related definitions */
 
 virResctrlMonitorPtr
@@ -2634,24 +3130,11 @@ virResctrlMonitorStatsSorter(const void *a,
 }
 
 
-/*
- * virResctrlMonitorGetStats
- *
- * @monitor: The monitor that the statistic data will be retrieved from.
- * @resources: A string list for the monitor feature names.
- * @stats: Pointer of of virResctrlMonitorStatsPtr array for holding cache or
- * memory bandwidth usage data.
- * @nstats: A size_t pointer to hold the returned array length of @stats
- *
- * Get cache or memory bandwidth utilization information.
- *
- * Returns 0 on success, -1 on error.
- */
-int
-virResctrlMonitorGetStats(virResctrlMonitorPtr monitor,
-                          const char **resources,
-                          virResctrlMonitorStatsPtr **stats,
-                          size_t *nstats)
+static int
+virResctrlGetStats(const char *path,
+                   const char **resources,
+                   virResctrlMonitorStatsPtr **stats,
+                   size_t *nstats)
 {
     int rv = -1;
     int ret = -1;
@@ -2663,13 +3146,7 @@ virResctrlMonitorGetStats(virResctrlMonitorPtr monitor,
     struct dirent *ent = NULL;
     virResctrlMonitorStatsPtr stat = NULL;
 
-    if (!monitor) {
-        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
-                       _("Invalid resctrl monitor"));
-        return -1;
-    }
-
-    datapath = g_strdup_printf("%s/mon_data", monitor->path);
+    datapath = g_strdup_printf("%s/mon_data", path);
 
     if (virDirOpen(&dirp, datapath) < 0)
         goto cleanup;
@@ -2745,6 +3222,62 @@ virResctrlMonitorGetStats(virResctrlMonitorPtr monitor,
 }
 
 
+/*
+ * virResctrlMonitorGetStats
+ *
+ * @monitor: The monitor that the statistic data will be retrieved from.
+ * @resources: A string list for the monitor feature names.
+ * @stats: Pointer of of virResctrlMonitorStatsPtr array for holding cache or
+ * memory bandwidth usage data.
+ * @nstats: A size_t pointer to hold the returned array length of @stats
+ *
+ * Get cache or memory bandwidth utilization information.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virResctrlMonitorGetStats(virResctrlMonitorPtr monitor,
+                          const char **resources,
+                          virResctrlMonitorStatsPtr **stats,
+                          size_t *nstats)
+{
+    if (!monitor) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       _("Invalid resctrl monitor"));
+        return -1;
+    }
+
+    return virResctrlGetStats(monitor->path, resources, stats, nstats);
+}
+
+
+/*
+ * virResctrlAllocGetStats
+ *
+ * @alloc: Allocation created by virResctrlAllocCreate()
+ * @resources: A string list for the monitor feature names.
+ * @stats: Pointer of of virResctrlMonitorStatsPtr array for holding cache or
+ * memory bandwidth usage data.
+ * @nstats: A size_t pointer to hold the returned array length of @stats
+ *
+ * Like virResctrlMonitorGetStats(), but reports the utilization of all
+ * tasks in the allocation group, no matter what monitors were defined.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int
+virResctrlAllocGetStats(virResctrlAllocPtr alloc,
+                        const char **resources,
+                        virResctrlMonitorStatsPtr **stats,
+                        size_t *nstats)
+{
+    if (!virResctrlAllocIsCreated(alloc))
+        return -1;
+
+    return virResctrlGetStats(alloc->path, resources, stats, nstats);
+}
+
+
 void
 virResctrlMonitorStatsFree(virResctrlMonitorStatsPtr stat)
 {
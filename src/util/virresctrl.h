@@ -140,6 +140,13 @@ virResctrlAllocSetCacheSize(virResctrlAllocPtr alloc,
                             unsigned int cache,
                             unsigned long long size);
 
+bool
+virResctrlAllocGetCacheSize(virResctrlAllocPtr alloc,
+                            unsigned int level,
+                            virCacheType type,
+                            unsigned int cache,
+                            unsigned long long *size);
+
 int
 virResctrlAllocForeachCache(virResctrlAllocPtr alloc,
                             virResctrlAllocForeachCacheCallback cb,
@@ -150,6 +157,11 @@ virResctrlAllocSetMemoryBandwidth(virResctrlAllocPtr alloc,
                                   unsigned int id,
                                   unsigned int memory_bandwidth);
 
+bool
+virResctrlAllocGetMemoryBandwidth(virResctrlAllocPtr alloc,
+                                  unsigned int id,
+                                  unsigned int *memory_bandwidth);
+
 int
 virResctrlAllocForeachMemory(virResctrlAllocPtr alloc,
                              virResctrlAllocForeachMemoryCallback cb,
@@ -180,6 +192,56 @@ virResctrlAllocAddPID(virResctrlAllocPtr alloc,
 int
 virResctrlAllocRemove(virResctrlAllocPtr alloc);
 
+int
+virResctrlAllocGetUnusedCacheSize(virResctrlInfoPtr resctrl,
+                                  unsigned int level,
+                                  virCacheType type,
+                                  unsigned int cache,
+                                  unsigned long long *size);
+
+int
+virResctrlAllocResizeCache(virResctrlInfoPtr resctrl,
+                           virResctrlAllocPtr alloc,
+                           unsigned int level,
+                           virCacheType type,
+                           unsigned int cache,
+                           unsigned long long size);
+
+int
+virResctrlAllocResizeMemoryBandwidth(virResctrlInfoPtr resctrl,
+                                     virResctrlAllocPtr alloc,
+                                     unsigned int id,
+                                     unsigned int memory_bandwidth);
+
+/* Auto-tuning */
+
+typedef struct _virResctrlTuneEntry virResctrlTuneEntry;
+typedef virResctrlTuneEntry *virResctrlTuneEntryPtr;
+struct _virResctrlTuneEntry {
+    /* How much of the resource the allocation uses right now */
+    unsigned long long usage;
+    /* Current size of the allocation */
+    unsigned long long size;
+    /* Bounds the allocation may be resized within */
+    unsigned long long min;
+    unsigned long long max;
+    /* The size the allocation should be resized to, filled in by
+     * virResctrlTuneCache() or virResctrlTuneMemoryBandwidth() */
+    unsigned long long target;
+};
+
+void
+virResctrlTuneCache(virResctrlTuneEntryPtr entries,
+                    size_t nentries,
+                    unsigned long long avail,
+                    unsigned long long step);
+
+void
+virResctrlTuneMemoryBandwidth(virResctrlTuneEntryPtr entries,
+                              size_t nentries,
+                              unsigned long long peak,
+                              unsigned long long step);
+
 void
 virResctrlInfoMonFree(virResctrlInfoMonPtr mon);
 
@@ -243,5 +305,11 @@ virResctrlMonitorGetStats(virResctrlMonitorPtr monitor,
                           virResctrlMonitorStatsPtr **stats,
                           size_t *nstats);
 
+int
+virResctrlAllocGetStats(virResctrlAllocPtr alloc,
+                        const char **resources,
+                        virResctrlMonitorStatsPtr **stats,
+                        size_t *nstats);
+
 void
 virResctrlMonitorStatsFree(virResctrlMonitorStatsPtr stats);
@@ -26,3 +26,11 @@
 
 virResctrlAllocPtr
 virResctrlAllocGetUnused(virResctrlInfoPtr resctrl);
+
+int
+virResctrlAllocResizeCacheMask(virResctrlInfoPtr resctrl,
+                               virResctrlAllocPtr alloc,
+                               unsigned int level,
+                               virCacheType type,
+                               unsigned int cache,
+                               unsigned long long size);
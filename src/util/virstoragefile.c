@@ -21,6 +21,8 @@
 
 #include <config.h>
 #include "virstoragefilebackend.h"
+#define LIBVIRT_VIRSTORAGEFILEPRIV_H_ALLOW
+#include "virstoragefilepriv.h"
 
 #include <unistd.h>
 #include <fcntl.h>
@@ -34,6 +36,7 @@
 #include "virhash.h"
 #include "virendian.h"
 #include "virstring.h"
+#include "virthread.h"
 #include "viruri.h"
 #include "virbuffer.h"
 #include "virjson.h"
@@ -198,6 +201,13 @@ qedGetBackingStore(char **, int *, const char *, size_t);
 #define QCOW1_HDR_TOTAL_SIZE (QCOW1_HDR_CRYPT+4+8)
 #define QCOW2_HDR_TOTAL_SIZE (QCOW2_HDR_CRYPT+4+4+8+8+4+4+8)
 
+#define QCOW2_HDR_CLUSTER_BITS (QCOWX_HDR_BACKING_FILE_SIZE+4)
+#define QCOW2_HDR_L1_SIZE (QCOW2_HDR_CRYPT+4)
+#define QCOW2_HDR_L1_TABLE_OFFSET (QCOW2_HDR_L1_SIZE+4)
+#define QCOW2_HDR_REFCOUNT_TABLE_OFFSET (QCOW2_HDR_L1_TABLE_OFFSET+8)
+#define QCOW2_HDR_REFCOUNT_TABLE_CLUSTERS (QCOW2_HDR_REFCOUNT_TABLE_OFFSET+8)
+#define QCOW2_HDR_NB_SNAPSHOTS (QCOW2_HDR_REFCOUNT_TABLE_CLUSTERS+4)
+
 #define QCOW2_HDR_EXTENSION_END 0
 #define QCOW2_HDR_EXTENSION_BACKING_FORMAT 0xE2792ACA
 
@@ -205,6 +215,8 @@ qedGetBackingStore(char **, int *, const char *, size_t);
 #define QCOW2v3_HDR_FEATURES_COMPATIBLE (QCOW2v3_HDR_FEATURES_INCOMPATIBLE+8)
 #define QCOW2v3_HDR_FEATURES_AUTOCLEAR (QCOW2v3_HDR_FEATURES_COMPATIBLE+8)
 
+#define QCOW2v3_HDR_REFCOUNT_ORDER (QCOW2v3_HDR_FEATURES_AUTOCLEAR+8)
+
 /* The location of the header size [4 bytes] */
 #define QCOW2v3_HDR_SIZE       (QCOW2_HDR_TOTAL_SIZE+8+8+8+4)
 
@@ -1193,6 +1205,279 @@ virStorageFileGetMetadataFromFD(const char *path,
     return g_steal_pointer(&meta);
 }
 
+/* Layout used for qcow2 images created by virStorageFileQcow2Create,
+ * matching what qemu-img uses by default: 64KiB clusters, 16 bit
+ * refcounts, the refcount table in cluster 1, a single refcount block
+ * in cluster 2 and the L1 table starting at cluster 3. */
+#define QCOW2_MAGIC 0x514649fb
+#define QCOW2_CLUSTER_BITS 16
+#define QCOW2_CLUSTER_SIZE (1ULL << QCOW2_CLUSTER_BITS)
+#define QCOW2_REFCOUNT_ORDER 4
+#define QCOW2_MAX_L1_SIZE (32 * 1024 * 1024)
+#define QCOW2_MAX_BACKING_FILE_NAME 1023
+
+static int
+virStorageFileQcow2WriteAt(int fd,
+                           const char *path,
+                           off_t offset,
+                           const char *buf,
+                           size_t len)
+{
+    if (lseek(fd, offset, SEEK_SET) == (off_t)-1) {
+        virReportSystemError(errno, _("cannot seek in '%s'"), path);
+        return -1;
+    }
+
+    if (safewrite(fd, buf, len) < 0) {
+        virReportSystemError(errno, _("cannot write to '%s'"), path);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * virStorageFileQcow2Create:
+ * @fd: file descriptor of an empty, writable file
+ * @path: name of the file, for error messages
+ * @capacity: virtual size of the image in bytes, multiple of 512
+ * @backingPath: backing file name to record in the image, or NULL
+ * @backingFormat: format of @backingPath
+ * @v3: create a qcow2 v3 ('1.1') image rather than v2 ('0.10')
+ * @lazyRefcounts: enable the lazy_refcounts compatible feature (v3 only)
+ *
+ * Writes the metadata of an empty qcow2 image into @fd, as 'qemu-img
+ * create -f qcow2' would, without running any external program.
+ *
+ * Returns 0 on success, -1 on error with error reported.
+ */
+int
+virStorageFileQcow2Create(int fd,
+                          const char *path,
+                          unsigned long long capacity,
+                          const char *backingPath,
+                          int backingFormat,
+                          bool v3,
+                          bool lazyRefcounts)
+{
+    unsigned long long l2Coverage = QCOW2_CLUSTER_SIZE * (QCOW2_CLUSTER_SIZE / 8);
+    unsigned long long l1Size = VIR_DIV_UP(capacity, l2Coverage);
+    unsigned long long l1Clusters;
+    unsigned long long nclusters;
+    size_t offset = v3 ? QCOW2v3_HDR_SIZE + 4 : QCOW2_HDR_TOTAL_SIZE;
+    g_autofree char *header = NULL;
+    g_autofree char *refblock = NULL;
+    char reftable[8];
+    size_t i;
+
+    if (capacity % 512 != 0) {
+        virReportError(VIR_ERR_INVALID_ARG,
+                       _("image size %llu is not a multiple of 512"), capacity);
+        return -1;
+    }
+
+    if (l1Size * 8 > QCOW2_MAX_L1_SIZE) {
+        virReportError(VIR_ERR_INVALID_ARG,
+                       _("image size %llu is too large for qcow2"), capacity);
+        return -1;
+    }
+
+    if (lazyRefcounts && !v3) {
+        virReportError(VIR_ERR_CONFIG_UNSUPPORTED, "%s",
+                       _("lazy_refcounts not supported with compat level 0.10"));
+        return -1;
+    }
+
+    l1Clusters = MAX(1, VIR_DIV_UP(l1Size * 8, QCOW2_CLUSTER_SIZE));
+    nclusters = 3 + l1Clusters;
+
+    header = g_new0(char, QCOW2_CLUSTER_SIZE);
+
+    virWriteBufInt32BE(header, QCOW2_MAGIC);
+    virWriteBufInt32BE(header + QCOWX_HDR_VERSION, v3 ? 3 : 2);
+    virWriteBufInt32BE(header + QCOW2_HDR_CLUSTER_BITS, QCOW2_CLUSTER_BITS);
+    virWriteBufInt64BE(header + QCOWX_HDR_IMAGE_SIZE, capacity);
+    virWriteBufInt32BE(header + QCOW2_HDR_L1_SIZE, l1Size);
+    virWriteBufInt64BE(header + QCOW2_HDR_L1_TABLE_OFFSET, 3 * QCOW2_CLUSTER_SIZE);
+    virWriteBufInt64BE(header + QCOW2_HDR_REFCOUNT_TABLE_OFFSET, QCOW2_CLUSTER_SIZE);
+    virWriteBufInt32BE(header + QCOW2_HDR_REFCOUNT_TABLE_CLUSTERS, 1);
+
+    if (v3) {
+        if (lazyRefcounts)
+            virWriteBufInt64BE(header + QCOW2v3_HDR_FEATURES_COMPATIBLE,
+                               1ULL << QCOW2_COMPATIBLE_FEATURE_LAZY_REFCOUNTS);
+        virWriteBufInt32BE(header + QCOW2v3_HDR_REFCOUNT_ORDER, QCOW2_REFCOUNT_ORDER);
+        virWriteBufInt32BE(header + QCOW2v3_HDR_SIZE, offset);
+    }
+
+    if (backingPath) {
+        const char *fmtstr = virStorageFileFormatTypeToString(backingFormat);
+        size_t pathlen = strlen(backingPath);
+        size_t fmtlen;
+
+        if (!fmtstr || backingFormat <= VIR_STORAGE_FILE_NONE) {
+            virReportError(VIR_ERR_INTERNAL_ERROR,
+                           _("unknown backing store format %d"), backingFormat);
+            return -1;
+        }
+        fmtlen = strlen(fmtstr);
+
+        if (pathlen > QCOW2_MAX_BACKING_FILE_NAME) {
+            virReportError(VIR_ERR_INVALID_ARG,
+                           _("backing file name '%s' is too long"), backingPath);
+            return -1;
+        }
+
+        virWriteBufInt32BE(header + offset, QCOW2_HDR_EXTENSION_BACKING_FORMAT);
+        virWriteBufInt32BE(header + offset + 4, fmtlen);
+        memcpy(header + offset + 8, fmtstr, fmtlen);
+        offset += 8 + VIR_ROUND_UP(fmtlen, 8);
+
+        /* QCOW2_HDR_EXTENSION_END is all zeroes */
+        offset += 8;
+
+        virWriteBufInt64BE(header + QCOWX_HDR_BACKING_FILE_OFFSET, offset);
+        virWriteBufInt32BE(header + QCOWX_HDR_BACKING_FILE_SIZE, pathlen);
+        memcpy(header + offset, backingPath, pathlen);
+    }
+
+    virWriteBufInt64BE(reftable, 2 * QCOW2_CLUSTER_SIZE);
+
+    refblock = g_new0(char, nclusters * 2);
+    for (i = 0; i < nclusters; i++)
+        virWriteBufInt16BE(refblock + i * 2, 1);
+
+    /* The L1 table is all zeroes, so just extend the file to cover it */
+    if (ftruncate(fd, nclusters * QCOW2_CLUSTER_SIZE) < 0) {
+        virReportSystemError(errno, _("cannot resize '%s'"), path);
+        return -1;
+    }
+
+    if (virStorageFileQcow2WriteAt(fd, path, 2 * QCOW2_CLUSTER_SIZE,
+                                   refblock, nclusters * 2) < 0 ||
+        virStorageFileQcow2WriteAt(fd, path, QCOW2_CLUSTER_SIZE,
+                                   reftable, sizeof(reftable)) < 0 ||
+        virStorageFileQcow2WriteAt(fd, path, 0,
+                                   header, QCOW2_CLUSTER_SIZE) < 0)
+        return -1;
+
+    return 0;
+}
+
+
+/**
+ * virStorageFileQcow2Grow:
+ * @fd: file descriptor of a qcow2 image opened for writing
+ * @path: name of the file, for error messages
+ * @capacity: new virtual size of the image in bytes, multiple of 512
+ *
+ * Grows the virtual size of the qcow2 image in @fd by rewriting its
+ * header. Only the simple case is handled, where the new size doesn't
+ * require allocating a new L1 table and the image has neither internal
+ * snapshots nor any autoclear feature (e.g. persistent bitmaps) whose
+ * metadata depends on the size; the caller must make sure nobody else
+ * has the image open.
+ *
+ * Returns 0 on success, 1 if the image has to be resized by other means
+ * (e.g. qemu-img) and -1 on error with error reported.
+ */
+int
+virStorageFileQcow2Grow(int fd,
+                        const char *path,
+                        unsigned long long capacity)
+{
+    char header[QCOW2v3_HDR_SIZE + 4] = { 0 };
+    char sizes[QCOW2_HDR_L1_SIZE + 4 - QCOWX_HDR_IMAGE_SIZE];
+    unsigned int version;
+    unsigned int clusterBits;
+    unsigned long long oldCapacity;
+    unsigned long long l1Size;
+    unsigned long long l1Offset;
+    unsigned long long newL1Size;
+    g_autofree char *l1tail = NULL;
+    ssize_t len;
+    size_t i;
+
+    if (capacity % 512 != 0)
+        return 1;
+
+    if (lseek(fd, 0, SEEK_SET) == (off_t)-1 ||
+        (len = saferead(fd, header, sizeof(header))) < 0) {
+        virReportSystemError(errno, _("cannot read header of '%s'"), path);
+        return -1;
+    }
+
+    if (len < QCOW2_HDR_TOTAL_SIZE ||
+        virReadBufInt32BE(header) != QCOW2_MAGIC)
+        return 1;
+
+    version = virReadBufInt32BE(header + QCOWX_HDR_VERSION);
+    clusterBits = virReadBufInt32BE(header + QCOW2_HDR_CLUSTER_BITS);
+    oldCapacity = virReadBufInt64BE(header + QCOWX_HDR_IMAGE_SIZE);
+    l1Size = virReadBufInt32BE(header + QCOW2_HDR_L1_SIZE);
+    l1Offset = virReadBufInt64BE(header + QCOW2_HDR_L1_TABLE_OFFSET);
+
+    /* Leave encrypted images, images with internal snapshots, with any
+     * incompatible feature bit set (dirty, corrupt, external data file,
+     * ...) or any autoclear feature bit set (bitmaps, raw external data)
+     * and shrinking to qemu-img. */
+    if ((version != 2 && version != 3) ||
+        clusterBits < 9 || clusterBits > 21 ||
+        virReadBufInt32BE(header + QCOW2_HDR_CRYPT) != 0 ||
+        virReadBufInt32BE(header + QCOW2_HDR_NB_SNAPSHOTS) != 0 ||
+        capacity < oldCapacity)
+        return 1;
+
+    if (version == 3 &&
+        (len < sizeof(header) ||
+         virReadBufInt64BE(header + QCOW2v3_HDR_FEATURES_INCOMPATIBLE) != 0 ||
+         virReadBufInt64BE(header + QCOW2v3_HDR_FEATURES_AUTOCLEAR) != 0))
+        return 1;
+
+    newL1Size = VIR_DIV_UP(capacity, 1ULL << (2 * clusterBits - 3));
+
+    if (newL1Size > l1Size) {
+        unsigned long long l1Allocated = VIR_ROUND_UP(l1Size * 8, 1ULL << clusterBits);
+        size_t taillen = (newL1Size - l1Size) * 8;
+
+        /* The L1 table may only grow within the clusters it already
+         * occupies, and only if the entries there are unused. */
+        if (l1Size == 0 || newL1Size * 8 > l1Allocated)
+            return 1;
+
+        l1tail = g_new0(char, taillen);
+        if (lseek(fd, l1Offset + l1Size * 8, SEEK_SET) == (off_t)-1 ||
+            (len = saferead(fd, l1tail, taillen)) < 0) {
+            virReportSystemError(errno, _("cannot read L1 table of '%s'"), path);
+            return -1;
+        }
+
+        if (len != taillen)
+            return 1;
+
+        for (i = 0; i < taillen; i++) {
+            if (l1tail[i] != 0)
+                return 1;
+        }
+    } else {
+        newL1Size = l1Size;
+    }
+
+    /* Image size, encryption method and L1 table size are adjacent in the
+     * header, so they can be updated in a single write. */
+    memcpy(sizes, header + QCOWX_HDR_IMAGE_SIZE, sizeof(sizes));
+    virWriteBufInt64BE(sizes, capacity);
+    virWriteBufInt32BE(sizes + QCOW2_HDR_L1_SIZE - QCOWX_HDR_IMAGE_SIZE, newL1Size);
+
+    if (virStorageFileQcow2WriteAt(fd, path, QCOWX_HDR_IMAGE_SIZE,
+                                   sizes, sizeof(sizes)) < 0)
+        return -1;
+
+    return 0;
+}
+
+
 
 #ifdef WITH_UDEV
 /* virStorageFileGetSCSIKey
@@ -5040,6 +5325,239 @@ virStorageFileReportBrokenChain(int errcode,
 }
 
 
+/*
+ * Process-wide cache of image headers read while traversing backing chains.
+ *
+ * Entries are keyed by device and inode of local image files and are only
+ * used while mtime, ctime and size of the file still match. Since the
+ * timestamps have only second granularity, files modified within the last
+ * VIR_STORAGE_FILE_HEADER_CACHE_SETTLE seconds are never cached; any later
+ * write is then guaranteed to change the timestamps. Callers which modify
+ * images themselves should still call virStorageFileMetadataCacheInvalidate.
+ */
+#define VIR_STORAGE_FILE_HEADER_CACHE_MAX 256
+#define VIR_STORAGE_FILE_HEADER_CACHE_SETTLE 2
+
+typedef struct _virStorageFileHeaderCacheEntry virStorageFileHeaderCacheEntry;
+typedef virStorageFileHeaderCacheEntry *virStorageFileHeaderCacheEntryPtr;
+struct _virStorageFileHeaderCacheEntry {
+    time_t mtime;
+    time_t ctime;
+    off_t size;
+    uid_t uid;
+    gid_t gid;
+
+    char *buf;
+    size_t len;
+};
+
+static virMutex virStorageFileHeaderCacheLock = VIR_MUTEX_INITIALIZER;
+static GHashTable *virStorageFileHeaderCache;
+static unsigned int virStorageFileHeaderCacheSettle = VIR_STORAGE_FILE_HEADER_CACHE_SETTLE;
+
+
+static void
+virStorageFileHeaderCacheEntryFree(void *opaque)
+{
+    virStorageFileHeaderCacheEntryPtr entry = opaque;
+
+    if (!entry)
+        return;
+
+    g_free(entry->buf);
+    g_free(entry);
+}
+
+
+static char *
+virStorageFileHeaderCacheKey(const struct stat *st)
+{
+    return g_strdup_printf("%llu:%llu",
+                           (unsigned long long)st->st_dev,
+                           (unsigned long long)st->st_ino);
+}
+
+
+/**
+ * virStorageFileHeaderCacheStat:
+ * @src: storage source, initialized for access
+ * @st: filled with the result of stat on @src
+ *
+ * Returns true if the header of @src may be served from (or stored in)
+ * the header cache. Only local regular files in formats which may carry a
+ * backing store are considered.
+ */
+static bool
+virStorageFileHeaderCacheStat(virStorageSourcePtr src,
+                              struct stat *st)
+{
+    if (virStorageSourceGetActualType(src) != VIR_STORAGE_TYPE_FILE ||
+        src->format < VIR_STORAGE_FILE_BACKING)
+        return false;
+
+    if (virStorageFileStat(src, st) < 0)
+        return false;
+
+    return S_ISREG(st->st_mode);
+}
+
+
+static bool
+virStorageFileHeaderCacheGet(const struct stat *st,
+                             uid_t uid,
+                             gid_t gid,
+                             char **buf,
+                             size_t *len)
+{
+    g_autofree char *key = virStorageFileHeaderCacheKey(st);
+    virStorageFileHeaderCacheEntryPtr entry;
+    bool ret = false;
+
+    virMutexLock(&virStorageFileHeaderCacheLock);
+
+    if (virStorageFileHeaderCache &&
+        (entry = virHashLookup(virStorageFileHeaderCache, key))) {
+        if (entry->mtime == st->st_mtime &&
+            entry->ctime == st->st_ctime &&
+            entry->size == st->st_size &&
+            entry->uid == uid &&
+            entry->gid == gid) {
+            *buf = g_new0(char, entry->len);
+            memcpy(*buf, entry->buf, entry->len);
+            *len = entry->len;
+            ret = true;
+        } else {
+            virHashRemoveEntry(virStorageFileHeaderCache, key);
+        }
+    }
+
+    virMutexUnlock(&virStorageFileHeaderCacheLock);
+
+    VIR_DEBUG("header cache %s for %s", ret ? "hit" : "miss", key);
+
+    return ret;
+}
+
+
+static void
+virStorageFileHeaderCachePut(const struct stat *st,
+                             uid_t uid,
+                             gid_t gid,
+                             const char *buf,
+                             size_t len)
+{
+    time_t now = g_get_real_time() / G_USEC_PER_SEC;
+    virStorageFileHeaderCacheEntryPtr entry;
+    g_autofree char *key = NULL;
+
+    if (len == 0 ||
+        now - st->st_mtime < virStorageFileHeaderCacheSettle ||
+        now - st->st_ctime < virStorageFileHeaderCacheSettle)
+        return;
+
+    key = virStorageFileHeaderCacheKey(st);
+
+    entry = g_new0(virStorageFileHeaderCacheEntry, 1);
+    entry->mtime = st->st_mtime;
+    entry->ctime = st->st_ctime;
+    entry->size = st->st_size;
+    entry->uid = uid;
+    entry->gid = gid;
+    entry->buf = g_new0(char, len);
+    memcpy(entry->buf, buf, len);
+    entry->len = len;
+
+    virMutexLock(&virStorageFileHeaderCacheLock);
+
+    if (!virStorageFileHeaderCache)
+        virStorageFileHeaderCache = virHashNew(virStorageFileHeaderCacheEntryFree);
+
+    /* Keep the memory footprint bounded; the entries are cheap to
+     * re-create so there's no point in tracking their age. */
+    if (virHashSize(virStorageFileHeaderCache) >= VIR_STORAGE_FILE_HEADER_CACHE_MAX)
+        virHashRemoveAll(virStorageFileHeaderCache);
+
+    if (virHashUpdateEntry(virStorageFileHeaderCache, key, entry) < 0)
+        virStorageFileHeaderCacheEntryFree(entry);
+
+    virMutexUnlock(&virStorageFileHeaderCacheLock);
+}
+
+
+/**
+ * virStorageFileMetadataCacheInvalidate:
+ * @path: path to a local image file
+ *
+ * Drops any cached header of @path so that the next call to
+ * virStorageFileGetMetadata re-reads it from disk. Must be called
+ * whenever libvirt modifies an image (or is about to remove it).
+ * Nonexistent files are silently ignored.
+ */
+void
+virStorageFileMetadataCacheInvalidate(const char *path)
+{
+    struct stat st;
+    g_autofree char *key = NULL;
+
+    if (!path || stat(path, &st) < 0)
+        return;
+
+    key = virStorageFileHeaderCacheKey(&st);
+
+    virMutexLock(&virStorageFileHeaderCacheLock);
+    if (virStorageFileHeaderCache)
+        virHashRemoveEntry(virStorageFileHeaderCache, key);
+    virMutexUnlock(&virStorageFileHeaderCacheLock);
+}
+
+
+/**
+ * virStorageFileMetadataCacheClear:
+ *
+ * Drops all cached image headers, e.g. when images may have been
+ * modified outside of libvirt.
+ */
+void
+virStorageFileMetadataCacheClear(void)
+{
+    virMutexLock(&virStorageFileHeaderCacheLock);
+    virHashRemoveAll(virStorageFileHeaderCache);
+    virMutexUnlock(&virStorageFileHeaderCacheLock);
+}
+
+
+/* Tests can't wait for files to settle. Returns the previous value. */
+unsigned int
+virStorageFileHeaderCacheSetSettle(unsigned int settle)
+{
+    unsigned int old = virStorageFileHeaderCacheSettle;
+
+    virStorageFileHeaderCacheSettle = settle;
+    return old;
+}
+
+
+bool
+virStorageFileHeaderCacheContains(const char *path)
+{
+    struct stat st;
+    g_autofree char *key = NULL;
+    bool ret;
+
+    if (stat(path, &st) < 0)
+        return false;
+
+    key = virStorageFileHeaderCacheKey(&st);
+
+    virMutexLock(&virStorageFileHeaderCacheLock);
+    ret = virStorageFileHeaderCache &&
+          virHashLookup(virStorageFileHeaderCache, key);
+    virMutexUnlock(&virStorageFileHeaderCacheLock);
+
+    return ret;
+}
+
+
 static int
 virStorageFileGetMetadataRecurseReadHeader(virStorageSourcePtr src,
                                            virStorageSourcePtr parent,
@@ -5052,6 +5570,8 @@ virStorageFileGetMetadataRecurseReadHeader(virStorageSourcePtr src,
     int ret = -1;
     const char *uniqueName;
     ssize_t len;
+    struct stat st;
+    bool cacheable;
 
     if (virStorageFileInitAs(src, uid, gid) < 0)
         return -1;
@@ -5074,9 +5594,20 @@ virStorageFileGetMetadataRecurseReadHeader(virStorageSourcePtr src,
     if (virHashAddEntry(cycle, uniqueName, NULL) < 0)
         goto cleanup;
 
+    cacheable = virStorageFileHeaderCacheStat(src, &st);
+
+    if (cacheable &&
+        virStorageFileHeaderCacheGet(&st, uid, gid, buf, headerLen)) {
+        ret = 0;
+        goto cleanup;
+    }
+
     if ((len = virStorageFileRead(src, 0, VIR_STORAGE_MAX_HEADER, buf)) < 0)
         goto cleanup;
 
+    if (cacheable)
+        virStorageFileHeaderCachePut(&st, uid, gid, *buf, len);
+
     *headerLen = len;
     ret = 0;
 
@@ -414,6 +414,18 @@ virStorageSourcePtr virStorageFileGetMetadataFromBuf(const char *path,
                                                      size_t len,
                                                      int format)
     ATTRIBUTE_NONNULL(1) ATTRIBUTE_NONNULL(2);
+int virStorageFileQcow2Create(int fd,
+                              const char *path,
+                              unsigned long long capacity,
+                              const char *backingPath,
+                              int backingFormat,
+                              bool v3,
+                              bool lazyRefcounts)
+    ATTRIBUTE_NONNULL(2);
+int virStorageFileQcow2Grow(int fd,
+                            const char *path,
+                            unsigned long long capacity)
+    ATTRIBUTE_NONNULL(2);
 int virStorageFileParseChainIndex(const char *diskTarget,
                                   const char *name,
                                   unsigned int *chainIndex)
@@ -588,6 +600,9 @@ int virStorageFileGetMetadata(virStorageSourcePtr src,
                               bool report_broken)
     ATTRIBUTE_NONNULL(1);
 
+void virStorageFileMetadataCacheInvalidate(const char *path);
+void virStorageFileMetadataCacheClear(void);
+
 int virStorageFileGetBackingStoreStr(virStorageSourcePtr src,
                                      char **backing)
     ATTRIBUTE_NONNULL(1) ATTRIBUTE_NONNULL(2);
@@ -0,0 +1,32 @@
+/*
+ * virstoragefilepriv.h: Functions for testing virstoragefile APIs
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LIBVIRT_VIRSTORAGEFILEPRIV_H_ALLOW
+# error "virstoragefilepriv.h may only be included by virstoragefile.c or test suites"
+#endif /* LIBVIRT_VIRSTORAGEFILEPRIV_H_ALLOW */
+
+#pragma once
+
+#include "virstoragefile.h"
+
+unsigned int
+virStorageFileHeaderCacheSetSettle(unsigned int settle);
+
+bool
+virStorageFileHeaderCacheContains(const char *path);
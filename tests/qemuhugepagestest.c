@@ -0,0 +1,219 @@
+/*
+ * qemuhugepagestest.c: test the huge page ledger
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include "testutils.h"
+
+#ifdef __linux__
+
+# include "virerror.h"
+# include "virfilewrapper.h"
+# define LIBVIRT_QEMU_HUGEPAGESPRIV_H_ALLOW
+# include "qemu/qemu_hugepagespriv.h"
+
+# define VIR_FROM_THIS VIR_FROM_NONE
+
+/* The fake sysfs in qemuhugepagesdata has these pools:
+ *
+ *             2 MiB pages      1 GiB pages
+ *             total  free      total  free
+ *   node0      512    512        2     2
+ *   node1      512    256        2     2
+ *   host      1024    768        4     4
+ */
+
+typedef enum {
+    TEST_ADMIT,             /* the pages fit */
+    TEST_REJECT,            /* the pages don't fit */
+    TEST_RESERVE,           /* reserve pages of a running domain */
+    TEST_RESERVE_PENDING,   /* reserve pages of a starting domain */
+    TEST_RELEASE,
+    TEST_RELEASE_PENDING,
+} testHugepagesAction;
+
+typedef struct _testHugepagesStep testHugepagesStep;
+struct _testHugepagesStep {
+    testHugepagesAction action;
+    int node;
+    unsigned long long pagesize; /* KiB */
+    unsigned long long pages;
+};
+
+typedef struct _testHugepagesData testHugepagesData;
+struct _testHugepagesData {
+    const testHugepagesStep *steps;
+    size_t nsteps;
+};
+
+
+static int
+testHugepageLedger(const void *opaque)
+{
+    const testHugepagesData *data = opaque;
+    qemuHugepageLedgerPtr ledger = NULL;
+    size_t i;
+    int ret = -1;
+
+    if (!(ledger = qemuHugepageLedgerNew()))
+        return -1;
+
+    for (i = 0; i < data->nsteps; i++) {
+        const testHugepagesStep *step = &data->steps[i];
+        qemuHugepagesItem item = {
+            .node = step->node,
+            .pagesize = step->pagesize,
+            .size = step->pages * step->pagesize,
+        };
+        int rc;
+
+        switch (step->action) {
+        case TEST_ADMIT:
+        case TEST_REJECT:
+            rc = qemuHugepageLedgerAdmit(ledger, &item, 1);
+
+            if (step->action == TEST_ADMIT && rc < 0) {
+                VIR_TEST_VERBOSE("step %zu: %llu pages on node %d refused: %s",
+                                 i, step->pages, step->node,
+                                 virGetLastErrorMessage());
+                goto cleanup;
+            }
+
+            if (step->action == TEST_REJECT && rc == 0) {
+                VIR_TEST_VERBOSE("step %zu: %llu pages on node %d admitted",
+                                 i, step->pages, step->node);
+                goto cleanup;
+            }
+
+            virResetLastError();
+            break;
+
+        case TEST_RESERVE:
+        case TEST_RESERVE_PENDING:
+            qemuHugepageLedgerUpdate(ledger, &item, 1, true,
+                                     step->action == TEST_RESERVE_PENDING);
+            break;
+
+        case TEST_RELEASE:
+        case TEST_RELEASE_PENDING:
+            qemuHugepageLedgerUpdate(ledger, &item, 1, false,
+                                     step->action == TEST_RELEASE_PENDING);
+            break;
+        }
+    }
+
+    ret = 0;
+ cleanup:
+    qemuHugepageLedgerFree(ledger);
+    return ret;
+}
+
+
+# define PAGE_2M 2048
+# define PAGE_1G (1024 * 1024)
+
+static const testHugepagesStep stepsNode[] = {
+    { TEST_ADMIT, 0, PAGE_2M, 512 },
+    { TEST_REJECT, 0, PAGE_2M, 513 },
+    { TEST_ADMIT, 1, PAGE_2M, 256 },
+    { TEST_REJECT, 1, PAGE_2M, 257 },
+};
+
+/* Pages of a domain still starting up aren't free according to the
+ * kernel yet, they are subtracted from both the pool and the free pages */
+static const testHugepagesStep stepsPending[] = {
+    { TEST_RESERVE_PENDING, 0, PAGE_2M, 300 },
+    { TEST_ADMIT, 0, PAGE_2M, 212 },
+    { TEST_REJECT, 0, PAGE_2M, 213 },
+    { TEST_ADMIT, 1, PAGE_2M, 256 },
+    { TEST_RELEASE_PENDING, 0, PAGE_2M, 300 },
+    { TEST_ADMIT, 0, PAGE_2M, 512 },
+};
+
+/* Pages of a running domain are used according to the kernel already,
+ * here the pool is the limit */
+static const testHugepagesStep stepsRunning[] = {
+    { TEST_RESERVE, 0, PAGE_2M, 400 },
+    { TEST_ADMIT, 0, PAGE_2M, 112 },
+    { TEST_REJECT, 0, PAGE_2M, 113 },
+    { TEST_RELEASE, 0, PAGE_2M, 400 },
+    { TEST_ADMIT, 0, PAGE_2M, 512 },
+};
+
+/* Pages bound to a node count against the whole host too */
+static const testHugepagesStep stepsHost[] = {
+    { TEST_ADMIT, -1, PAGE_2M, 768 },
+    { TEST_REJECT, -1, PAGE_2M, 769 },
+    { TEST_RESERVE_PENDING, 0, PAGE_2M, 100 },
+    { TEST_ADMIT, -1, PAGE_2M, 668 },
+    { TEST_REJECT, -1, PAGE_2M, 669 },
+    { TEST_RESERVE_PENDING, -1, PAGE_2M, 600 },
+    { TEST_REJECT, 1, PAGE_2M, 69 },
+    { TEST_ADMIT, 1, PAGE_2M, 68 },
+};
+
+/* Each page size has a pool of its own */
+static const testHugepagesStep stepsPagesize[] = {
+    { TEST_RESERVE_PENDING, 0, PAGE_1G, 2 },
+    { TEST_REJECT, 0, PAGE_1G, 1 },
+    { TEST_ADMIT, 1, PAGE_1G, 2 },
+    { TEST_ADMIT, 0, PAGE_2M, 512 },
+    { TEST_REJECT, 0, PAGE_1G * 2, 1 },
+};
+
+
+static int
+mymain(void)
+{
+    int ret = 0;
+
+    virFileWrapperAddPrefix("/sys/kernel/mm/hugepages",
+                            abs_srcdir "/qemuhugepagesdata/sys/kernel/mm/hugepages");
+    virFileWrapperAddPrefix("/sys/devices/system/node",
+                            abs_srcdir "/qemuhugepagesdata/sys/devices/system/node");
+
+# define DO_TEST(name, steps) \
+    do { \
+        testHugepagesData data = { steps, G_N_ELEMENTS(steps) }; \
+        if (virTestRun("huge page ledger " name, \
+                       testHugepageLedger, &data) < 0) \
+            ret = -1; \
+    } while (0)
+
+    DO_TEST("node", stepsNode);
+    DO_TEST("pending", stepsPending);
+    DO_TEST("running", stepsRunning);
+    DO_TEST("host", stepsHost);
+    DO_TEST("pagesize", stepsPagesize);
+
+    virFileWrapperClearPrefixes();
+
+    return ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+VIR_TEST_MAIN(mymain)
+
+#else
+
+int
+main(void)
+{
+    return EXIT_AM_SKIP;
+}
+
+#endif /* __linux__ */
@@ -1413,6 +1413,87 @@ testQemuMonitorJSONqemuMonitorJSONQueryCPUsFast(const void *opaque)
     return 0;
 }
 
+static int
+testQemuMonitorJSONqemuMonitorJSONQueryStatsVcpuKVM(const void *opaque)
+{
+    const testGenericData *data = opaque;
+    g_autoptr(qemuMonitorTest) test = NULL;
+    qemuMonitorVcpuStatsKVMPtr stats = NULL;
+    size_t nstats = 0;
+    int ret = -1;
+
+    /* query-stats is newer than the QMP schema the tests know */
+    if (!(test = qemuMonitorTestNewSimple(data->xmlopt)))
+        return -1;
+
+    if (qemuMonitorTestAddItem(test, "query-stats",
+                               "{"
+                               "    \"return\": ["
+                               "        {"
+                               "            \"provider\": \"kvm\","
+                               "            \"qom-path\": \"/machine/unattached/device[0]\","
+                               "            \"stats\": ["
+                               "                { \"name\": \"exits\", \"value\": 131078 },"
+                               "                { \"name\": \"halt_wait_hist\", \"value\": [0, 12, 3] },"
+                               "                { \"name\": \"halt_successful_poll\", \"value\": 2016 }"
+                               "            ]"
+                               "        },"
+                               "        {"
+                               "            \"provider\": \"other\","
+                               "            \"qom-path\": \"/machine/unattached/device[0]\","
+                               "            \"stats\": ["
+                               "                { \"name\": \"exits\", \"value\": 1 }"
+                               "            ]"
+                               "        },"
+                               "        {"
+                               "            \"provider\": \"kvm\","
+                               "            \"qom-path\": \"/machine/unattached/device[1]\","
+                               "            \"stats\": ["
+                               "                { \"name\": \"exits\", \"value\": 4097 }"
+                               "            ]"
+                               "        }"
+                               "    ],"
+                               "    \"id\": \"libvirt-9\""
+                               "}") < 0)
+        return -1;
+
+    if (qemuMonitorJSONQueryStatsVcpuKVM(qemuMonitorTestGetMonitor(test),
+                                         &stats, &nstats) < 0)
+        return -1;
+
+    if (nstats != 2 ||
+        STRNEQ(stats[0].qom_path, "/machine/unattached/device[0]") ||
+        STRNEQ(stats[1].qom_path, "/machine/unattached/device[1]")) {
+        virReportError(VIR_ERR_INTERNAL_ERROR,
+                       "Expecting 2 vcpus but got %zu", nstats);
+        goto cleanup;
+    }
+
+    /* the histogram is skipped */
+    if (stats[0].nstats != 2 ||
+        STRNEQ(stats[0].names[0], "exits") || stats[0].values[0] != 131078 ||
+        STRNEQ(stats[0].names[1], "halt_successful_poll") ||
+        stats[0].values[1] != 2016) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       "statistics of vcpu 0 don't match expected data");
+        goto cleanup;
+    }
+
+    if (stats[1].nstats != 1 ||
+        STRNEQ(stats[1].names[0], "exits") || stats[1].values[0] != 4097) {
+        virReportError(VIR_ERR_INTERNAL_ERROR, "%s",
+                       "statistics of vcpu 1 don't match expected data");
+        goto cleanup;
+    }
+
+    ret = 0;
+
+ cleanup:
+    qemuMonitorVcpuStatsKVMFree(stats, nstats);
+    return ret;
+}
+
+
 static int
 testQemuMonitorJSONqemuMonitorJSONGetBalloonInfo(const void *opaque)
 {
@@ -3146,6 +3227,7 @@ mymain(void)
     DO_TEST(qemuMonitorJSONGetMigrationCapabilities);
     DO_TEST(qemuMonitorJSONQueryCPUs);
     DO_TEST(qemuMonitorJSONQueryCPUsFast);
+    DO_TEST(qemuMonitorJSONQueryStatsVcpuKVM);
     DO_TEST(qemuMonitorJSONSendKey);
     DO_TEST(qemuMonitorJSONGetDumpGuestMemoryCapability);
     DO_TEST(qemuMonitorJSONSendKeyHoldtime);
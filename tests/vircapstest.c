@@ -58,6 +58,92 @@ test_virCapabilitiesGetCpusForNodemask(const void *data G_GNUC_UNUSED)
 }
 
 
+/* Four nodes with four CPUs each, nodes 0-1 on socket 0 and nodes 2-3
+ * on socket 1 */
+#define PLACE_NODES 4
+#define PLACE_CPUS 4
+
+static virCapsHostNUMAPtr
+testPlaceBuildTopology(void)
+{
+    virCapsHostNUMAPtr caps = virCapabilitiesHostNUMANew();
+    int node;
+    int other;
+    int cpu;
+
+    for (node = 0; node < PLACE_NODES; node++) {
+        virCapsHostNUMACellCPUPtr cpus = g_new0(virCapsHostNUMACellCPU,
+                                                PLACE_CPUS);
+        virCapsHostNUMACellSiblingInfoPtr siblings;
+
+        siblings = g_new0(virCapsHostNUMACellSiblingInfo, PLACE_NODES);
+
+        for (cpu = 0; cpu < PLACE_CPUS; cpu++) {
+            cpus[cpu].id = node * PLACE_CPUS + cpu;
+            cpus[cpu].socket_id = node / 2;
+            cpus[cpu].core_id = cpu;
+        }
+
+        for (other = 0; other < PLACE_NODES; other++) {
+            siblings[other].node = other;
+            if (other == node)
+                siblings[other].distance = 10;
+            else if (other / 2 == node / 2)
+                siblings[other].distance = 12;
+            else
+                siblings[other].distance = 21;
+        }
+
+        virCapabilitiesHostNUMAAddCell(caps, node, 8 * 1024 * 1024,
+                                       PLACE_CPUS, cpus,
+                                       PLACE_NODES, siblings,
+                                       0, NULL);
+    }
+
+    return caps;
+}
+
+
+struct testPlaceData {
+    unsigned long long memFree[PLACE_NODES]; /* GiB */
+    unsigned int load[PLACE_NODES];
+    unsigned int vcpus;
+    unsigned long long memory; /* GiB */
+    const char *expect;
+};
+
+static int
+testPlace(const void *opaque)
+{
+    const struct testPlaceData *data = opaque;
+    g_autoptr(virCapsHostNUMA) caps = testPlaceBuildTopology();
+    virCapsHostNUMAPlacementLoad load[PLACE_NODES];
+    g_autoptr(virBitmap) nodeset = NULL;
+    g_autofree char *actual = NULL;
+    size_t i;
+
+    for (i = 0; i < PLACE_NODES; i++) {
+        load[i].memFree = data->memFree[i] * 1024 * 1024;
+        load[i].vcpus = data->load[i];
+    }
+
+    if (!(nodeset = virCapabilitiesHostNUMAPlace(caps, load, data->vcpus,
+                                                 data->memory * 1024 * 1024)))
+        return -1;
+
+    if (!(actual = virBitmapFormat(nodeset)))
+        return -1;
+
+    if (STRNEQ(actual, data->expect)) {
+        VIR_TEST_DEBUG("Expected nodeset '%s', got '%s'",
+                       data->expect, actual);
+        return -1;
+    }
+
+    return 0;
+}
+
+
 static bool G_GNUC_UNUSED
 doCapsExpectFailure(virCapsPtr caps,
                     int ostype,
@@ -238,6 +324,29 @@ mymain(void)
     if (virTestRun("virCapabilitiesGetCpusForNodemask",
                    test_virCapabilitiesGetCpusForNodemask, NULL) < 0)
         ret = -1;
+
+#define DO_TEST_PLACE(name, ...) \
+    do { \
+        struct testPlaceData data = { __VA_ARGS__ }; \
+        if (virTestRun("virCapabilitiesHostNUMAPlace " name, \
+                       testPlace, &data) < 0) \
+            ret = -1; \
+    } while (0)
+
+    /* Everything idle, the first node wins */
+    DO_TEST_PLACE("idle", { 4, 4, 4, 4 }, { 0, 0, 0, 0 }, 2, 1, "0");
+    /* Avoid the node whose CPUs are taken */
+    DO_TEST_PLACE("loaded", { 4, 4, 4, 4 }, { 4, 0, 0, 0 }, 4, 1, "1");
+    /* Spread over the closest node on the same socket */
+    DO_TEST_PLACE("memory", { 4, 4, 4, 4 }, { 0, 0, 0, 0 }, 2, 6, "0-1");
+    /* Rather move to the other socket than span both */
+    DO_TEST_PLACE("socket", { 4, 1, 4, 4 }, { 0, 0, 0, 0 }, 2, 6, "2-3");
+    /* Too many vCPUs for one node */
+    DO_TEST_PLACE("vcpus", { 4, 4, 4, 4 }, { 0, 0, 2, 0 }, 6, 1, "0-1");
+    /* Doesn't fit anywhere */
+    DO_TEST_PLACE("nofit", { 1, 1, 1, 1 }, { 0, 0, 0, 0 }, 2, 8, "0-3");
+
+#undef DO_TEST_PLACE
 #ifdef WITH_QEMU
     if (virTestRun("virCapsDomainDataLookupQEMU",
                    test_virCapsDomainDataLookupQEMU, NULL) < 0)
@@ -248,9 +248,9 @@ static int make_controller_v2(const char *path, mode_t mode)
     MAKE_FILE("cgroup.type", "domain\n");
     MAKE_FILE("cpu.max", "max 100000\n");
     MAKE_FILE("cpu.stat",
-              "usage_usec 0\n"
-              "user_usec 0\n"
-              "system_usec 0\n"
+              "usage_usec 3120\n"
+              "user_usec 2040\n"
+              "system_usec 1080\n"
               "nr_periods 0\n"
               "nr_throttled 0\n"
               "throttled_usec 0\n");
@@ -258,6 +258,9 @@ static int make_controller_v2(const char *path, mode_t mode)
     MAKE_FILE("memory.current", "1455321088\n");
     MAKE_FILE("memory.high", "max\n");
     MAKE_FILE("memory.max", "max\n");
+    MAKE_FILE("memory.pressure",
+              "some avg10=1.50 avg60=0.75 avg300=0.25 total=123456\n"
+              "full avg10=0.50 avg60=0.25 avg300=0.10 total=65432\n");
     MAKE_FILE("memory.stat",
               "anon 0\n"
               "file 0\n"
@@ -785,6 +785,109 @@ testCgroupGetMemoryStat(const void *args G_GNUC_UNUSED)
 }
 
 
+static int
+testCgroupGetCpuacctStatUnifiedRead(virCgroupPtr cgroup)
+{
+    unsigned long long usage;
+    unsigned long long user;
+    unsigned long long sys;
+
+    if (virCgroupGetCpuacctTimes(cgroup, &usage, &user, &sys) < 0)
+        return -1;
+
+    if (usage != 3120000ULL || user != 2040000ULL || sys != 1080000ULL) {
+        fprintf(stderr,
+                "Wrong cpu stats: usage=%llu user=%llu sys=%llu\n",
+                usage, user, sys);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+testCgroupGetCpuacctStatUnified(const void *args G_GNUC_UNUSED)
+{
+    g_autoptr(virCgroup) cgroup = NULL;
+    g_autoptr(virCgroup) other = NULL;
+    g_autofree char *statpath = NULL;
+    g_autofree char *hidepath = NULL;
+    int ret = -1;
+
+    statpath = g_strdup_printf("%s/not/really/sys/fs/cgroup/cpu.stat",
+                               getenv("LIBVIRT_FAKE_ROOT_DIR"));
+    hidepath = g_strdup_printf("%s.hidden", statpath);
+
+    if (virCgroupNewSelf(&cgroup) < 0 ||
+        virCgroupNewSelf(&other) < 0) {
+        fprintf(stderr, "Cannot create cgroup for self\n");
+        return -1;
+    }
+
+    if (testCgroupGetCpuacctStatUnifiedRead(cgroup) < 0) {
+        fprintf(stderr, "Could not retrieve cpu stats\n");
+        return -1;
+    }
+
+    /* With the file gone only the group holding the cached descriptor
+     * can still read it */
+    if (rename(statpath, hidepath) < 0) {
+        fprintf(stderr, "Cannot rename %s\n", statpath);
+        return -1;
+    }
+
+    if (testCgroupGetCpuacctStatUnifiedRead(cgroup) < 0) {
+        fprintf(stderr, "Cached cpu stats descriptor was not used\n");
+        goto cleanup;
+    }
+
+    if (testCgroupGetCpuacctStatUnifiedRead(other) == 0) {
+        fprintf(stderr, "Uncached cpu stats read should have failed\n");
+        goto cleanup;
+    }
+    virResetLastError();
+
+    ret = 0;
+ cleanup:
+    if (rename(hidepath, statpath) < 0) {
+        fprintf(stderr, "Cannot rename %s back\n", hidepath);
+        ret = -1;
+    }
+    return ret;
+}
+
+
+static int
+testCgroupGetPressureUnified(const void *args G_GNUC_UNUSED)
+{
+    g_autoptr(virCgroup) cgroup = NULL;
+    virCgroupPressure pressure;
+
+    if (virCgroupNewSelf(&cgroup) < 0) {
+        fprintf(stderr, "Cannot create cgroup for self\n");
+        return -1;
+    }
+
+    if (virCgroupGetPressure(cgroup, VIR_CGROUP_PRESSURE_MEMORY,
+                             &pressure) < 0) {
+        fprintf(stderr, "Could not retrieve memory pressure\n");
+        return -1;
+    }
+
+    if (pressure.some.avg10 != 1.5 || pressure.some.avg60 != 0.75 ||
+        pressure.some.avg300 != 0.25 || pressure.some.total != 123456 ||
+        !pressure.hasFull ||
+        pressure.full.avg10 != 0.5 || pressure.full.avg60 != 0.25 ||
+        pressure.full.avg300 != 0.1 || pressure.full.total != 65432) {
+        fprintf(stderr, "Wrong memory pressure values\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+
 static int testCgroupGetBlkioIoServiced(const void *args G_GNUC_UNUSED)
 {
     g_autoptr(virCgroup) cgroup = NULL;
@@ -1035,6 +1138,12 @@ mymain(void)
         ret = -1;
     if (virTestRun("Cgroup available (unified)", testCgroupAvailable, (void*)0x1) < 0)
         ret = -1;
+    if (virTestRun("virCgroupGetCpuacctTimes works (unified)",
+                   testCgroupGetCpuacctStatUnified, NULL) < 0)
+        ret = -1;
+    if (virTestRun("virCgroupGetPressure works (unified)",
+                   testCgroupGetPressureUnified, NULL) < 0)
+        ret = -1;
     cleanupFakeFS(fakerootdir);
 
     /* cgroup hybrid */
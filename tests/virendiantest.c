@@ -98,6 +98,33 @@ test2(const void *data G_GNUC_UNUSED)
     return 0;
 }
 
+static int
+test3(const void *data G_GNUC_UNUSED)
+{
+    /* Writing must round-trip with reading, even if unaligned.  */
+    char array[13] = { 0 };
+
+    virWriteBufInt64BE(array + 5, 0x060708898a8b8c8dULL);
+    if (virReadBufInt64BE(array + 5) != 0x060708898a8b8c8dULL)
+        return -1;
+    if (array[5] != 6 || (uint8_t)array[12] != 0x8d)
+        return -1;
+
+    virWriteBufInt32BE(array + 1, 0x8a8b8c8dU);
+    if (virReadBufInt32BE(array + 1) != 0x8a8b8c8dU)
+        return -1;
+    if ((uint8_t)array[1] != 0x8a || array[0] != 0)
+        return -1;
+
+    virWriteBufInt16BE(array + 11, 0x0102U);
+    if (virReadBufInt16BE(array + 11) != 0x0102U)
+        return -1;
+    if (array[11] != 1 || array[12] != 2)
+        return -1;
+
+    return 0;
+}
+
 static int
 mymain(void)
 {
@@ -107,6 +134,8 @@ mymain(void)
         ret = -1;
     if (virTestRun("test2", test2, NULL) < 0)
         ret = -1;
+    if (virTestRun("test3", test3, NULL) < 0)
+        ret = -1;
 
     return ret;
 }
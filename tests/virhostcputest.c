@@ -7,6 +7,7 @@
 #include "internal.h"
 #define LIBVIRT_VIRHOSTCPUPRIV_H_ALLOW
 #include "virhostcpupriv.h"
+#include "virhoststats.h"
 #include "virfile.h"
 #include "virstring.h"
 #include "virfilewrapper.h"
@@ -265,6 +266,83 @@ linuxTestNodeCPUStats(const void *data)
 }
 
 
+static int
+linuxTestHostStatsCPUCompare(virHostStatsCPUPtr cpu,
+                             virNodeCPUStatsPtr params)
+{
+    unsigned long long values[] = {
+        cpu->kernel, cpu->user, cpu->idle, cpu->iowait,
+    };
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS(values); i++) {
+        if (values[i] != params[i].value) {
+            VIR_TEST_DEBUG("cpu %d: %s mismatch: expected %llu, got %llu",
+                           cpu->id, params[i].field, params[i].value,
+                           values[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+/* The snapshot must report exactly what the per CPU API reports, only
+ * from a single pass over the file. */
+static int
+linuxTestHostStatsCPU(const void *data)
+{
+    const struct nodeCPUStatsData *testData = data;
+    g_autofree char *cpustatfile = NULL;
+    g_autoptr(FILE) cpustat = NULL;
+    g_autoptr(virHostStats) stats = g_new0(virHostStats, 1);
+    virNodeCPUStats params[4];
+    int nparams = G_N_ELEMENTS(params);
+    unsigned long long tick_nsec = 1000ull * 1000ull * 1000ull /
+                                   sysconf(_SC_CLK_TCK);
+    size_t i;
+
+    cpustatfile = g_strdup_printf("%s/virhostcpudata/linux-cpustat-%s.stat",
+                                  abs_srcdir, testData->name);
+
+    if (!(cpustat = fopen(cpustatfile, "r"))) {
+        virReportSystemError(errno, "failed to open '%s': ", cpustatfile);
+        return -1;
+    }
+
+    if (virHostStatsParseCPU(cpustat, tick_nsec, stats) < 0)
+        return -1;
+
+    if (stats->ncpus != testData->ncpus) {
+        VIR_TEST_DEBUG("expected %d CPUs, got %zu",
+                       testData->ncpus, stats->ncpus);
+        return -1;
+    }
+
+    rewind(cpustat);
+    if (virHostCPUGetStatsLinux(cpustat, VIR_NODE_CPU_STATS_ALL_CPUS,
+                                params, &nparams) < 0 ||
+        linuxTestHostStatsCPUCompare(&stats->cpu, params) < 0)
+        return -1;
+
+    for (i = 0; i < stats->ncpus; i++) {
+        if (stats->cpus[i].id != i) {
+            VIR_TEST_DEBUG("expected CPU id %zu, got %d",
+                           i, stats->cpus[i].id);
+            return -1;
+        }
+
+        rewind(cpustat);
+        if (virHostCPUGetStatsLinux(cpustat, i, params, &nparams) < 0 ||
+            linuxTestHostStatsCPUCompare(&stats->cpus[i], params) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
 static int
 mymain(void)
 {
@@ -295,6 +373,7 @@ mymain(void)
         {"with-frequency", VIR_ARCH_S390X},
         {"with-die", VIR_ARCH_X86_64},
     };
+    const struct nodeCPUStatsData statsData = { "24cpu", 24, false };
 
     if (virInitialize() < 0)
         return EXIT_FAILURE;
@@ -320,6 +399,10 @@ mymain(void)
     DO_TEST_CPU_STATS("24cpu", 24, false);
     DO_TEST_CPU_STATS("24cpu", 25, true);
 
+    if (virTestRun("CPU stats snapshot 24cpu", linuxTestHostStatsCPU,
+                   &statsData) < 0)
+        ret = -1;
+
     return ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
@@ -0,0 +1,85 @@
+/*
+ * virkvmstatstest.c: test reading the KVM statistics from debugfs
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include "testutils.h"
+#include "virbuffer.h"
+#define LIBVIRT_VIRKVMSTATSPRIV_H_ALLOW
+#include "virkvmstatspriv.h"
+
+#define VIR_FROM_THIS VIR_FROM_NONE
+
+
+static int
+testKVMStatsValueCompare(const void *a,
+                         const void *b)
+{
+    const virKVMStatsValue *va = a;
+    const virKVMStatsValue *vb = b;
+
+    return strcmp(va->name, vb->name);
+}
+
+
+static int
+testKVMStatsDebugfs(const void *opaque)
+{
+    const char *name = opaque;
+    g_autofree char *debugfs = NULL;
+    g_autofree char *expected = NULL;
+    g_autofree char *actual = NULL;
+    g_autofree virKVMStatsValuePtr values = NULL;
+    g_autoptr(virKVMStats) stats = NULL;
+    g_auto(virBuffer) buf = VIR_BUFFER_INITIALIZER;
+    size_t nvalues = 0;
+    size_t i;
+
+    debugfs = g_strdup_printf("%s/virkvmstatsdata/%s", abs_srcdir, name);
+    expected = g_strdup_printf("%s/virkvmstatsdata/%s.txt", abs_srcdir, name);
+
+    if (!(stats = virKVMStatsNewDebugfs(debugfs)))
+        return -1;
+
+    if (virKVMStatsReadVM(stats, &values, &nvalues) < 0)
+        return -1;
+
+    /* The order of the directory entries is up to the filesystem */
+    qsort(values, nvalues, sizeof(*values), testKVMStatsValueCompare);
+
+    for (i = 0; i < nvalues; i++)
+        virBufferAsprintf(&buf, "%s=%llu\n", values[i].name, values[i].value);
+
+    actual = virBufferContentAndReset(&buf);
+
+    return virTestCompareToFile(actual, expected);
+}
+
+
+static int
+mymain(void)
+{
+    int ret = 0;
+
+    if (virTestRun("debugfs", testKVMStatsDebugfs, "debugfs") < 0)
+        ret = -1;
+
+    return ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+VIR_TEST_MAIN(mymain)
@@ -0,0 +1,276 @@
+/*
+ * virperftest.c: test the per vCPU perf event helpers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include "testutils.h"
+#include "virerror.h"
+#define LIBVIRT_VIRPERFPRIV_H_ALLOW
+#include "virperfpriv.h"
+
+#define VIR_FROM_THIS VIR_FROM_NONE
+
+#define BIT(type) (1ULL << VIR_PERF_EVENT_ ## type)
+
+#define HW_ALL \
+    (BIT(CPU_CYCLES) | BIT(INSTRUCTIONS) | \
+     BIT(CACHE_REFERENCES) | BIT(CACHE_MISSES) | \
+     BIT(BRANCH_INSTRUCTIONS) | BIT(BRANCH_MISSES) | \
+     BIT(BUS_CYCLES) | BIT(STALLED_CYCLES_FRONTEND) | \
+     BIT(STALLED_CYCLES_BACKEND) | BIT(REF_CPU_CYCLES))
+
+#define SW_ALL \
+    (BIT(CPU_CLOCK) | BIT(TASK_CLOCK) | BIT(PAGE_FAULTS) | \
+     BIT(CONTEXT_SWITCHES) | BIT(CPU_MIGRATIONS) | \
+     BIT(PAGE_FAULTS_MIN) | BIT(PAGE_FAULTS_MAJ) | \
+     BIT(ALIGNMENT_FAULTS) | BIT(EMULATION_FAULTS))
+
+typedef struct _testSplitData testSplitData;
+struct _testSplitData {
+    unsigned long long mask;
+    const unsigned long long *groups;
+    size_t ngroups;
+};
+
+
+static int
+testSplit(const void *opaque)
+{
+    const testSplitData *data = opaque;
+    unsigned long long groups[VIR_PERF_EVENT_LAST] = { 0 };
+    size_t ngroups;
+    size_t i;
+
+    ngroups = virPerfVcpuGroupsSplit(data->mask, groups);
+
+    if (ngroups != data->ngroups) {
+        VIR_TEST_VERBOSE("expected %zu groups, got %zu",
+                         data->ngroups, ngroups);
+        return -1;
+    }
+
+    for (i = 0; i < ngroups; i++) {
+        if (groups[i] != data->groups[i]) {
+            VIR_TEST_VERBOSE("group %zu: expected 0x%llx, got 0x%llx",
+                             i, data->groups[i], groups[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+static const unsigned long long groupsAll[] = {
+    BIT(CPU_CYCLES) | BIT(INSTRUCTIONS) |
+    BIT(CACHE_REFERENCES) | BIT(CACHE_MISSES),
+    BIT(BRANCH_INSTRUCTIONS) | BIT(BRANCH_MISSES) |
+    BIT(BUS_CYCLES) | BIT(STALLED_CYCLES_FRONTEND),
+    BIT(STALLED_CYCLES_BACKEND) | BIT(REF_CPU_CYCLES),
+    SW_ALL,
+};
+
+static const unsigned long long groupsSparse[] = {
+    BIT(CPU_CYCLES) | BIT(INSTRUCTIONS) |
+    BIT(CACHE_MISSES) | BIT(BRANCH_MISSES),
+    BIT(REF_CPU_CYCLES),
+    BIT(CONTEXT_SWITCHES),
+};
+
+static const unsigned long long groupsSoftware[] = {
+    BIT(TASK_CLOCK) | BIT(PAGE_FAULTS),
+};
+
+
+static int
+testParse(const void *opaque G_GNUC_UNUSED)
+{
+    const virPerfEventType types[] = {
+        VIR_PERF_EVENT_CPU_CYCLES, VIR_PERF_EVENT_INSTRUCTIONS,
+    };
+    /* counted all the time */
+    const uint64_t full[] = { 2, 1000, 1000, 500, 800 };
+    /* on the PMU for a quarter of the time */
+    const uint64_t scaled[] = { 2, 4000, 1000, 500, 800 };
+    /* never scheduled onto the PMU */
+    const uint64_t idle[] = { 2, 4000, 0, 500, 800 };
+    /* a different number of events than opened */
+    const uint64_t mismatch[] = { 3, 1000, 1000, 500, 800, 900 };
+    virPerfVcpuSample sample;
+    unsigned long long enabled;
+    unsigned long long running;
+
+    memset(&sample, 0, sizeof(sample));
+    if (virPerfVcpuGroupParse(full, G_N_ELEMENTS(full), types, 2,
+                              &sample, &enabled, &running) < 0)
+        return -1;
+
+    if (enabled != 1000 || running != 1000 ||
+        !sample.present[VIR_PERF_EVENT_CPU_CYCLES] ||
+        !sample.present[VIR_PERF_EVENT_INSTRUCTIONS] ||
+        sample.present[VIR_PERF_EVENT_CACHE_MISSES] ||
+        sample.values[VIR_PERF_EVENT_CPU_CYCLES] != 500 ||
+        sample.values[VIR_PERF_EVENT_INSTRUCTIONS] != 800) {
+        VIR_TEST_VERBOSE("unexpected values of a fully counted group");
+        return -1;
+    }
+
+    memset(&sample, 0, sizeof(sample));
+    if (virPerfVcpuGroupParse(scaled, G_N_ELEMENTS(scaled), types, 2,
+                              &sample, &enabled, &running) < 0)
+        return -1;
+
+    if (enabled != 4000 || running != 1000 ||
+        sample.values[VIR_PERF_EVENT_CPU_CYCLES] != 2000 ||
+        sample.values[VIR_PERF_EVENT_INSTRUCTIONS] != 3200) {
+        VIR_TEST_VERBOSE("unexpected values of a multiplexed group");
+        return -1;
+    }
+
+    memset(&sample, 0, sizeof(sample));
+    if (virPerfVcpuGroupParse(idle, G_N_ELEMENTS(idle), types, 2,
+                              &sample, &enabled, &running) < 0)
+        return -1;
+
+    if (!sample.present[VIR_PERF_EVENT_CPU_CYCLES] ||
+        sample.values[VIR_PERF_EVENT_CPU_CYCLES] != 0 ||
+        sample.values[VIR_PERF_EVENT_INSTRUCTIONS] != 0) {
+        VIR_TEST_VERBOSE("unexpected values of a group that never ran");
+        return -1;
+    }
+
+    if (virPerfVcpuGroupParse(mismatch, G_N_ELEMENTS(mismatch), types, 2,
+                              &sample, &enabled, &running) == 0) {
+        VIR_TEST_VERBOSE("group with a wrong number of events accepted");
+        return -1;
+    }
+    virResetLastError();
+
+    if (virPerfVcpuGroupParse(full, 4, types, 2,
+                              &sample, &enabled, &running) == 0) {
+        VIR_TEST_VERBOSE("short read accepted");
+        return -1;
+    }
+    virResetLastError();
+
+    return 0;
+}
+
+
+static void
+testSampleSet(virPerfVcpuSamplePtr sample,
+              virPerfEventType type,
+              uint64_t value)
+{
+    sample->present[type] = true;
+    sample->values[type] = value;
+}
+
+
+static int
+testRates(const void *opaque G_GNUC_UNUSED)
+{
+    virPerfVcpuSample prev;
+    virPerfVcpuSample cur;
+    virPerfVcpuRates rates;
+
+    memset(&prev, 0, sizeof(prev));
+    memset(&cur, 0, sizeof(cur));
+
+    prev.timestamp = 1000000;
+    testSampleSet(&prev, VIR_PERF_EVENT_CPU_CYCLES, 1000);
+    testSampleSet(&prev, VIR_PERF_EVENT_INSTRUCTIONS, 1000);
+    testSampleSet(&prev, VIR_PERF_EVENT_CACHE_REFERENCES, 100);
+    testSampleSet(&prev, VIR_PERF_EVENT_CACHE_MISSES, 10);
+
+    /* half a second later */
+    cur.timestamp = 1500000;
+    testSampleSet(&cur, VIR_PERF_EVENT_CPU_CYCLES, 5000);
+    testSampleSet(&cur, VIR_PERF_EVENT_INSTRUCTIONS, 7000);
+    testSampleSet(&cur, VIR_PERF_EVENT_CACHE_REFERENCES, 500);
+    testSampleSet(&cur, VIR_PERF_EVENT_CACHE_MISSES, 110);
+
+    virPerfVcpuComputeRates(&cur, &prev, &rates);
+
+    if (!rates.hasIpc || rates.ipc != 1.5 ||
+        !rates.hasCacheMissesRate || rates.cacheMissesRate != 200 ||
+        !rates.hasCacheMissRatio || rates.cacheMissRatio != 0.25) {
+        VIR_TEST_VERBOSE("unexpected rates: ipc=%g misses/s=%g ratio=%g",
+                         rates.ipc, rates.cacheMissesRate,
+                         rates.cacheMissRatio);
+        return -1;
+    }
+
+    /* no cycles counted, no cache references counted before */
+    cur.values[VIR_PERF_EVENT_CPU_CYCLES] = 1000;
+    prev.present[VIR_PERF_EVENT_CACHE_REFERENCES] = false;
+
+    virPerfVcpuComputeRates(&cur, &prev, &rates);
+
+    if (rates.hasIpc || rates.hasCacheMissRatio ||
+        !rates.hasCacheMissesRate) {
+        VIR_TEST_VERBOSE("rates computed without the events they need");
+        return -1;
+    }
+
+    /* a scaled estimate lower than before and no time passed */
+    cur.values[VIR_PERF_EVENT_CPU_CYCLES] = 900;
+    cur.timestamp = prev.timestamp;
+
+    virPerfVcpuComputeRates(&cur, &prev, &rates);
+
+    if (rates.hasIpc || rates.hasCacheMissesRate) {
+        VIR_TEST_VERBOSE("rates computed from counters going backwards");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+mymain(void)
+{
+    int ret = 0;
+
+#define DO_TEST_SPLIT(name, msk, grps) \
+    do { \
+        testSplitData data = { msk, grps, G_N_ELEMENTS(grps) }; \
+        if (virTestRun("split " name, testSplit, &data) < 0) \
+            ret = -1; \
+    } while (0)
+
+    DO_TEST_SPLIT("all", HW_ALL | SW_ALL, groupsAll);
+    DO_TEST_SPLIT("sparse",
+                  BIT(CPU_CYCLES) | BIT(INSTRUCTIONS) | BIT(CACHE_MISSES) |
+                  BIT(BRANCH_MISSES) | BIT(REF_CPU_CYCLES) |
+                  BIT(CONTEXT_SWITCHES),
+                  groupsSparse);
+    DO_TEST_SPLIT("software", BIT(TASK_CLOCK) | BIT(PAGE_FAULTS),
+                  groupsSoftware);
+
+    if (virTestRun("parse group", testParse, NULL) < 0)
+        ret = -1;
+
+    if (virTestRun("rates", testRates, NULL) < 0)
+        ret = -1;
+
+    return ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+VIR_TEST_MAIN(mymain)
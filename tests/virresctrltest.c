@@ -75,6 +75,122 @@ test_virResctrlGetUnused(const void *opaque)
 }
 
 
+#define GRAN (768 * 1024ULL)
+
+static int
+test_virResctrlAllocResize(const void *opaque G_GNUC_UNUSED)
+{
+    g_autofree char *system_dir = NULL;
+    g_autofree char *resctrl_dir = NULL;
+    g_autoptr(virResctrlAlloc) alloc = NULL;
+    g_autoptr(virCaps) caps = NULL;
+    struct {
+        unsigned int cache;
+        unsigned long long size;
+        bool fail;
+        const char *schemata;
+    } steps[] = {
+        /* Fresh allocation takes the smallest free region */
+        { 0, 2 * GRAN, false, "L3:0=00003\n" },
+        /* Grows in place */
+        { 0, 6 * GRAN, false, "L3:0=0003f\n" },
+        /* Only 8 bits are free on cache 0 */
+        { 0, 10 * GRAN, true, "L3:0=0003f\n" },
+        { 0, 4 * GRAN, false, "L3:0=0000f\n" },
+        { 1, 4 * GRAN, false, "L3:0=0000f;1=000f0\n" },
+        /* Not divisible by granularity */
+        { 1, GRAN + 1, true, "L3:0=0000f;1=000f0\n" },
+    };
+    size_t i;
+    int ret = -1;
+
+    system_dir = g_strdup_printf("%s/vircaps2xmldata/linux-resctrl/system",
+                                 abs_srcdir);
+    resctrl_dir = g_strdup_printf("%s/vircaps2xmldata/linux-resctrl/resctrl",
+                                  abs_srcdir);
+
+    virFileWrapperAddPrefix("/sys/devices/system", system_dir);
+    virFileWrapperAddPrefix("/sys/fs/resctrl", resctrl_dir);
+
+    caps = virCapabilitiesNew(VIR_ARCH_X86_64, false, false);
+    if (!caps || virCapabilitiesInitCaches(caps) < 0) {
+        fprintf(stderr, "Could not initialize capabilities");
+        goto cleanup;
+    }
+
+    if (!(alloc = virResctrlAllocNew()) ||
+        virResctrlAllocSetCacheSize(alloc, 3, VIR_CACHE_TYPE_BOTH, 0, GRAN) < 0 ||
+        virResctrlAllocSetCacheSize(alloc, 3, VIR_CACHE_TYPE_BOTH, 1, GRAN) < 0)
+        goto cleanup;
+
+    for (i = 0; i < G_N_ELEMENTS(steps); i++) {
+        g_autofree char *schemata = NULL;
+        int rc = virResctrlAllocResizeCacheMask(caps->host.resctrl, alloc, 3,
+                                                VIR_CACHE_TYPE_BOTH,
+                                                steps[i].cache, steps[i].size);
+
+        if ((rc < 0) != steps[i].fail) {
+            VIR_TEST_DEBUG("step %zu: expected %s", i,
+                           steps[i].fail ? "failure" : "success");
+            goto cleanup;
+        }
+
+        if (!(schemata = virResctrlAllocFormat(alloc)))
+            goto cleanup;
+
+        if (STRNEQ(schemata, steps[i].schemata)) {
+            VIR_TEST_DEBUG("step %zu:", i);
+            virTestDifference(stderr, steps[i].schemata, schemata);
+            goto cleanup;
+        }
+    }
+
+    ret = 0;
+ cleanup:
+    virFileWrapperClearPrefixes();
+    return ret;
+}
+
+#undef GRAN
+
+
+struct virResctrlTuneData {
+    bool membw;
+    unsigned long long avail;
+    unsigned long long step;
+    virResctrlTuneEntry entries[3];
+    size_t nentries;
+    unsigned long long targets[3];
+};
+
+
+static int
+test_virResctrlTune(const void *opaque)
+{
+    const struct virResctrlTuneData *data = opaque;
+    virResctrlTuneEntry entries[3];
+    size_t i;
+
+    memcpy(entries, data->entries, sizeof(entries));
+
+    if (data->membw)
+        virResctrlTuneMemoryBandwidth(entries, data->nentries,
+                                      data->avail, data->step);
+    else
+        virResctrlTuneCache(entries, data->nentries, data->avail, data->step);
+
+    for (i = 0; i < data->nentries; i++) {
+        if (entries[i].target != data->targets[i]) {
+            VIR_TEST_DEBUG("entry %zu: expected %llu, got %llu",
+                           i, data->targets[i], entries[i].target);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
 static int
 mymain(void)
 {
@@ -93,6 +209,48 @@ mymain(void)
     DO_TEST_UNUSED("resctrl-skx");
     DO_TEST_UNUSED("resctrl-skx-twocaches");
 
+    if (virTestRun("Resize", test_virResctrlAllocResize, NULL) < 0)
+        ret = -1;
+
+#define DO_TEST_TUNE(_name, _membw, _avail, _step, ...) \
+    do { \
+        struct virResctrlTuneData tune = { \
+            .membw = _membw, .avail = _avail, .step = _step, __VA_ARGS__ \
+        }; \
+        if (virTestRun("Tune: " _name, test_virResctrlTune, &tune) < 0) \
+            ret = -1; \
+    } while (0)
+
+    /* The idle allocation gives a step to the starved one */
+    DO_TEST_TUNE("cache-idle", false, 0, 1,
+                 .entries = { { 10, 10, 2, 20, 0 }, { 2, 10, 2, 20, 0 } },
+                 .nentries = 2, .targets = { 11, 9 });
+    /* Free cache is handed out first come first served */
+    DO_TEST_TUNE("cache-free", false, 1, 1,
+                 .entries = { { 10, 10, 2, 20, 0 }, { 10, 10, 2, 20, 0 } },
+                 .nentries = 2, .targets = { 11, 10 });
+    /* Contending allocations converge to equal shares */
+    DO_TEST_TUNE("cache-contention", false, 0, 1,
+                 .entries = { { 6, 6, 2, 12, 0 }, { 10, 10, 2, 12, 0 } },
+                 .nentries = 2, .targets = { 7, 9 });
+    /* Bounds are kept */
+    DO_TEST_TUNE("cache-bounds", false, 4, 1,
+                 .entries = { { 12, 12, 2, 12, 0 }, { 1, 3, 3, 12, 0 },
+                              { 20, 20, 2, 16, 0 } },
+                 .nentries = 3, .targets = { 12, 3, 16 });
+    /* The noisy neighbour gets throttled on a saturated controller */
+    DO_TEST_TUNE("membw-saturated", true, 100, 10,
+                 .entries = { { 80, 100, 20, 100, 0 }, { 15, 100, 20, 100, 0 } },
+                 .nentries = 2, .targets = { 90, 100 });
+    /* Nobody is throttled below the minimum */
+    DO_TEST_TUNE("membw-min", true, 100, 10,
+                 .entries = { { 80, 20, 20, 100, 0 }, { 15, 100, 20, 100, 0 } },
+                 .nentries = 2, .targets = { 20, 100 });
+    /* Throttling is lifted once the controller is idle */
+    DO_TEST_TUNE("membw-idle", true, 100, 10,
+                 .entries = { { 20, 50, 20, 100, 0 }, { 10, 100, 20, 100, 0 } },
+                 .nentries = 2, .targets = { 60, 100 });
+
     return ret;
 }
 
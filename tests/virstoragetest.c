@@ -19,6 +19,8 @@
 #include <config.h>
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/time.h>
 
 #include "testutils.h"
 #include "vircommand.h"
@@ -28,6 +30,9 @@
 #include "virstoragefile.h"
 #include "virstring.h"
 
+#define LIBVIRT_VIRSTORAGEFILEPRIV_H_ALLOW
+#include "virstoragefilepriv.h"
+
 #include "storage/storage_driver.h"
 
 #define VIR_FROM_THIS VIR_FROM_NONE
@@ -624,6 +629,194 @@ testBackingParse(const void *args)
 }
 
 
+struct testQcow2CreateData {
+    const char *name;
+    unsigned long long capacity;
+    const char *backing;
+    int backingFormat;
+    bool v3;
+    unsigned long long grow;
+    int growRet;
+    const char *snapshot; /* internal snapshot created before growing */
+};
+
+static int
+testQcow2Create(const void *args)
+{
+    const struct testQcow2CreateData *data = args;
+    g_autofree char *path = g_strdup_printf("%s/%s", datadir, data->name);
+    unsigned long long capacity = data->capacity;
+    g_autoptr(virCommand) cmd = NULL;
+    g_autoptr(virStorageSource) meta = NULL;
+    VIR_AUTOCLOSE fd = -1;
+    int rc;
+
+    if ((fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0) {
+        fprintf(stderr, "unable to create %s\n", path);
+        return -1;
+    }
+
+    if (virStorageFileQcow2Create(fd, path, data->capacity,
+                                  data->backing, data->backingFormat,
+                                  data->v3, data->v3) < 0)
+        return -1;
+
+    if (data->snapshot) {
+        virCommandFree(cmd);
+        cmd = virCommandNewArgList(qemuimg, "snapshot", "-c", data->snapshot,
+                                   path, NULL);
+        if (virCommandRun(cmd, NULL) < 0)
+            return -1;
+    }
+
+    if (data->grow) {
+        if ((rc = virStorageFileQcow2Grow(fd, path, data->grow)) != data->growRet) {
+            fprintf(stderr, "expected grow to return %d, got %d\n",
+                    data->growRet, rc);
+            return -1;
+        }
+
+        if (rc == 0)
+            capacity = data->grow;
+    }
+
+    /* qemu-img must consider the image consistent */
+    virCommandFree(cmd);
+    cmd = virCommandNewArgList(qemuimg, "check", "-f", "qcow2", path, NULL);
+    if (virCommandRun(cmd, NULL) < 0)
+        return -1;
+
+    if (!(meta = virStorageFileGetMetadataFromFD(path, fd,
+                                                 VIR_STORAGE_FILE_QCOW2)))
+        return -1;
+
+    if (meta->capacity != capacity) {
+        fprintf(stderr, "expected capacity %llu, got %llu\n",
+                capacity, meta->capacity);
+        return -1;
+    }
+
+    if (STRNEQ_NULLABLE(meta->backingStoreRaw, data->backing)) {
+        fprintf(stderr, "expected backing store '%s', got '%s'\n",
+                NULLSTR(data->backing), NULLSTR(meta->backingStoreRaw));
+        return -1;
+    }
+
+    if (data->backing && meta->backingStoreRawFormat != data->backingFormat) {
+        fprintf(stderr, "expected backing format %d, got %d\n",
+                data->backingFormat, meta->backingStoreRawFormat);
+        return -1;
+    }
+
+    if (data->v3 && !meta->features) {
+        fprintf(stderr, "expected lazy_refcounts to be enabled\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+testStorageHeaderCacheCheck(const char *path,
+                            const char *expBacking,
+                            bool expCached)
+{
+    g_autoptr(virStorageSource) src = NULL;
+
+    if (!(src = testStorageFileGetMetadata(path, VIR_STORAGE_FILE_QCOW2,
+                                           -1, -1)))
+        return -1;
+
+    if (STRNEQ_NULLABLE(src->backingStoreRaw, expBacking)) {
+        fprintf(stderr, "backing store '%s', expected '%s'\n",
+                NULLSTR(src->backingStoreRaw), expBacking);
+        return -1;
+    }
+
+    if (virStorageFileHeaderCacheContains(path) != expCached) {
+        fprintf(stderr, "header of '%s' is %s cached\n",
+                path, expCached ? "not" : "still");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static int
+testStorageHeaderCacheRebase(const char *path,
+                             const char *backing)
+{
+    g_autoptr(virCommand) cmd = NULL;
+
+    cmd = virCommandNewArgList(qemuimg, "rebase", "-u", "-f", "qcow2",
+                               "-F", "raw", "-b", backing, path, NULL);
+    return virCommandRun(cmd, NULL);
+}
+
+
+static int
+testStorageHeaderCache(const void *args G_GNUC_UNUSED)
+{
+    g_autofree char *path = g_strdup_printf("%s/cached", datadir);
+    g_autoptr(virCommand) cmd = NULL;
+    unsigned int settle = virStorageFileHeaderCacheSetSettle(0);
+    struct timeval tv[2] = { { 0 } };
+    struct stat st;
+    int ret = -1;
+
+    cmd = virCommandNewArgList(qemuimg, "create", "-f", "qcow2",
+                               "-obacking_file=raw,backing_fmt=raw",
+                               path, NULL);
+    if (virCommandRun(cmd, NULL) < 0)
+        goto cleanup;
+
+    if (testStorageHeaderCacheCheck(path, "raw", true) < 0)
+        goto cleanup;
+
+    /* A change of the image is noticed from its timestamps */
+    if (stat(path, &st) < 0 ||
+        testStorageHeaderCacheRebase(path, absraw) < 0)
+        goto cleanup;
+
+    tv[0].tv_sec = tv[1].tv_sec = st.st_mtime + 10;
+    if (utimes(path, tv) < 0)
+        goto cleanup;
+
+    if (testStorageHeaderCacheCheck(path, absraw, true) < 0)
+        goto cleanup;
+
+    /* Changes done by libvirt itself are invalidated explicitly */
+    if (testStorageHeaderCacheRebase(path, "raw") < 0)
+        goto cleanup;
+
+    virStorageFileMetadataCacheInvalidate(path);
+
+    if (virStorageFileHeaderCacheContains(path)) {
+        fprintf(stderr, "header of '%s' not invalidated\n", path);
+        goto cleanup;
+    }
+
+    if (testStorageHeaderCacheCheck(path, "raw", true) < 0)
+        goto cleanup;
+
+    virStorageFileMetadataCacheClear();
+
+    if (virStorageFileHeaderCacheContains(path)) {
+        fprintf(stderr, "header of '%s' not cleared\n", path);
+        goto cleanup;
+    }
+
+    ret = 0;
+
+ cleanup:
+    virStorageFileHeaderCacheSetSettle(settle);
+    unlink(path);
+    return ret;
+}
+
+
 static int
 mymain(void)
 {
@@ -1205,6 +1398,36 @@ mymain(void)
     TEST_RELATIVE_BACKING(22, backingchain[11], backingchain[11], "../blah/image4");
 
 
+#define TEST_QCOW2_CREATE_FULL(id, cap, bck, bckfmt, v3, grow, growret, snap) \
+    do { \
+        struct testQcow2CreateData data6 = { \
+            "create" #id, cap, bck, bckfmt, v3, grow, growret, snap, \
+        }; \
+        if (virTestRun("Qcow2 create " #id, \
+                       testQcow2Create, &data6) < 0) \
+            ret = -1; \
+    } while (0)
+
+#define TEST_QCOW2_CREATE(id, cap, bck, bckfmt, v3, grow, growret) \
+    TEST_QCOW2_CREATE_FULL(id, cap, bck, bckfmt, v3, grow, growret, NULL)
+
+    TEST_QCOW2_CREATE(1, 1024 * 1024, NULL, 0, false, 0, 0);
+    TEST_QCOW2_CREATE(2, 1024 * 1024, "raw", VIR_STORAGE_FILE_RAW, false, 0, 0);
+    TEST_QCOW2_CREATE(3, 10ULL * 1024 * 1024 * 1024, absqcow2,
+                      VIR_STORAGE_FILE_QCOW2, true, 0, 0);
+    TEST_QCOW2_CREATE(4, 1024 * 1024, "raw", VIR_STORAGE_FILE_RAW, true,
+                      1024 * 1024 * 1024, 0);
+    TEST_QCOW2_CREATE(5, 1024 * 1024, NULL, 0, false,
+                      16ULL * 1024 * 1024 * 1024, 0);
+    /* needs a bigger L1 table than fits into the one allocated */
+    TEST_QCOW2_CREATE(6, 1024 * 1024, NULL, 0, true,
+                      8ULL * 1024 * 1024 * 1024 * 1024, 1);
+    /* shrinking is left to qemu-img */
+    TEST_QCOW2_CREATE(7, 1024 * 1024, NULL, 0, false, 512, 1);
+    /* internal snapshots record the size of the image */
+    TEST_QCOW2_CREATE_FULL(8, 1024 * 1024, NULL, 0, true,
+                           1024 * 1024 * 1024, 1, "snap1");
+
     virTestCounterReset("Backing store parse ");
 
 #define TEST_BACKING_PARSE_FULL(bck, xml, rc) \
@@ -1691,6 +1914,10 @@ mymain(void)
 
 #endif /* WITH_YAJL */
 
+    if (virTestRun("Storage image header cache",
+                   testStorageHeaderCache, NULL) < 0)
+        ret = -1;
+
  cleanup:
     /* Final cleanup */
     testCleanupImages();
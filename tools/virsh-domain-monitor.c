@@ -2138,6 +2138,18 @@ static const vshCmdOptDef opts_domstats[] = {
      .type = VSH_OT_BOOL,
      .help = N_("report domain memory usage"),
     },
+    {.name = "cgroup",
+     .type = VSH_OT_BOOL,
+     .help = N_("report domain cgroup resource usage"),
+    },
+    {.name = "perf-vcpu",
+     .type = VSH_OT_BOOL,
+     .help = N_("report perf event statistics per vcpu"),
+    },
+    {.name = "kvm",
+     .type = VSH_OT_BOOL,
+     .help = N_("report KVM statistics per vcpu"),
+    },
     {.name = "list-active",
      .type = VSH_OT_BOOL,
      .help = N_("list only active domains"),
@@ -2257,6 +2269,15 @@ cmdDomstats(vshControl *ctl, const vshCmd *cmd)
     if (vshCommandOptBool(cmd, "memory"))
         stats |= VIR_DOMAIN_STATS_MEMORY;
 
+    if (vshCommandOptBool(cmd, "cgroup"))
+        stats |= VIR_DOMAIN_STATS_CGROUP;
+
+    if (vshCommandOptBool(cmd, "perf-vcpu"))
+        stats |= VIR_DOMAIN_STATS_PERF_VCPU;
+
+    if (vshCommandOptBool(cmd, "kvm"))
+        stats |= VIR_DOMAIN_STATS_KVM;
+
     if (vshCommandOptBool(cmd, "list-active"))
         flags |= VIR_CONNECT_GET_ALL_DOMAINS_STATS_ACTIVE;
 
@@ -6205,6 +6205,24 @@ virshDomainJobStatsToDomainJobInfo(virTypedParameterPtr params,
 }
 
 
+static const struct {
+    const char *field;
+    const char *label;
+} startPhases[] = {
+    { VIR_DOMAIN_JOB_START_TIME_INIT, N_("Start init:") },
+    { VIR_DOMAIN_JOB_START_TIME_PREPARE_DOMAIN, N_("Start prep domain:") },
+    { VIR_DOMAIN_JOB_START_TIME_PREPARE_HOST, N_("Start prep host:") },
+    { VIR_DOMAIN_JOB_START_TIME_COMMAND_LINE, N_("Start cmdline:") },
+    { VIR_DOMAIN_JOB_START_TIME_EXEC, N_("Start exec:") },
+    { VIR_DOMAIN_JOB_START_TIME_NAMESPACE, N_("Start namespace:") },
+    { VIR_DOMAIN_JOB_START_TIME_CGROUP, N_("Start cgroup:") },
+    { VIR_DOMAIN_JOB_START_TIME_LABEL, N_("Start labelling:") },
+    { VIR_DOMAIN_JOB_START_TIME_MONITOR, N_("Start monitor:") },
+    { VIR_DOMAIN_JOB_START_TIME_SETUP, N_("Start setup:") },
+    { VIR_DOMAIN_JOB_START_TIME_REFRESH, N_("Start refresh:") },
+    { VIR_DOMAIN_JOB_START_TIME_FINISH, N_("Start finish:") },
+};
+
 static bool
 cmdDomjobinfo(vshControl *ctl, const vshCmd *cmd)
 {
@@ -6499,6 +6517,16 @@ cmdDomjobinfo(vshControl *ctl, const vshCmd *cmd)
         vshPrint(ctl, "%-17s %-.3lf %s\n", _("Temporary disk space total:"), val, unit);
     }
 
+    for (i = 0; i < G_N_ELEMENTS(startPhases); i++) {
+        if ((rc = virTypedParamsGetULLong(params, nparams,
+                                          startPhases[i].field,
+                                          &value)) < 0) {
+            goto save_error;
+        } else if (rc) {
+            vshPrint(ctl, "%-17s %-12llu ms\n", _(startPhases[i].label), value);
+        }
+    }
+
     if ((rc = virTypedParamsGetString(params, nparams, VIR_DOMAIN_JOB_ERRMSG,
                                       &svalue)) < 0) {
         goto save_error;
@@ -9585,6 +9613,65 @@ cmdNumatune(vshControl * ctl, const vshCmd * cmd)
     goto cleanup;
 }
 
+/*
+ * "numamove" command
+ */
+static const vshCmdInfo info_numamove[] = {
+    {.name = "help",
+     .data = N_("Move a running domain to other host NUMA nodes")
+    },
+    {.name = "desc",
+     .data = N_("Restrict memory of a running domain to the given host NUMA "
+                "nodes, migrate its pages there and pin its threads to the "
+                "host CPUs of those nodes.")
+    },
+    {.name = NULL}
+};
+
+static const vshCmdOptDef opts_numamove[] = {
+    VIRSH_COMMON_OPT_DOMAIN_FULL(VIR_CONNECT_LIST_DOMAINS_ACTIVE),
+    {.name = "nodeset",
+     .type = VSH_OT_DATA,
+     .flags = VSH_OFLAG_REQ,
+     .help = N_("host NUMA nodes to move the domain to")
+    },
+    {.name = NULL}
+};
+
+static bool
+cmdNumaMove(vshControl *ctl, const vshCmd *cmd)
+{
+    virDomainPtr dom;
+    const char *nodeset = NULL;
+    virTypedParameterPtr params = NULL;
+    int nparams = 0;
+    size_t i;
+    bool ret = false;
+
+    if (!(dom = virshCommandOptDomain(ctl, cmd, NULL)))
+        return false;
+
+    if (vshCommandOptStringReq(ctl, cmd, "nodeset", &nodeset) < 0)
+        goto cleanup;
+
+    if (virDomainMoveNumaNodes(dom, nodeset, &params, &nparams, 0) < 0) {
+        vshError(ctl, _("Unable to move domain to NUMA nodes %s"), nodeset);
+        goto cleanup;
+    }
+
+    for (i = 0; i < nparams; i++) {
+        g_autofree char *str = vshGetTypedParamValue(ctl, &params[i]);
+        vshPrint(ctl, "%-15s: %s\n", params[i].field, str);
+    }
+
+    ret = true;
+
+ cleanup:
+    virTypedParamsFree(params, nparams);
+    virshDomainFree(dom);
+    return ret;
+}
+
 /*
  * "qemu-monitor-command" command
  */
@@ -10651,6 +10738,22 @@ static const vshCmdOptDef opts_migrate[] = {
      .type = VSH_OT_STRING,
      .help = N_("URI to use for disks migration (overrides --disks-port)")
     },
+    {.name = "disks-parallel",
+     .type = VSH_OT_INT,
+     .help = N_("maximum number of disks copied at the same time")
+    },
+    {.name = "disks-bandwidth",
+     .type = VSH_OT_INT,
+     .help = N_("bandwidth limit in MiB/s shared by all migrated disks")
+    },
+    {.name = "converge-deadline",
+     .type = VSH_OT_INT,
+     .help = N_("seconds within which migration should converge")
+    },
+    {.name = "converge-downtime",
+     .type = VSH_OT_INT,
+     .help = N_("maximum downtime in ms allowed to make migration converge")
+    },
     {.name = "comp-methods",
      .type = VSH_OT_STRING,
      .help = N_("comma separated list of compression methods to be used")
@@ -10938,6 +11041,42 @@ doMigrate(void *opaque)
             goto save_error;
     }
 
+    if ((rv = vshCommandOptInt(ctl, cmd, "disks-parallel", &intOpt)) < 0) {
+        goto out;
+    } else if (rv > 0) {
+        if (virTypedParamsAddInt(&params, &nparams, &maxparams,
+                                 VIR_MIGRATE_PARAM_DISKS_PARALLEL,
+                                 intOpt) < 0)
+            goto save_error;
+    }
+
+    if ((rv = vshCommandOptULongLong(ctl, cmd, "disks-bandwidth", &ullOpt)) < 0) {
+        goto out;
+    } else if (rv > 0) {
+        if (virTypedParamsAddULLong(&params, &nparams, &maxparams,
+                                    VIR_MIGRATE_PARAM_BANDWIDTH_DISKS,
+                                    ullOpt) < 0)
+            goto save_error;
+    }
+
+    if ((rv = vshCommandOptULongLong(ctl, cmd, "converge-deadline", &ullOpt)) < 0) {
+        goto out;
+    } else if (rv > 0) {
+        if (virTypedParamsAddULLong(&params, &nparams, &maxparams,
+                                    VIR_MIGRATE_PARAM_CONVERGE_DEADLINE,
+                                    ullOpt) < 0)
+            goto save_error;
+    }
+
+    if ((rv = vshCommandOptULongLong(ctl, cmd, "converge-downtime", &ullOpt)) < 0) {
+        goto out;
+    } else if (rv > 0) {
+        if (virTypedParamsAddULLong(&params, &nparams, &maxparams,
+                                    VIR_MIGRATE_PARAM_CONVERGE_DOWNTIME,
+                                    ullOpt) < 0)
+            goto save_error;
+    }
+
     if (vshCommandOptStringReq(ctl, cmd, "tls-destination", &opt) < 0)
         goto out;
     if (opt &&
@@ -13508,6 +13647,59 @@ virshEventMemoryFailurePrint(virConnectPtr conn G_GNUC_UNUSED,
 }
 
 
+VIR_ENUM_DECL(virshEventPressureResource);
+VIR_ENUM_IMPL(virshEventPressureResource,
+              VIR_DOMAIN_PRESSURE_RESOURCE_LAST,
+              N_("memory"),
+              N_("io"));
+
+static void
+virshEventPressurePrint(virConnectPtr conn G_GNUC_UNUSED,
+                        virDomainPtr dom,
+                        int resource,
+                        unsigned long long stall,
+                        unsigned long long window,
+                        void *opaque)
+{
+    g_auto(virBuffer) buf = VIR_BUFFER_INITIALIZER;
+
+    virBufferAsprintf(&buf, _("event 'pressure' for domain '%s': "
+                              "resource: %s stall: %llu us window: %llu us\n"),
+                      virDomainGetName(dom),
+                      UNKNOWNSTR(virshEventPressureResourceTypeToString(resource)),
+                      stall, window);
+
+    virshEventPrint(opaque, &buf);
+}
+
+
+VIR_ENUM_DECL(virshEventResctrlResource);
+VIR_ENUM_IMPL(virshEventResctrlResource,
+              VIR_DOMAIN_RESCTRL_RESOURCE_LAST,
+              N_("cache"),
+              N_("memory bandwidth"));
+
+static void
+virshEventResctrlTunePrint(virConnectPtr conn G_GNUC_UNUSED,
+                           virDomainPtr dom,
+                           int resource,
+                           const char *vcpus,
+                           unsigned int id,
+                           unsigned long long value,
+                           void *opaque)
+{
+    g_auto(virBuffer) buf = VIR_BUFFER_INITIALIZER;
+
+    virBufferAsprintf(&buf, _("event 'resctrl-tune' for domain '%s': "
+                              "resource: %s vcpus: %s id: %u value: %llu\n"),
+                      virDomainGetName(dom),
+                      UNKNOWNSTR(virshEventResctrlResourceTypeToString(resource)),
+                      vcpus, id, value);
+
+    virshEventPrint(opaque, &buf);
+}
+
+
 virshDomainEventCallback virshDomainEventCallbacks[] = {
     { "lifecycle",
       VIR_DOMAIN_EVENT_CALLBACK(virshEventLifecyclePrint), },
@@ -13559,6 +13751,10 @@ virshDomainEventCallback virshDomainEventCallbacks[] = {
       VIR_DOMAIN_EVENT_CALLBACK(virshEventBlockThresholdPrint), },
     { "memory-failure",
       VIR_DOMAIN_EVENT_CALLBACK(virshEventMemoryFailurePrint), },
+    { "pressure",
+      VIR_DOMAIN_EVENT_CALLBACK(virshEventPressurePrint), },
+    { "resctrl-tune",
+      VIR_DOMAIN_EVENT_CALLBACK(virshEventResctrlTunePrint), },
 };
 G_STATIC_ASSERT(VIR_DOMAIN_EVENT_ID_LAST == G_N_ELEMENTS(virshDomainEventCallbacks));
 
@@ -14833,6 +15029,12 @@ const vshCmdDef domManagementCmds[] = {
      .info = info_migrate_postcopy,
      .flags = 0
     },
+    {.name = "numamove",
+     .handler = cmdNumaMove,
+     .opts = opts_numamove,
+     .info = info_numamove,
+     .flags = 0
+    },
     {.name = "numatune",
      .handler = cmdNumatune,
      .opts = opts_numatune,
@@ -947,6 +947,43 @@ cmdNodeMemStats(vshControl *ctl, const vshCmd *cmd)
     return ret;
 }
 
+/*
+ * "nodestats" command
+ */
+static const vshCmdInfo info_nodestats[] = {
+    {.name = "help",
+     .data = N_("Prints CPU and memory stats of the node.")
+    },
+    {.name = "desc",
+     .data = N_("Returns CPU and memory stats of all host CPUs and NUMA "
+                "cells taken from a single sample.")
+    },
+    {.name = NULL}
+};
+
+static bool
+cmdNodeStats(vshControl *ctl, const vshCmd *cmd G_GNUC_UNUSED)
+{
+    virTypedParameterPtr params = NULL;
+    int nparams = 0;
+    size_t i;
+    virshControlPtr priv = ctl->privData;
+
+    if (virNodeGetAllStats(priv->conn, &params, &nparams, 0) < 0) {
+        vshError(ctl, "%s", _("Unable to get node stats"));
+        return false;
+    }
+
+    for (i = 0; i < nparams; i++) {
+        g_autofree char *value = vshGetTypedParamValue(ctl, params + i);
+
+        vshPrint(ctl, "%s=%s\n", params[i].field, value);
+    }
+
+    virTypedParamsFree(params, nparams);
+    return true;
+}
+
 /*
  * "nodesuspend" command
  */
@@ -1915,6 +1952,12 @@ const vshCmdDef hostAndHypervisorCmds[] = {
      .info = info_nodememstats,
      .flags = 0
     },
+    {.name = "nodestats",
+     .handler = cmdNodeStats,
+     .opts = NULL,
+     .info = info_nodestats,
+     .flags = 0
+    },
     {.name = "nodesuspend",
      .handler = cmdNodeSuspend,
      .opts = opts_node_suspend,